@@ -0,0 +1,113 @@
+/** Exchange of samples with node-types in Go without serialization
+ *
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+package main
+
+// #include <villas/nodes/go.h>
+import "C"
+
+import (
+	"runtime/cgo"
+	"unsafe"
+
+	"git.rwth-aachen.de/acs/public/villas/node/go/pkg"
+	"git.rwth-aachen.de/acs/public/villas/node/go/pkg/errors"
+	"git.rwth-aachen.de/acs/public/villas/node/go/pkg/nodes"
+)
+
+func sampleData(cs *C._go_sample) []float64 {
+	if cs.capacity == 0 {
+		return nil
+	}
+
+	return unsafe.Slice((*float64)(unsafe.Pointer(cs.data)), int(cs.capacity))
+}
+
+// sampleViews creates Go samples whose data is backed by the memory of the C samples
+func sampleViews(cs []C._go_sample) []pkg.Sample {
+	smps := make([]pkg.Sample, len(cs))
+
+	for i := range cs {
+		c := &cs[i]
+
+		smps[i] = pkg.Sample{
+			Flags:    int(c.flags),
+			Sequence: uint64(c.sequence),
+			Timestamps: pkg.Timestamps{
+				Origin:   pkg.Timestamp{int64(c.ts_origin[0]), int64(c.ts_origin[1])},
+				Received: pkg.Timestamp{int64(c.ts_received[0]), int64(c.ts_received[1])},
+			},
+			Data: sampleData(c)[:c.length],
+		}
+	}
+
+	return smps
+}
+
+// sampleUpdate copies the header of a Go sample back to the C sample.
+// The values are only copied if the node-type replaced the Data slice.
+func sampleUpdate(c *C._go_sample, smp *pkg.Sample) {
+	data := sampleData(c)
+	length := len(smp.Data)
+
+	if length > 0 && (len(data) == 0 || &smp.Data[0] != &data[0]) {
+		length = copy(data, smp.Data)
+	}
+
+	c.sequence = C.uint64_t(smp.Sequence)
+	c.length = C.uint(length)
+	c.flags = C.int(smp.Flags)
+	c.ts_origin[0] = C.int64_t(smp.Timestamps.Origin[0])
+	c.ts_origin[1] = C.int64_t(smp.Timestamps.Origin[1])
+	c.ts_received[0] = C.int64_t(smp.Timestamps.Received[0])
+	c.ts_received[1] = C.int64_t(smp.Timestamps.Received[1])
+}
+
+//export GoNodeSupportsSamples
+func GoNodeSupportsSamples(p C.uintptr_t) C.int {
+	h := cgo.Handle(p)
+	if _, ok := h.Value().(nodes.SampleNode); ok {
+		return 1
+	}
+
+	return 0
+}
+
+//export GoNodeReadSamples
+func GoNodeReadSamples(p C.uintptr_t, csmps *C._go_sample, cnt C.int) (C.int, C.int) {
+	h := cgo.Handle(p)
+	n := h.Value().(nodes.SampleNode)
+
+	cs := unsafe.Slice(csmps, int(cnt))
+	smps := sampleViews(cs)
+
+	read, err := n.ReadSamples(smps)
+	if err != nil {
+		return -1, C.int(errors.ErrorToInt(err))
+	}
+
+	for i := 0; i < read; i++ {
+		sampleUpdate(&cs[i], &smps[i])
+	}
+
+	return C.int(read), 0
+}
+
+//export GoNodeWriteSamples
+func GoNodeWriteSamples(p C.uintptr_t, csmps *C._go_sample, cnt C.int) (C.int, C.int) {
+	h := cgo.Handle(p)
+	n := h.Value().(nodes.SampleNode)
+
+	smps := sampleViews(unsafe.Slice(csmps, int(cnt)))
+
+	written, err := n.WriteSamples(smps)
+	if err != nil {
+		return -1, C.int(errors.ErrorToInt(err))
+	}
+
+	return C.int(written), 0
+}
@@ -26,10 +26,18 @@ import (
 const (
 	MAX_SIGNALS   = 64
 	NUM_HUGEPAGES = 100
+
+	// Number of batches of samples which can be in use at once,
+	// e.g. because they are still queued by the node after Write() returned
+	POOL_BATCHES = 16
 )
 
 type Node struct {
 	inst *C.vnode
+
+	// The pool is sized once and lives as long as the node,
+	// as the node might keep references to samples after Write() returned
+	pool *C.vpool
 }
 
 func IsValidNodeNname(name string) bool {
@@ -42,7 +50,22 @@ func NewNode(cfg interface{}, sn_uuid uuid.UUID) (*Node, error) {
 	} else {
 		log.Printf("Config = %s\n", js)
 		n := C.node_new(C.CString(string(js)), C.CString(sn_uuid.String()))
-		return &Node{n}, nil
+
+		vectorize := C.node_input_vectorize(n)
+		if out := C.node_output_vectorize(n); out > vectorize {
+			vectorize = out
+		}
+		if vectorize == 0 {
+			vectorize = 1
+		}
+
+		p := C.pool_new(POOL_BATCHES*vectorize, MAX_SIGNALS)
+		if p == nil {
+			C.node_destroy(n)
+			return nil, fmt.Errorf("failed to create sample pool")
+		}
+
+		return &Node{inst: n, pool: p}, nil
 	}
 }
 
@@ -75,26 +98,82 @@ func (n *Node) Restart() error {
 }
 
 func (n *Node) Close() error {
-	return errors.IntToError(int(C.node_destroy(n.inst)))
+	// The node releases its references to our samples when destroyed
+	if err := errors.IntToError(int(C.node_destroy(n.inst))); err != nil {
+		return err
+	}
+
+	if n.pool != nil {
+		C.pool_delete(n.pool)
+		n.pool = nil
+	}
+
+	return nil
 }
 
 func (n *Node) Reverse() error {
 	return errors.IntToError(int(C.node_reverse(n.inst)))
 }
 
-func (n *Node) Read(cnt int) []Sample {
+// allocSamples allocates up to cnt samples from the pool of the node
+func (n *Node) allocSamples(cnt int) []*C.vsample {
 	csmps := make([]*C.vsample, cnt)
 
-	for i := 0; i < cnt; i++ {
-		csmps[i] = C.sample_alloc(MAX_SIGNALS)
+	alloced := int(C.sample_alloc_many(n.pool, (**C.vsample)(unsafe.Pointer(&csmps[0])), C.uint(cnt)))
+	if alloced < 0 {
+		alloced = 0
 	}
 
-	read := int(C.node_read(n.inst, (**C.vsample)(unsafe.Pointer(&csmps[0])), C.uint(cnt)))
+	return csmps[:alloced]
+}
+
+func (n *Node) Read(cnt int) []Sample {
+	if cnt <= 0 {
+		return nil
+	}
+
+	csmps := n.allocSamples(cnt)
+	if len(csmps) == 0 {
+		return nil
+	}
+
+	read := int(C.node_read(n.inst, (**C.vsample)(unsafe.Pointer(&csmps[0])), C.uint(len(csmps))))
+	if read <= 0 {
+		C.sample_decref_many((**C.vsample)(unsafe.Pointer(&csmps[0])), C.uint(len(csmps)))
+		return nil
+	}
+
+	// Unpack all samples with a single call into contiguous arrays
+	values := make([]float64, read*MAX_SIGNALS)
+	seqs := make([]uint64, read)
+	flags := make([]C.int, read)
+	lens := make([]C.uint, read)
+	tsOrigin := make([]C.struct_timespec, read)
+	tsReceived := make([]C.struct_timespec, read)
+
+	C.sample_unpack_many((**C.vsample)(unsafe.Pointer(&csmps[0])), C.uint(read),
+		(*C.uint64_t)(unsafe.Pointer(&seqs[0])),
+		&tsOrigin[0],
+		&tsReceived[0],
+		&flags[0],
+		&lens[0],
+		MAX_SIGNALS,
+		(*C.double)(unsafe.Pointer(&values[0])),
+	)
+
+	C.sample_decref_many((**C.vsample)(unsafe.Pointer(&csmps[0])), C.uint(len(csmps)))
 
 	smps := make([]Sample, read)
 	for i := 0; i < read; i++ {
-		smps[i].FromC(csmps[i])
-		C.sample_decref(csmps[i])
+		smps[i] = Sample{
+			Flags:    int(flags[i]),
+			Sequence: seqs[i],
+			Timestamps: pkg.Timestamps{
+				Origin:   pkg.Timestamp{int64(tsOrigin[i].tv_sec), int64(tsOrigin[i].tv_nsec)},
+				Received: pkg.Timestamp{int64(tsReceived[i].tv_sec), int64(tsReceived[i].tv_nsec)},
+			},
+			Data: values[i*MAX_SIGNALS : i*MAX_SIGNALS+int(lens[i]) : i*MAX_SIGNALS+int(lens[i])],
+		}
 	}
 
 	return smps
@@ -102,13 +181,61 @@ func (n *Node) Read(cnt int) []Sample {
 
 func (n *Node) Write(smps []Sample) int {
 	cnt := len(smps)
-	csmps := make([]*C.vsample, cnt)
+	if cnt == 0 {
+		return 0
+	}
 
-	for i := 0; i < cnt; i++ {
-		csmps[i] = smps[i].ToC()
+	csmps := n.allocSamples(cnt)
+	if len(csmps) == 0 {
+		return 0
+	}
+
+	cnt = len(csmps)
+
+	stride := 0
+	for _, smp := range smps[:cnt] {
+		if len(smp.Data) > stride {
+			stride = len(smp.Data)
+		}
 	}
 
-	return int(C.node_write(n.inst, (**C.vsample)(unsafe.Pointer(&csmps[0])), C.uint(cnt)))
+	// Pack all samples with a single call from contiguous arrays.
+	// Each sample keeps its own length, the rows are only padded to a common stride.
+	values := make([]float64, cnt*stride+1)
+	lens := make([]C.uint, cnt)
+	seqs := make([]uint64, cnt)
+	tsOrigin := make([]C.struct_timespec, cnt)
+	tsReceived := make([]C.struct_timespec, cnt)
+
+	for i, smp := range smps[:cnt] {
+		copy(values[i*stride:], smp.Data)
+
+		lens[i] = C.uint(len(smp.Data))
+		seqs[i] = smp.Sequence
+		tsOrigin[i] = C.struct_timespec{
+			tv_sec:  C.long(smp.Timestamps.Origin[0]),
+			tv_nsec: C.long(smp.Timestamps.Origin[1]),
+		}
+		tsReceived[i] = C.struct_timespec{
+			tv_sec:  C.long(smp.Timestamps.Received[0]),
+			tv_nsec: C.long(smp.Timestamps.Received[1]),
+		}
+	}
+
+	C.sample_pack_many((**C.vsample)(unsafe.Pointer(&csmps[0])), C.uint(cnt),
+		(*C.uint64_t)(unsafe.Pointer(&seqs[0])),
+		&tsOrigin[0],
+		&tsReceived[0],
+		&lens[0],
+		C.uint(stride),
+		(*C.double)(unsafe.Pointer(&values[0])),
+	)
+
+	written := int(C.node_write(n.inst, (**C.vsample)(unsafe.Pointer(&csmps[0])), C.uint(cnt)))
+
+	C.sample_decref_many((**C.vsample)(unsafe.Pointer(&csmps[0])), C.uint(cnt))
+
+	return written
 }
 
 func (n *Node) PollFDs() []int {
@@ -173,40 +300,3 @@ func init() {
 }
 
 type Sample pkg.Sample
-
-func (s *Sample) ToC() *C.vsample {
-	return C.sample_pack(
-		C.uint(s.Sequence),
-		&C.struct_timespec{
-			tv_sec:  C.long(s.Timestamps.Origin[0]),
-			tv_nsec: C.long(s.Timestamps.Origin[1]),
-		},
-		&C.struct_timespec{
-			tv_sec:  C.long(s.Timestamps.Received[0]),
-			tv_nsec: C.long(s.Timestamps.Received[1]),
-		},
-		C.uint(len(s.Data)),
-		(*C.double)(unsafe.Pointer(&s.Data[0])),
-	)
-}
-
-func (s *Sample) FromC(c *C.vsample) {
-	var tsOrigin C.struct_timespec
-	var tsReceived C.struct_timespec
-
-	len := C.sample_length(c)
-
-	s.Data = make([]float64, uint(len))
-
-	C.sample_unpack(c,
-		(*C.uint)(unsafe.Pointer(&s.Sequence)),
-		&tsOrigin,
-		&tsReceived,
-		(*C.int)(unsafe.Pointer(&s.Flags)),
-		&len,
-		(*C.double)(unsafe.Pointer(&s.Data[0])),
-	)
-
-	s.Timestamps.Origin = pkg.Timestamp{int64(tsOrigin.tv_sec), int64(tsOrigin.tv_nsec)}
-	s.Timestamps.Received = pkg.Timestamp{int64(tsReceived.tv_sec), int64(tsReceived.tv_nsec)}
-}
@@ -11,6 +11,7 @@ import (
 	"encoding/json"
 	"fmt"
 
+	"git.rwth-aachen.de/acs/public/villas/node/go/pkg"
 	"git.rwth-aachen.de/acs/public/villas/node/go/pkg/errors"
 	"git.rwth-aachen.de/acs/public/villas/node/go/pkg/nodes"
 )
@@ -19,6 +20,7 @@ type Node struct {
 	nodes.BaseNode
 
 	channel chan []byte
+	samples chan pkg.Sample
 
 	Config LoopbackConfig
 }
@@ -33,6 +35,7 @@ func NewNode() nodes.Node {
 	return &Node{
 		BaseNode: nodes.NewBaseNode(),
 		channel:  make(chan []byte, 1024),
+		samples:  make(chan pkg.Sample, 1024),
 	}
 }
 
@@ -68,6 +71,54 @@ func (n *Node) Write(data []byte) error {
 	return nil
 }
 
+func (n *Node) ReadSamples(smps []pkg.Sample) (int, error) {
+	read := 0
+
+	// Block until at least one sample is available
+	select {
+	case <-n.Stopped:
+		return 0, errors.ErrEndOfFile
+
+	case smp := <-n.samples:
+		copySample(&smps[read], &smp)
+		read++
+	}
+
+	for read < len(smps) {
+		select {
+		case smp := <-n.samples:
+			copySample(&smps[read], &smp)
+			read++
+
+		default:
+			return read, nil
+		}
+	}
+
+	return read, nil
+}
+
+func (n *Node) WriteSamples(smps []pkg.Sample) (int, error) {
+	for _, smp := range smps {
+		// The data of smps is owned by VILLASnode and must be copied
+		smp.Data = append([]float64(nil), smp.Data...)
+
+		n.samples <- smp
+	}
+
+	return len(smps), nil
+}
+
+// copySample copies src into the VILLASnode sample dst without replacing its Data slice
+func copySample(dst, src *pkg.Sample) {
+	length := copy(dst.Data[:cap(dst.Data)], src.Data)
+
+	dst.Flags = src.Flags
+	dst.Sequence = src.Sequence
+	dst.Timestamps = src.Timestamps
+	dst.Data = dst.Data[:length]
+}
+
 func (n *Node) PollFDs() ([]int, error) {
 	return []int{}, nil
 }
@@ -7,6 +7,10 @@
 
 package nodes
 
+import (
+	"git.rwth-aachen.de/acs/public/villas/node/go/pkg"
+)
+
 const (
 	NodeSupportsPoll    = (1 << iota)
 	NodeSupportsRead    = (1 << iota)
@@ -48,6 +52,24 @@ type Node interface {
 	SetLogger(l Logger)
 }
 
+// SampleNode can be implemented by node-types in addition to Node in order
+// to exchange samples directly with VILLASnode instead of serialized data.
+// If implemented, it is used instead of Read() and Write().
+//
+// The Data slices of the samples are backed by the memory of the VILLASnode samples.
+// They are only valid until the call returns and must not be retained.
+//
+// All values are exchanged as float64. Integer and boolean signals are converted
+// by VILLASnode. Complex signals are not supported.
+type SampleNode interface {
+	// ReadSamples fills smps with received samples and returns the number of filled samples.
+	// The Data slice of each sample is empty and has a capacity of the number of values which fit into the sample.
+	ReadSamples(smps []pkg.Sample) (int, error)
+
+	// WriteSamples sends smps and returns the number of sent samples.
+	WriteSamples(smps []pkg.Sample) (int, error)
+}
+
 type NodeConfig struct {
 	Type string `json:"type"`
 
@@ -13,6 +13,15 @@ import (
 	"time"
 )
 
+// Flags of a sample (see enum SampleFlags in include/villas/sample.hpp)
+const (
+	SampleHasTsOrigin   = (1 << iota)
+	SampleHasTsReceived = (1 << iota)
+	SampleHasOffset     = (1 << iota)
+	SampleHasSequence   = (1 << iota)
+	SampleHasData       = (1 << iota)
+)
+
 type Timestamp [2]int64
 
 func TimestampFromTime(t time.Time) Timestamp {
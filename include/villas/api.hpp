@@ -21,6 +21,8 @@
 #include <villas/common.hpp>
 #include <villas/queue_signalled.hpp>
 #include <villas/exceptions.hpp>
+#include <villas/api/response_cache.hpp>
+#include <villas/api/openmetrics.hpp>
 
 namespace villas {
 namespace node {
@@ -111,6 +113,9 @@ public:
 
 	std::list<api::Session *> sessions;		/**< List of currently active connections */
 	villas::QueueSignalled<api::Session *> pending;	/**< A queue of api_sessions which have pending requests. */
+
+	api::ResponseCache cache;			/**< Encoded responses of cacheable requests. */
+	api::OpenMetricsWriter metrics;			/**< Renders the /metrics endpoint. Only used by the worker thread. */
 };
 
 } /* namespace node */
@@ -0,0 +1,90 @@
+/** Writer for the OpenMetrics text format.
+ *
+ * @file
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <string_view>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include <villas/buffer.hpp>
+
+namespace villas {
+namespace node {
+namespace api {
+
+/** Renders metrics in the OpenMetrics text exposition format.
+ *
+ * All samples of a family must be added right after the family itself.
+ * The exposition is rendered into a buffer which keeps its capacity
+ * between two scrapes so that rendering does not allocate memory
+ * once the number of metrics has settled.
+ *
+ * @see https://github.com/OpenObservability/OpenMetrics/blob/main/specification/OpenMetrics.md
+ */
+class OpenMetricsWriter {
+
+public:
+	using Label = std::pair<const char *, std::string_view>;
+	using Labels = std::initializer_list<Label>;
+
+	enum class Type {
+		GAUGE,
+		COUNTER
+	};
+
+protected:
+	fmt::memory_buffer buffer;
+
+	const char *family;	/**< Name of the current family. */
+	Type type;		/**< Type of the current family. */
+
+	void write(std::string_view str);
+
+	void writeSampleName(Labels labels);
+
+	void writeEscaped(std::string_view value);
+
+	void writeValue(double value);
+
+public:
+	OpenMetricsWriter() :
+		family(nullptr),
+		type(Type::GAUGE)
+	{ }
+
+	/** Start a new exposition. */
+	void clear();
+
+	/** Start a new family of metrics.
+	 *
+	 * @param name The name of the family. For counters without the "_total" suffix.
+	 * @param unit The unit of the metrics. If given, \p name must end with it.
+	 */
+	void addFamily(const char *name, Type t, const char *help, const char *unit = nullptr);
+
+	void addSample(Labels labels, double value);
+
+	void addSample(Labels labels, uint64_t value);
+
+	/** Terminate the exposition and append it to \p body. */
+	void finish(Buffer &body);
+
+	static
+	const char * getContentType()
+	{
+		return "application/openmetrics-text; version=1.0.0; charset=utf-8";
+	}
+};
+
+} /* namespace api */
+} /* namespace node */
+} /* namespace villas */
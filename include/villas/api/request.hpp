@@ -74,6 +74,16 @@ public:
 	virtual
 	void decode();
 
+	/** Responses of cacheable requests only depend on the configuration.
+	 *
+	 * They are served from the response cache until the generation of the super node changes.
+	 */
+	virtual
+	bool isCacheable() const
+	{
+		return false;
+	}
+
 	const std::string & getMatch(int idx) const
 	{
 		return matches[idx];
@@ -110,6 +120,10 @@ public:
 	virtual
 	bool match(const std::string &uri, std::smatch &m) const = 0;
 
+	/** Get the regular expression of the route. */
+	virtual
+	std::string getPattern() const = 0;
+
 	virtual
 	Request * make(Session *s) = 0;
 
@@ -177,6 +191,12 @@ public:
 	{
 		return std::regex_match(uri, match, regex);
 	}
+
+	virtual std::string
+	getPattern() const
+	{
+		return re;
+	}
 };
 
 } /* namespace api */
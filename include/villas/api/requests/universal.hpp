@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include <villas/nodes/api.hpp>
 #include <villas/api/requests/node.hpp>
 
@@ -24,11 +26,37 @@ class UniversalRequest : public NodeRequest {
 protected:
 	APINode *api_node;
 
+	/** Get the payload type of the sub-resource of a channel. */
+	static universal::PayloadType
+	getPayloadType(const std::string &subResource);
+
+	/** Get the index of a channel in the mailbox of a direction.
+	 *
+	 * @param code The HTTP status code if the channel does not exist.
+	 */
+	unsigned
+	getChannelIndex(const APINode::Direction &dir, SampleMailbox::Ptr mb, const std::string &id, universal::PayloadType payload, int code);
+
+	/** Get the channels selected by the comma-separated 'ids' query argument.
+	 *
+	 * @return A mask over the signals of the mailbox. All channels are selected if the argument is missing.
+	 */
+	std::vector<bool>
+	getChannelMask(const APINode::Direction &dir, SampleMailbox::Ptr mb, universal::PayloadType payload);
+
+	/** Decode a value of a channel sent by a client. */
+	SampleMailbox::Value
+	parseValue(json_t *json, Signal::Ptr sig, unsigned index, struct timespec *ts);
+
 public:
 	using NodeRequest::NodeRequest;
 
 	virtual void
 	prepare();
+
+	/** Encode a value of a channel. */
+	static json_t *
+	valueToJson(Signal::Ptr sig, const union SignalData &data, const struct timespec *ts);
 };
 
 } /* namespace api */
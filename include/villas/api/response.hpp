@@ -41,9 +41,16 @@ public:
 	encodeBody()
 	{ }
 
-	int
+	virtual int
 	writeBody(struct lws *wsi);
 
+	/** Streaming responses have no content length and send their body in several parts. */
+	virtual bool
+	isStreaming() const
+	{
+		return false;
+	}
+
 	int
 	writeHeaders(struct lws *wsi);
 
@@ -95,6 +102,38 @@ public:
 	}
 };
 
+/** A response which keeps the connection open and pushes Server-Sent Events.
+ *
+ * The session polls for new events at most at the given rate.
+ */
+class StreamResponse : public Response {
+
+protected:
+	unsigned interval;	/**< Minimal time between two events in micro seconds. */
+
+	/** Get the data of the next event or nullptr if there is nothing new. */
+	virtual json_t *
+	nextEvent() = 0;
+
+	void
+	encodeEvent(json_t *json);
+
+public:
+	StreamResponse(Session *s, double rate);
+
+	virtual void
+	encodeBody();
+
+	virtual int
+	writeBody(struct lws *wsi);
+
+	virtual bool
+	isStreaming() const
+	{
+		return true;
+	}
+};
+
 } /* namespace api */
 } /* namespace node */
 } /* namespace villas */
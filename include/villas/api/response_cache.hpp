@@ -0,0 +1,51 @@
+/** Cache of pre-serialized API responses.
+ *
+ * @file
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+
+#include <villas/buffer.hpp>
+
+namespace villas {
+namespace node {
+namespace api {
+
+/** Keeps the encoded bodies of responses which only depend on the configuration.
+ *
+ * Each entry is tagged with the generation of the super node at the time
+ * it was stored. An entry of an older generation is never served.
+ */
+class ResponseCache {
+
+protected:
+	struct Entry {
+		uint64_t generation;
+		Buffer body;
+	};
+
+	std::mutex mutex;
+	std::map<std::string, Entry> entries;
+
+public:
+	/** Get the body of a cached response.
+	 *
+	 * @return false if there is no entry of this generation.
+	 */
+	bool lookup(const std::string &key, uint64_t generation, Buffer &body);
+
+	void store(const std::string &key, uint64_t generation, const Buffer &body);
+
+	void clear();
+};
+
+} /* namespace api */
+} /* namespace node */
+} /* namespace villas */
@@ -0,0 +1,85 @@
+/** API request routing.
+ *
+ * @file
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <regex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace villas {
+namespace node {
+namespace api {
+
+/* Forward declarations */
+class RequestFactory;
+
+/** A route table for the API endpoints.
+ *
+ * The regular expressions of the endpoints are split at each '/' into
+ * segments which are stored in a trie. Literal segments are looked up in
+ * a hash map. Only segments containing regular expressions are matched
+ * by std::regex, and only against a single segment of the URI.
+ * Patterns which contain a '/' inside a group match the remainder of
+ * the URI as a whole.
+ */
+class Router {
+
+protected:
+	struct Node;
+
+	struct Param {
+		std::string pattern;
+		std::regex regex;
+		std::unique_ptr<Node> child;
+	};
+
+	struct Tail {
+		std::regex regex;
+		RequestFactory *factory;
+	};
+
+	struct Node {
+		std::unordered_map<std::string, std::unique_ptr<Node>> literals;
+		std::list<Param> params;
+		std::list<Tail> tails;
+		RequestFactory *factory;
+
+		Node() :
+			factory(nullptr)
+		{ }
+	};
+
+	Node root;
+
+	bool match(const Node *n, const std::vector<size_t> &offsets, size_t i, const std::string &uri, std::vector<std::string> &captures, RequestFactory **rf) const;
+
+	/** Split a pattern at each '/' which is not part of a group or character class. */
+	static
+	std::vector<std::string> splitPattern(const std::string &pattern);
+
+	static
+	bool isLiteral(const std::string &segment);
+
+public:
+	void add(const std::string &pattern, RequestFactory *rf);
+
+	/** Find the factory for an URI.
+	 *
+	 * @param matches The full URI followed by all captured groups.
+	 * @return nullptr if no route matches.
+	 */
+	RequestFactory * lookup(const std::string &uri, std::vector<std::string> &matches) const;
+};
+
+} /* namespace api */
+} /* namespace node */
+} /* namespace villas */
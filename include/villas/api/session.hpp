@@ -81,6 +81,11 @@ public:
 
 	std::string getName() const;
 
+	enum State getState() const
+	{
+		return state;
+	}
+
 	SuperNode * getSuperNode() const
 	{
 		return api->getSuperNode();
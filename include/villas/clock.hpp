@@ -0,0 +1,78 @@
+/** Wall-clock time source with an optional calibrated TSC fast path
+ *
+ * @file
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+
+#include <jansson.h>
+
+namespace villas {
+namespace node {
+
+/** Interval in seconds after which the TSC is recalibrated against CLOCK_REALTIME */
+#define CLOCK_TSC_RECALIBRATION_INTERVAL	1.0
+
+enum class ClockSource {
+	SYSTEM,		/**< clock_gettime(CLOCK_REALTIME) */
+	TSC		/**< The time stamp counter of the CPU, calibrated against CLOCK_REALTIME */
+};
+
+/** Parse the clock source from a string ("system" or "tsc"). */
+int clock_parse(enum ClockSource *src, json_t *json);
+
+/** Select the clock source which is used by clock_now().
+ *
+ * The TSC source requires an invariant TSC which is synchronized across all CPU cores.
+ * If this is not the case, or the calibration fails, we fall back to the system clock.
+ *
+ * @retval 0 The requested clock source is used.
+ * @retval <0 We fell back to the system clock.
+ */
+int clock_init(enum ClockSource src);
+
+/** Convert a timespec to nanoseconds. */
+static inline
+int64_t time_to_ns(const struct timespec *ts)
+{
+	return (int64_t) ts->tv_sec * 1000000000 + ts->tv_nsec;
+}
+
+/** Convert nanoseconds to a timespec. */
+static inline
+struct timespec time_from_ns(int64_t ns)
+{
+	struct timespec ts = {
+		.tv_sec = ns / 1000000000,
+		.tv_nsec = ns % 1000000000
+	};
+
+	return ts;
+}
+
+/** Get the current wall-clock time.
+ *
+ * This is a drop-in replacement for time_now() which should be used
+ * for sample timestamps and statistics in the data path.
+ *
+ * The TSC is recalibrated lazily by the first caller which
+ * notices that the calibration is older than CLOCK_TSC_RECALIBRATION_INTERVAL.
+ */
+struct timespec clock_now();
+
+/** Get the currently used clock source. */
+enum ClockSource clock_source();
+
+/** Get the calibrated TSC frequency in Hz (or 0 if the system clock is used). */
+double clock_tsc_frequency();
+
+const char * clock_source_str(enum ClockSource src);
+
+} /* namespace node */
+} /* namespace villas */
@@ -0,0 +1,79 @@
+/** Differences between two super node configurations.
+ *
+ * @file
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+#pragma once
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <jansson.h>
+
+namespace villas {
+namespace node {
+
+/** Compares a new configuration against the running one.
+ *
+ * Nodes are identified by their name, paths by their configuration.
+ * Changes of hooks are detected separately so that a node can keep its
+ * connection while only its hooks are rebuilt.
+ * A path which has not changed itself must still be restarted if
+ * one of its nodes is rebuilt or if it shares a source node with
+ * another path which is restarted. Changed hooks of a node do not
+ * restart its paths.
+ *
+ * Both configurations must not have been touched by any parser yet.
+ */
+class ConfigDiff {
+
+public:
+	enum class Change {
+		NONE,			/**< Keep running. */
+		ADDED,			/**< Create from new configuration. */
+		REMOVED,		/**< Stop and destroy. */
+		CHANGED,		/**< Rebuild from the new configuration. */
+		HOOKS,			/**< Only the hooks of a node changed. The node keeps running. */
+		RESTARTED		/**< Unchanged path which must be rebuilt because of its nodes. */
+	};
+
+	bool global;				/**< Settings outside of 'nodes' and 'paths' changed. */
+
+	std::map<std::string, Change> nodes;	/**< Node name => change */
+
+	std::vector<Change> oldPaths;		/**< Change per index of the old 'paths' array. */
+	std::vector<Change> newPaths;		/**< Change per index of the new 'paths' array. */
+	std::vector<int> pathMatches;		/**< Index in the new 'paths' array per index of the old one or -1. */
+
+	ConfigDiff(json_t *old_cfg, json_t *new_cfg);
+
+	/** Check if the node must be stopped before applying the new configuration. */
+	bool isNodeStale(const std::string &name) const;
+
+	/** Check if the node must be parsed from the new configuration. */
+	bool isNodeFresh(const std::string &name) const;
+
+	/** Check if anything changed at all. */
+	bool isEmpty() const;
+
+	json_t * toJson() const;
+
+	static
+	const char * changeToString(Change c);
+
+	/** Get the names of all nodes which are referenced by a path configuration. */
+	static
+	std::set<std::string> getPathNodes(json_t *json_path, bool sources_only = false);
+
+	/** Get a copy of a node configuration without any hooks. */
+	static
+	json_t * withoutHooks(json_t *json_node);
+};
+
+} /* namespace node */
+} /* namespace villas */
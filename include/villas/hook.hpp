@@ -12,6 +12,9 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+
 #include <villas/list.hpp>
 #include <villas/signal.hpp>
 #include <villas/signal_list.hpp>
@@ -67,6 +70,14 @@ protected:
 
 	json_t *config;			/**< A JSON object containing the configuration of the hook. */
 
+	/* Processing time of the hook
+	 *
+	 * Only updated by the thread which runs the hook.
+	 * Other threads may read them at any time.
+	 */
+	std::atomic<uint64_t> busy;	/**< Time in ns spent with processing the measured samples. */
+	std::atomic<uint64_t> measured;	/**< Number of samples whose processing time has been measured. */
+
 public:
 	Hook(Path *p, Node *n, int fl, int prio, bool en = true);
 
@@ -139,6 +150,33 @@ public:
 		return Reason::OK;
 	};
 
+	/** Process a sample and account its processing time. */
+	Reason processTimed(struct Sample *smp)
+	{
+		auto since = std::chrono::steady_clock::now();
+
+		auto ret = process(smp);
+
+		auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - since).count();
+
+		busy.store(busy.load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+		measured.store(measured.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+		return ret;
+	}
+
+	/** Get the time in ns spent with processing the measured samples. */
+	uint64_t getBusy() const
+	{
+		return busy.load(std::memory_order_relaxed);
+	}
+
+	/** Get the number of samples whose processing time has been measured. */
+	uint64_t getMeasured() const
+	{
+		return measured.load(std::memory_order_relaxed);
+	}
+
 	unsigned getPriority() const
 	{
 		return priority;
@@ -11,10 +11,18 @@
 
 #pragma once
 
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <shared_mutex>
+
 #include <jansson.h>
 
 #include <villas/hook.hpp>
 
+/** The processing time of each hook is measured for one out of this many batches. */
+#define HOOK_TIMING_INTERVAL 16
+
 namespace villas {
 namespace node {
 
@@ -25,10 +33,35 @@ struct Sample;
 
 class HookList : public std::list<Hook::Ptr> {
 
+protected:
+	std::atomic<HookList *> next;		/**< Replacement which is swapped in before the next batch. */
+	std::list<HookList *> retired;		/**< Replaced hooks which wait to be stopped and released. */
+	json_t *config;				/**< Configuration of hooks which have been replaced at runtime. */
+	bool started;				/**< The hooks in the list have been started. */
+	std::atomic<unsigned> batches;		/**< Number of batches processed by process(). */
+
+	/** Protects the list against being swapped while it is used.
+	 *
+	 * Several threads may call process() concurrently, e.g. the writer
+	 * threads of multiple paths which send to the same node. Each of them
+	 * holds the lock shared for a batch. The replacement is only swapped
+	 * in while the lock is held exclusively.
+	 */
+	mutable std::shared_mutex mutex;
+
+	/** Swap in the pending replacement once no other thread processes a batch. */
+	void update();
+
 public:
-	HookList()
+	HookList() :
+		next(nullptr),
+		config(nullptr),
+		started(false),
+		batches(0)
 	{ }
 
+	~HookList();
+
 	/** Parses an object of hooks
 	 *
 	 * Example:
@@ -50,17 +83,45 @@ public:
 	void prepare(SignalList::Ptr sigs, int mask, Path *p, Node *n);
 
 	int process(struct Sample *smps[], unsigned cnt);
+
+	/** Replace all hooks at runtime.
+	 *
+	 * The new hooks are parsed, prepared and started by the calling thread.
+	 * The thread which runs process() swaps them in between two batches so
+	 * that no sample is lost. The old hooks are stopped and released by the
+	 * next call to collect().
+	 *
+	 * The new hooks must produce the same output signals as the current ones.
+	 *
+	 * @param running If false, the hooks are neither started nor stopped and are swapped right away.
+	 *                This is only allowed if process() is not running concurrently.
+	 */
+	void replace(json_t *json, int mask, SignalList::Ptr sigs, int m, Path *p, Node *n, bool running);
+
+	/** Stop and release hooks which have been replaced. */
+	void collect();
 	void periodic();
 	void start();
 	void stop();
 
 	void dump(villas::Logger logger, std::string subject) const;
 
+	/** Call \p cb for each hook while the list can not be swapped. */
+	template<typename F>
+	void forEach(F cb) const
+	{
+		std::shared_lock<std::shared_mutex> guard(mutex);
+
+		for (auto h : *this)
+			cb(h);
+	}
+
 	SignalList::Ptr getSignals() const;
 
 	/** Get the maximum number of signals which is used by any of the hooks in the list. */
 	unsigned getSignalsMaxCount() const;
 
+	/** Get the configuration of the hooks including a pending replacement. */
 	json_t * toJson() const;
 };
 
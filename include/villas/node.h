@@ -9,12 +9,15 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
 
 #include <uuid/uuid.h>
 #include <jansson.h>
 
 typedef void *vnode;
 typedef void *vsample;
+typedef void *vpool;
 
 vnode * node_new(const char *json_str, const char *sn_uuid_str);
 
@@ -46,6 +49,10 @@ unsigned node_input_signals_max_cnt(vnode *n);
 
 unsigned node_output_signals_max_cnt(vnode *n);
 
+unsigned node_input_vectorize(vnode *n);
+
+unsigned node_output_vectorize(vnode *n);
+
 int node_reverse(vnode *n);
 
 int node_read(vnode *n, vsample **smps, unsigned cnt);
@@ -74,4 +81,54 @@ vsample * sample_pack(unsigned seq, struct timespec *ts_origin, struct timespec
 
 void sample_unpack(vsample *s, unsigned *seq, struct timespec *ts_origin, struct timespec *ts_received, int *flags, unsigned *len, double *values);
 
+/** Create a memory pool for \p cnt samples with up to \p len values each.
+ *
+ * @return The pool or NULL on failure.
+ */
+vpool * pool_new(unsigned cnt, unsigned len);
+
+/** Release a pool which has been created with pool_new().
+ *
+ * All samples must have been returned to the pool before.
+ */
+int pool_delete(vpool *p);
+
+/** Allocate up to \p cnt samples from a pool.
+ *
+ * @return The number of allocated samples or a negative value on error.
+ */
+int sample_alloc_many(vpool *p, vsample **smps, unsigned cnt);
+
+/** Release a reference to \p cnt samples. Pool-backed samples are returned to their pool. */
+void sample_decref_many(vsample **smps, unsigned cnt);
+
+/** Fill \p cnt samples from contiguous arrays.
+ *
+ * The timestamp flags are only set for timestamps which are non-zero.
+ *
+ * @param seq An array of \p cnt sequence numbers (may be NULL).
+ * @param ts_origin An array of \p cnt origin timestamps (may be NULL).
+ * @param ts_received An array of \p cnt receive timestamps (may be NULL).
+ * @param lens An array of \p cnt sample lengths of at most \p len (may be NULL if all samples have \p len values).
+ * @param len The number of values per row of \p values.
+ * @param values A row-major matrix of \p cnt x \p len values.
+ * @return The number of filled samples.
+ */
+int sample_pack_many(vsample **smps, unsigned cnt, const uint64_t *seq, const struct timespec *ts_origin, const struct timespec *ts_received, const unsigned *lens, unsigned len, const double *values);
+
+/** Copy \p cnt samples into contiguous arrays.
+ *
+ * Samples with less than \p len values are padded with NaN.
+ *
+ * @param seq An array for \p cnt sequence numbers (may be NULL).
+ * @param ts_origin An array for \p cnt origin timestamps (may be NULL).
+ * @param ts_received An array for \p cnt receive timestamps (may be NULL).
+ * @param flags An array for \p cnt sample flags (may be NULL).
+ * @param lens An array for \p cnt sample lengths (may be NULL).
+ * @param len The number of values per row of \p values.
+ * @param values A row-major matrix of \p cnt x \p len values.
+ * @return The number of copied samples.
+ */
+int sample_unpack_many(vsample **smps, unsigned cnt, uint64_t *seq, struct timespec *ts_origin, struct timespec *ts_received, int *flags, unsigned *lens, unsigned len, double *values);
+
 int memory_init(int hugepages);
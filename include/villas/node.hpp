@@ -161,6 +161,14 @@ public:
 	virtual
 	int restart();
 
+	/** Replace the read and write hooks of a node without stopping it.
+	 *
+	 * The new hooks must not change the signals of the node.
+	 *
+	 * @param json A JSON object containing the new configuration of the node.
+	 */
+	int reloadHooks(json_t *json);
+
 	/** Receive multiple messages at once.
 	 *
 	 * This callback is optional. It will only be called if non-null.
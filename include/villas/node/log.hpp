@@ -0,0 +1,37 @@
+/** Logging macros for the sample processing path.
+ *
+ * The regular logger methods evaluate all of their arguments before
+ * the log level is checked. In the sample path, this means that every
+ * batch pays for formatting helpers like Path::toString() even if the
+ * debug level is disabled.
+ *
+ * The macros below only evaluate their arguments if the message will
+ * actually be emitted. Messages below VILLAS_HOTPATH_LOG_LEVEL are removed
+ * at compile-time altogether.
+ *
+ * @file
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+#pragma once
+
+#include <villas/node/config.hpp>
+#include <villas/log.hpp>
+
+#ifndef VILLAS_HOTPATH_LOG_LEVEL
+  #define VILLAS_HOTPATH_LOG_LEVEL SPDLOG_LEVEL_TRACE
+#endif
+
+#define VILLAS_LOG(logger, lvl, ...) \
+	do { \
+		if ((lvl) >= VILLAS_HOTPATH_LOG_LEVEL && (logger)->should_log((spdlog::level::level_enum) (lvl))) \
+			(logger)->log((spdlog::level::level_enum) (lvl), __VA_ARGS__); \
+	} while (0)
+
+#define VILLAS_LOG_TRACE(logger, ...)	VILLAS_LOG(logger, SPDLOG_LEVEL_TRACE, __VA_ARGS__)
+#define VILLAS_LOG_DEBUG(logger, ...)	VILLAS_LOG(logger, SPDLOG_LEVEL_DEBUG, __VA_ARGS__)
+#define VILLAS_LOG_INFO(logger, ...)	VILLAS_LOG(logger, SPDLOG_LEVEL_INFO, __VA_ARGS__)
+#define VILLAS_LOG_WARN(logger, ...)	VILLAS_LOG(logger, SPDLOG_LEVEL_WARN, __VA_ARGS__)
+#define VILLAS_LOG_ERROR(logger, ...)	VILLAS_LOG(logger, SPDLOG_LEVEL_ERROR, __VA_ARGS__)
@@ -0,0 +1,84 @@
+/** Static tracepoints along the sample processing path.
+ *
+ * The tracepoints are USDT probes which can be attached by bpftrace,
+ * SystemTap or perf without restarting VILLASnode. A probe which is
+ * not attached is a single nop instruction.
+ *
+ * Each probe has a semaphore which is incremented by the tracer while
+ * the probe is attached. Probes which fire for every sample of a batch
+ * check it with VILLAS_TRACE_ENABLED() so that the loop is skipped
+ * altogether if nobody is listening.
+ *
+ * Without WITH_TRACING, all macros are removed at compile-time.
+ *
+ * See tools/trace for bpftrace scripts which make use of these probes.
+ *
+ * @file
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+#pragma once
+
+#include <villas/node/config.hpp>
+
+/** All probes of the provider "villas".
+ *
+ * Batch probes come in start / done pairs:
+ *
+ *   node_read_start(node, cnt)				node_read_done(node, cnt, read)
+ *   hooks_start(hook_list, cnt)			hooks_done(hook_list, cnt, processed)
+ *   path_source_read_start(path, node)			path_source_read_done(path, node, enqueued)
+ *   path_enqueue_start(path, cnt)			path_enqueue_done(path, cnt, cloned)
+ *   path_destination_write_start(path, node, cnt)	path_destination_write_done(path, node, cnt, sent)
+ *   node_write_start(node, cnt)			node_write_done(node, cnt, sent)
+ *
+ * Sample probes fire once per sample:
+ *
+ *   node_read_sample(node, smp, sequence)		after the sample has been received by a node
+ *   hooks_sample(hook_list, smp, sequence)		after the sample has passed a list of hooks
+ *   path_mux_sample(path, node, from, to, sequence)	after a received sample has been muxed into a new sample of a path
+ *   path_enqueue_sample(path, from, to, sequence)	after a sample of a path has been cloned for its destinations
+ *   node_write_sample(node, smp, sequence)		after the sample has been sent by a node
+ *
+ * Nodes are identified by their name and paths by their UUID.
+ */
+#define VILLAS_TRACE_PROBES(X) \
+	X(node_read_start) \
+	X(node_read_done) \
+	X(node_read_sample) \
+	X(hooks_start) \
+	X(hooks_done) \
+	X(hooks_sample) \
+	X(path_source_read_start) \
+	X(path_source_read_done) \
+	X(path_mux_sample) \
+	X(path_enqueue_start) \
+	X(path_enqueue_done) \
+	X(path_enqueue_sample) \
+	X(path_destination_write_start) \
+	X(path_destination_write_done) \
+	X(node_write_start) \
+	X(node_write_done) \
+	X(node_write_sample)
+
+#ifdef WITH_TRACING
+  #define _SDT_HAS_SEMAPHORES 1
+  #include <sys/sdt.h>
+
+  #define VILLAS_TRACE_SEMAPHORE(probe) villas_##probe##_semaphore
+
+  #define VILLAS_TRACE_DECLARE(probe) extern unsigned short VILLAS_TRACE_SEMAPHORE(probe);
+
+  /* The semaphores are defined in lib/trace.cpp */
+  extern "C" {
+	VILLAS_TRACE_PROBES(VILLAS_TRACE_DECLARE)
+  }
+
+  #define VILLAS_TRACE(probe, ...)	STAP_PROBEV(villas, probe, __VA_ARGS__)
+  #define VILLAS_TRACE_ENABLED(probe)	__builtin_expect(VILLAS_TRACE_SEMAPHORE(probe) != 0, 0)
+#else
+  #define VILLAS_TRACE(probe, ...)	do { } while (0)
+  #define VILLAS_TRACE_ENABLED(probe)	false
+#endif /* WITH_TRACING */
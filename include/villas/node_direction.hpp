@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <atomic>
+
 #include <jansson.h>
 
 #include <villas/common.hpp>
@@ -43,6 +45,23 @@ public:
 	int builtin;			/**< This node should use built-in hooks by default. */
 	unsigned vectorize;		/**< Number of messages to send / recv at once (scatter / gather) */
 
+	/** Adaptive vectorization.
+	 *
+	 * If enabled, 'vectorize' is the upper bound of the batch size.
+	 * The actual batch size grows while batches are filled completely
+	 * and shrinks to the number of available samples if they are not.
+	 *
+	 * The writer threads of several paths might write to the same node
+	 * concurrently. Hence, the state is atomic. Concurrent updates
+	 * may overwrite each other which only affects the next batch size.
+	 */
+	struct {
+		int enabled;
+		double latency;			/**< Maximum latency in seconds which is added by waiting for a full batch. */
+		std::atomic<double> cost;	/**< Moving average of the time per sample in seconds. */
+		std::atomic<unsigned> current;	/**< Batch size of the next read / write. */
+	} adaptive;
+
 	HookList hooks;			/**< List of read / write hooks (struct hook). */
 	SignalList::Ptr signals;	/**< Signal description. */
 
@@ -56,9 +75,27 @@ public:
 	int start();
 	int stop();
 
+	/** Replace all hooks of this direction without interrupting the paths which use it.
+	 *
+	 * The output signals must not change.
+	 */
+	void replaceHooks(json_t *json_hooks);
+
 	SignalList::Ptr getSignals(int after_hooks = true) const;
 
 	unsigned getSignalsMaxCount() const;
+
+	/** Get the number of samples which should be read / written at once. */
+	unsigned getBatchSize() const
+	{
+		return adaptive.enabled ? adaptive.current.load(std::memory_order_relaxed) : vectorize;
+	}
+
+	/** Adjust the batch size after \p cnt of \p requested samples have been processed within \p duration seconds.
+	 *
+	 * Also updates the batch size metric of the node.
+	 */
+	void adapt(unsigned requested, unsigned cnt, double duration);
 };
 
 } /* namespace node */
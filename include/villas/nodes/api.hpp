@@ -10,8 +10,8 @@
 #pragma once
 
 #include <villas/node.hpp>
+#include <villas/sample_mailbox.hpp>
 #include <villas/api/universal.hpp>
-#include <pthread.h>
 
 namespace villas {
 namespace node {
@@ -25,10 +25,14 @@ public:
 	APINode(const std::string &name = "");
 
 	struct Direction {
-		Sample *sample;
+		SampleMailbox::Ptr mailbox;	/**< Latest values. Set once the node is prepared (read) or started (write). */
 		api::universal::ChannelList channels;
-		pthread_cond_t cv;
-		pthread_mutex_t mutex;
+
+		/** Get the mailbox from any thread. */
+		SampleMailbox::Ptr getMailbox() const
+		{
+			return std::atomic_load(&mailbox);
+		}
 	};
 
 	// Accessed by api::universal::SignalRequest
@@ -37,10 +41,15 @@ public:
 	virtual
 	int prepare();
 
+	virtual
+	int start();
+
 	virtual
 	int check();
 
 protected:
+	uint64_t lastRead;		/**< Sequence number of the read mailbox at the last read. */
+
 	virtual
 	int parse(json_t *json, const uuid_t sn_uuid);
 
@@ -11,6 +11,7 @@
 #include <jansson.h>
 
 #include <villas/timing.hpp>
+#include <villas/timestamping.hpp>
 
 namespace villas {
 namespace node {
@@ -30,6 +31,7 @@ struct can {
 	char *interface_name;
 	struct can_signal *in;
 	struct can_signal *out;
+	struct Timestamping timestamping;
 
 	/* States */
 	int socket;
@@ -11,7 +11,7 @@
 #include <cstdio>
 
 #include <villas/format.hpp>
-#include <villas/task.hpp>
+#include <villas/precision_task.hpp>
 
 namespace villas {
 namespace node {
@@ -31,7 +31,7 @@ struct file {
 
 	unsigned skip_lines;		/**< Skip the first n-th lines/samples of the file. */
 	int flush;			/**< Flush / upload file contents after each write. */
-	struct Task task;		/**< Timer file descriptor. Blocks until 1 / rate seconds are elapsed. */
+	PrecisionTask task;		/**< Timer file descriptor. Blocks until 1 / rate seconds are elapsed. */
 	double rate;			/**< The read rate. */
 	size_t buffer_size_out;		/**< Defines size of output stream buffer. No buffer is created if value is set to zero. */
 	size_t buffer_size_in;		/**< Defines size of input stream buffer. No buffer is created if value is set to zero. */
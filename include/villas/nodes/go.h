@@ -8,10 +8,26 @@
 
 #pragma once
 
+#include <stdint.h>
+
 typedef void *_go_plugin;
 typedef void *_go_plugin_list;
 typedef void *_go_logger;
 
+/** A view on a struct Sample which is exchanged with node-types implemented in Go without serialization.
+ *
+ * The header fields are copied, while data points directly to the values of the sample.
+ */
+typedef struct {
+	uint64_t sequence;
+	unsigned length;
+	unsigned capacity;
+	int flags;
+	int64_t ts_origin[2];
+	int64_t ts_received[2];
+	double *data;
+} _go_sample;
+
 typedef  void (*_go_register_node_factory_cb)(_go_plugin_list pl, char *name, char *desc, int flags);
 typedef void (*_go_logger_log_cb)(_go_logger l, int level, char *msg);
 
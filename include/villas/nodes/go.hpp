@@ -8,8 +8,14 @@
 
 #pragma once
 
+#include <climits>
+
 #include <villas/node.hpp>
 
+extern "C" {
+	#include <villas/nodes/go.h>
+}
+
 namespace villas {
 namespace node {
 
@@ -29,6 +35,19 @@ protected:
 
 	Format *formatter;
 
+	bool samples;			/**< The Go node-type exchanges samples directly instead of serialized data. */
+	bool convert;			/**< Received values must be converted from float64 to the types of the input signals. */
+	bool convert_out;		/**< Sent values must be converted from the types of the output signals to float64. */
+
+	/* Reading and writing happens in different threads, so each direction has its own buffers */
+	std::vector<_go_sample> views_in;	/**< Views on the samples which are read by the Go node-type. */
+	std::vector<_go_sample> views_out;	/**< Views on the samples which are written to the Go node-type. */
+	std::vector<double> values_out;		/**< Converted values of written samples with non-float signals. */
+
+	bool isFloat(SignalList::Ptr sigs, unsigned len = UINT_MAX);
+
+	void prepareViews(std::vector<_go_sample> &views, struct Sample * smps[], unsigned cnt);
+
 	virtual
 	int _read(struct Sample * smps[], unsigned cnt);
 
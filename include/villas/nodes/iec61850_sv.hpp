@@ -17,6 +17,7 @@
 #include <villas/pool.hpp>
 #include <villas/list.hpp>
 #include <villas/nodes/iec61850.hpp>
+#include <villas/timestamping.hpp>
 
 namespace villas {
 namespace node {
@@ -35,6 +36,8 @@ struct iec61850_sv {
 		SVSubscriber subscriber;
 		SVReceiver receiver;
 
+		struct Timestamping timestamping;
+
 		struct CQueueSignalled queue;
 		struct Pool pool;
 
@@ -21,6 +21,7 @@ protected:
 	int queuelen;
 	struct CQueueSignalled queue;
 	enum QueueSignalledMode mode;
+	int spsc;			/**< Use a single-producer single-consumer queue (-1 = auto). */
 
 	virtual
 	int _write(struct Sample * smps[], unsigned cnt);
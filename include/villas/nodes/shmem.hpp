@@ -26,6 +26,11 @@ struct shmem {
 	struct ShmemConfig conf; 	/**< Interface configuration struct. */
 	char **exec;            	/**< External program to execute on start. */
 	struct ShmemInterface intf;  	/**< Shmem interface */
+
+	bool broadcast;			/**< Use broadcast rings instead of the paired interface. */
+	bool latest;			/**< Only read the most recent sample of the input ring. */
+	struct ShmemBroadcast bcast_out;	/**< Broadcast ring which is written by this node. */
+	struct ShmemBroadcast bcast_in;		/**< Broadcast ring which is read by this node. */
 };
 
 char * shmem_print(NodeCompat *n);
@@ -9,7 +9,7 @@
 #pragma once
 
 #include <villas/timing.hpp>
-#include <villas/task.hpp>
+#include <villas/precision_task.hpp>
 #include <villas/node.hpp>
 
 namespace villas {
@@ -63,13 +63,64 @@ public:
 	Signal::Ptr toSignal(Signal::Ptr tpl) const;
 };
 
+/** Struct-of-arrays state of all signals of the same type.
+ *
+ * Used by the batch mode of the signal node to generate a block of samples
+ * with a branch-free inner loop across signals which can be vectorized by the compiler.
+ *
+ * Instead of evaluating sin() and fmod() for each value, sine signals are generated
+ * by a rotating complex phasor and all periodic signals by a phase accumulator.
+ * Both are re-anchored to the exact phase at the beginning of each block by seek().
+ * This removes the accumulated rounding error and accounts for missed steps.
+ */
+class SignalNodeGroup {
+
+public:
+	enum SignalNodeSignal::Type type;
+
+	std::vector<unsigned> index;		/**< Index of the signal in the sample. */
+
+	std::vector<double> offset;
+	std::vector<double> amplitude;
+	std::vector<double> frequency;
+	std::vector<double> phase;
+
+	std::vector<double> re, im;		/**< Rotating phasor of sine signals. */
+	std::vector<double> rot_re, rot_im;	/**< Rotation of the phasor per step. */
+
+	std::vector<double> acc;		/**< Phase accumulator in [0, 1). */
+	std::vector<double> inc;		/**< Increment of the phase accumulator per step. */
+
+	std::vector<double> threshold;		/**< Pulse width as fraction of the period. */
+	std::vector<double> high, low;		/**< Pulse amplitudes. */
+
+	std::vector<double> stddev;		/**< Standard deviation of random signals. */
+	std::vector<double> last;		/**< Current value of random walks. */
+
+	std::vector<double> values;		/**< The values of the current step. */
+
+	SignalNodeGroup(enum SignalNodeSignal::Type t) :
+		type(t)
+	{ }
+
+	void add(unsigned idx, const SignalNodeSignal &sig, double rate);
+
+	/** Set the state of all oscillators to the exact phase of step \p counter. */
+	void seek(uint64_t counter, double rate);
+
+	/** Calculate the values of step \p counter and advance the oscillators by one step. */
+	void step(uint64_t counter);
+};
+
 class SignalNode : public Node {
 
 protected:
 	std::vector<SignalNodeSignal> signals;
+	std::vector<SignalNodeGroup> groups;	/**< Signals grouped by type for batch mode. */
 
-	struct Task task;			/**< Timer for periodic events. */
+	PrecisionTask task;			/**< Timer for periodic events. */
 	int rt;					/**< Real-time mode? */
+	bool batch;				/**< Generate a block of in.vectorize samples per timer tick. */
 
 	double rate;				/**< Sampling rate. */
 	bool monitor_missed;			/**< Boolean, if set, node counts missed steps and warns user. */
@@ -81,6 +132,8 @@ protected:
 	virtual
 	int _read(struct Sample *smps[], unsigned cnt);
 
+	int readBatch(struct Sample *smps[], unsigned cnt);
+
 public:
 	SignalNode(const std::string &name = "");
 
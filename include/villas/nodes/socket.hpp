@@ -11,6 +11,7 @@
 #include <villas/node/config.hpp>
 #include <villas/socket_addr.hpp>
 #include <villas/format.hpp>
+#include <villas/timestamping.hpp>
 
 namespace villas {
 namespace node {
@@ -21,6 +22,12 @@ class NodeCompat;
 /** The maximum length of a packet which contains stuct msg. */
 #define SOCKET_INITIAL_BUFFER_LEN (64*1024)
 
+/* Default settings of the memory-mapped receive ring */
+#define SOCKET_RING_BLOCK_SIZE	(1 << 16)
+#define SOCKET_RING_BLOCK_COUNT	64
+#define SOCKET_RING_FRAME_SIZE	2048
+#define SOCKET_RING_TIMEOUT	1
+
 struct Socket {
 	int sd;				/**< The socket descriptor */
 	int verify_source;		/**< Verify the source address of incoming packets against socket::remote. */
@@ -29,6 +36,15 @@ struct Socket {
 
 	Format *formatter;
 
+	struct Timestamping timestamping; /**< Kernel / hardware packet timestamping */
+
+	/* Sharding of a single UDP port across multiple nodes (SO_REUSEPORT) */
+	struct {
+		int enabled;
+		int shards;		/**< Number of nodes which share the local address. */
+		int steering;		/**< Steer packets to shards by their source address. */
+	} reuseport;
+
 	/* Multicast options */
 	struct multicast {
 		int enabled;		/**< Is multicast enabled? */
@@ -42,6 +58,20 @@ struct Socket {
 		size_t buflen;
 		union sockaddr_union saddr;	/**< Remote address of the socket */
 	} in, out;
+
+	/* Memory-mapped receive ring (PACKET_RX_RING with TPACKET_V3) for the eth layer */
+	struct {
+		int enabled;
+		int block_size;		/**< Size of a block in bytes. Must be a multiple of the page size. */
+		int block_count;	/**< Number of blocks in the ring. */
+		int frame_size;		/**< Maximum size of a single frame in bytes. */
+		int timeout;		/**< Timeout in milliseconds after which the kernel retires a partially filled block. */
+
+		char *map;		/**< Memory mapping of the ring */
+		int block;		/**< Index of the block which is currently processed */
+		unsigned remaining;	/**< Number of unprocessed packets in the current block */
+		char *packet;		/**< Next unprocessed packet in the current block */
+	} ring;
 };
 
 
@@ -10,7 +10,7 @@
 
 #include <villas/list.hpp>
 #include <villas/format.hpp>
-#include <villas/task.hpp>
+#include <villas/precision_task.hpp>
 
 namespace villas {
 namespace node {
@@ -33,7 +33,7 @@ struct test_rtt_case {
 };
 
 struct test_rtt {
-	struct Task task;		/**< The periodic task for test_rtt_read() */
+	PrecisionTask task;		/**< The periodic task for test_rtt_read() */
 	Format *formatter;/**< The format of the output file */
 	FILE *stream;
 
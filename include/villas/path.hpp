@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <bitset>
 
 #include <uuid/uuid.h>
@@ -17,9 +18,10 @@
 
 #include <villas/list.hpp>
 #include <villas/queue.h>
+#include <villas/queue_signalled.h>
 #include <villas/pool.hpp>
 #include <villas/common.hpp>
-#include <villas/task.hpp>
+#include <villas/precision_task.hpp>
 #include <villas/node_list.hpp>
 #include <villas/colors.hpp>
 #include <villas/node.hpp>
@@ -27,6 +29,7 @@
 #include <villas/signal_list.hpp>
 #include <villas/mapping_list.hpp>
 #include <villas/path_destination.hpp>
+#include <villas/path_stage.hpp>
 
 #include <villas/log.hpp>
 
@@ -52,6 +55,18 @@ protected:
 	static
 	void * runWrapper(void *arg);
 
+	/** Hook thread of a pipelined path. */
+	void * runHooks();
+
+	static
+	void * runHooksWrapper(void *arg);
+
+	/** Pass samples from the path thread to the hook thread of a pipelined path.
+	 *
+	 * @param flags A bitmask of enum PipelineFlags.
+	 */
+	void pipelinePush(struct Sample * const smps[], unsigned cnt, int flags);
+
 	void startPoll();
 
 	static int id;
@@ -65,7 +80,18 @@ public:
 		ALL				/**< The path is triggered only after all sources have received at least 1 sample. */
 	} mode;					/**< Determines when this path is triggered. */
 
+	/** Flags of samples which are passed to the hook thread of a pipelined path.
+	 *
+	 * They are stored in the lower bits of the cacheline-aligned sample pointers.
+	 */
+	enum class PipelineFlags {
+		PROCESS		= (1 << 0),	/**< Run the hooks of the path on the sample. */
+		FORWARD		= (1 << 1),	/**< Enqueue the sample to the destinations. */
+		MASK		= PROCESS | FORWARD
+	};
+
 	uuid_t uuid;
+	char uuid_string[37];		/**< The UUID as a string. Identifies the path in tracepoints. */
 
 	std::vector<struct pollfd> pfds;
 
@@ -80,7 +106,7 @@ public:
 	HookList hooks;				/**< List of processing hooks. */
 	SignalList::Ptr signals;		/**< List of signals which this path creates. */
 
-	struct Task timeout;
+	PrecisionTask timeout;		/**< Timer for re-sending the last sample at a fixed rate. */
 
 	double rate;			/**< A timeout for */
 	int affinity;			/**< Thread affinity. */
@@ -90,8 +116,18 @@ public:
 	bool builtin;			/**< This path should use built-in hooks by default. */
 	int original_sequence_no;	/**< Use original source sequence number when multiplexing */
 	unsigned queuelen;		/**< The queue length for each path_destination::queue */
+	bool spsc;			/**< Use single-producer single-consumer queues for path destinations. */
+	size_t pool_size;		/**< Initial number of samples in the pool (0 for automatic sizing). */
+	size_t pool_max;		/**< Maximum number of samples to which the pool may grow (0 for automatic sizing). */
+	bool pipelined;			/**< Run hooks and each destination on separate threads. */
 
 	pthread_t tid;			/**< The thread id for this path. */
+	pthread_t hooks_tid;		/**< The thread id of the hook thread of a pipelined path. */
+	std::atomic<bool> hooks_stop;	/**< The hook thread exits once the pipeline has been drained. */
+
+	struct CQueueSignalled pipeline; /**< Samples which are passed from the path thread to the hook thread. */
+	PathStage mux_stage;		/**< Utilisation of the path thread of a pipelined path. */
+	PathStage hooks_stage;		/**< Utilisation of the hook thread of a pipelined path. */
 	json_t *config;			/**< A JSON object containing the configuration of the path. */
 
 	Logger logger;
@@ -153,6 +189,12 @@ public:
 	/** Stop a path. */
 	void stop();
 
+	/** Replace the hooks of a path without stopping it.
+	 *
+	 * @param json A JSON array of hook configurations.
+	 */
+	void replaceHooks(json_t *json);
+
 	/** Get a list of signals which is emitted by the path. */
 	SignalList::Ptr getOutputSignals(bool after_hooks = true);
 
@@ -8,9 +8,15 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 
-#include <villas/queue.h>
+#include <jansson.h>
+
+#include <villas/queue_signalled.h>
+#include <villas/path_stage.hpp>
 
 namespace villas {
 namespace node {
@@ -27,30 +33,145 @@ class PathDestination {
 public:
 	using Ptr = std::shared_ptr<PathDestination>;
 
+	/** Determines what happens to samples for which a destination has no credits left. */
+	enum class OverflowPolicy {
+		DROP_NEWEST,		/**< Discard the new samples. */
+		DROP_OLDEST,		/**< Discard the oldest queued samples to make room (ring semantics). */
+		BLOCK,			/**< Write queued samples to the node until credits become available or the timeout expires. */
+		COALESCE		/**< Keep only the newest sample which did not fit and send it once credits are available. */
+	};
+
+	/** Counters per destination. */
+	struct Counters {
+		std::atomic<uint64_t> enqueued;		/**< Samples which have been queued for the node. */
+		std::atomic<uint64_t> dropped_newest;	/**< Samples which have been discarded on arrival. */
+		std::atomic<uint64_t> dropped_oldest;	/**< Queued samples which have been discarded to make room. */
+		std::atomic<uint64_t> blocked;		/**< Number of times the path blocked on this destination. */
+		std::atomic<uint64_t> timeouts;		/**< Number of times blocking has been given up. */
+		std::atomic<uint64_t> coalesced;	/**< Samples which have been replaced by a newer one. */
+	};
+
 protected:
 	Node *node;
 	Path *path;
 
-	struct CQueue queue;
+	struct CQueueSignalled queue;	/**< Only signalled if the destination is written by its own thread. */
+
+	enum OverflowPolicy policy;
+	unsigned credits;		/**< Maximum number of samples this destination may hold from the path pool. */
+	std::atomic<unsigned> used;	/**< Number of samples currently held by this destination. */
+	double timeout;			/**< Timeout in seconds for OverflowPolicy::BLOCK. */
+	std::atomic<struct Sample *> pending; /**< OverflowPolicy::COALESCE: the newest sample which did not fit. */
+
+	Counters counters;
+
+	bool pipelined;			/**< The destination is written by its own thread. */
+	pthread_t tid;			/**< The writer thread of a pipelined destination. */
+	std::atomic<bool> writer_stop;	/**< The writer thread exits once the queue has been drained. */
+	PathStage stage;		/**< Utilisation of the writer thread. */
+
+	std::mutex credits_mutex;	/**< OverflowPolicy::BLOCK: protects waiting for credits. */
+	std::condition_variable credits_cv; /**< OverflowPolicy::BLOCK: signalled by the writer thread when credits are returned. */
+
+	/** Queue samples for this destination according to its credits and overflow policy. */
+	void enqueue(struct Sample * const smps[], unsigned cnt);
+
+	/** Move the pending coalesced sample into the queue if a credit is available. */
+	void flushPending();
+
+	/** Discard up to \p cnt of the oldest queued samples. */
+	unsigned dropOldest(unsigned cnt);
+
+	/** Write dequeued samples to the node and release them. */
+	int writeSamples(struct Sample *smps[], unsigned cnt);
+
+	/** Write a batch of \p cnt samples which has been pulled for a batch size of \p requested. */
+	int writeBatch(struct Sample *smps[], unsigned requested, unsigned cnt);
+
+	/** Return the credits of \p cnt written samples and wake up a path which blocks on them. */
+	void returnCredits(unsigned cnt);
+
+	/** Writer thread of a pipelined destination. */
+	void * runWriter();
+
+	static
+	void * runWriterWrapper(void *arg);
 
 public:
 	PathDestination(Path *p, Node *n);
 
 	~PathDestination();
 
-	int prepare(int queuelen);
+	/** Parse the overflow settings of a destination.
+	 *
+	 * @param json Either the name of an overflow policy or an object with the settings 'policy', 'credits' and 'timeout'.
+	 */
+	void parse(json_t *json);
+
+	/** Prepare the queue of the destination.
+	 *
+	 * @param queuelen The length of the queue.
+	 * @param spsc Only a single thread enqueues samples.
+	 * @param pipelined The destination is written by its own thread.
+	 */
+	int prepare(int queuelen, bool spsc = false, bool pipelined = false);
 
 	void check();
 
+	/** Start the writer thread of a pipelined destination. */
+	void start();
+
+	/** Stop the writer thread, release the pending sample and log the overflow counters. */
+	void stop();
+
 	static
 	void enqueueAll(class Path *p, const struct Sample * const smps[], unsigned cnt);
 
 	void write();
 
+	json_t * toJson() const;
+
+	unsigned getCredits() const
+	{
+		return credits;
+	}
+
+	/** Get the number of samples which are currently held by this destination. */
+	unsigned getUsed() const
+	{
+		return used.load(std::memory_order_relaxed);
+	}
+
+	const Counters & getCounters() const
+	{
+		return counters;
+	}
+
+	bool isPipelined() const
+	{
+		return pipelined;
+	}
+
+	/** Get the writer thread of a pipelined destination. */
+	pthread_t getThread() const
+	{
+		return tid;
+	}
+
+	const PathStage & getStage() const
+	{
+		return stage;
+	}
+
 	Node * getNode() const
 	{
 		return node;
 	}
+
+	Path * getPath() const
+	{
+		return path;
+	}
 };
 
 using PathDestinationList = std::vector<PathDestination::Ptr>;
@@ -59,6 +59,11 @@ public:
 	{
 		return path;
 	}
+
+	const struct Pool * getPool() const
+	{
+		return &pool;
+	}
 };
 
 using PathSourceList = std::vector<PathSource::Ptr>;
@@ -0,0 +1,82 @@
+/** Utilisation metrics of the stages of a pipelined path.
+ *
+ * @file
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include <jansson.h>
+
+namespace villas {
+namespace node {
+
+/** A stage of a pipelined path which runs on its own thread.
+ *
+ * The counters are only updated by the thread of the stage.
+ * Other threads may read them at any time.
+ */
+struct PathStage {
+	using clock = std::chrono::steady_clock;
+
+	clock::time_point started;		/**< Start of the stage. */
+
+	std::atomic<uint64_t> busy;		/**< Time in ns spent with processing samples. */
+	std::atomic<uint64_t> batches;		/**< Number of processed batches. */
+	std::atomic<uint64_t> samples;		/**< Number of processed samples. */
+	std::atomic<uint64_t> overruns;		/**< Samples which were dropped because the next stage was full. */
+
+	PathStage() :
+		busy(0),
+		batches(0),
+		samples(0),
+		overruns(0)
+	{ }
+
+	void start()
+	{
+		started = clock::now();
+
+		busy = 0;
+		batches = 0;
+		samples = 0;
+		overruns = 0;
+	}
+
+	/** Account a batch of \p cnt samples whose processing started at \p since. */
+	void account(clock::time_point since, unsigned cnt)
+	{
+		auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - since).count();
+
+		busy.store(busy.load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+		batches.store(batches.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		samples.store(samples.load(std::memory_order_relaxed) + cnt, std::memory_order_relaxed);
+	}
+
+	/** Get the fraction of time the stage was busy since it has been started. */
+	double getUtilisation() const
+	{
+		auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - started).count();
+
+		return elapsed > 0 ? (double) busy / elapsed : 0;
+	}
+
+	json_t * toJson() const
+	{
+		return json_pack("{ s: f, s: I, s: I, s: I }",
+			"utilisation", getUtilisation(),
+			"batches", (json_int_t) batches,
+			"samples", (json_int_t) samples,
+			"overruns", (json_int_t) overruns
+		);
+	}
+};
+
+} /* namespace node */
+} /* namespace villas */
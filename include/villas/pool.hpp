@@ -10,9 +10,12 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstddef>
 #include <sys/types.h>
 
+#include <jansson.h>
+
 #include <villas/queue.h>
 #include <villas/common.hpp>
 #include <villas/node/memory.hpp>
@@ -20,7 +23,25 @@
 namespace villas {
 namespace node {
 
-/** A thread-safe memory pool */
+/** Maximum number of chunks by which an elastic pool can grow */
+#define POOL_MAX_CHUNKS		32
+
+/** Number of seconds with low usage after which an elastic pool releases a chunk */
+#define POOL_SHRINK_DELAY	10
+
+/** Interval in milliseconds at which elastic pools are resized */
+#define POOL_MAINTAIN_INTERVAL	100
+
+/** A thread-safe memory pool
+ *
+ * An elastic pool starts with an initial memory area and grows by whole chunks
+ * from the same memory type whenever it is running out of free blocks.
+ * Existing blocks are never moved. Chunks are released again, if the usage of
+ * the pool stays low for POOL_SHRINK_DELAY seconds.
+ *
+ * Getting and putting blocks never allocates or releases memory.
+ * Instead, elastic pools are resized by a housekeeping thread (see pool_maintain()).
+ */
 struct Pool {
 	enum State state;
 
@@ -31,6 +52,24 @@ struct Pool {
 	size_t alignment;	/**< Alignment of a block in bytes */
 
 	struct CQueue queue; /**< The queue which is used to keep track of free blocks */
+
+	/* Elastic growth */
+	struct memory::Type *mem;	/**< Memory type for additional chunks (only valid in the process which created the pool) */
+	size_t blocks;			/**< Number of blocks in the initial memory area */
+	size_t chunk_blocks;		/**< Number of blocks per additional chunk */
+	size_t max_chunks;		/**< Maximum number of additional chunks (0 for a static pool) */
+	std::atomic<size_t> chunks;	/**< Number of currently allocated additional chunks */
+	std::atomic<bool> resizing;	/**< A chunk is currently being added or released */
+	std::atomic<bool> starved;	/**< A request could not be satisfied since the last maintenance */
+	std::atomic<uint64_t> low_since; /**< Monotonic time in ns since which the usage is low (0 if not) */
+	off_t chunk_off[POOL_MAX_CHUNKS]; /**< Offsets from the struct address to the additional chunks */
+
+	/* Usage statistics */
+	std::atomic<size_t> used;	/**< Number of blocks which are currently handed out */
+	std::atomic<size_t> high_water;	/**< Highest number of blocks which have been handed out at once */
+	std::atomic<size_t> underruns;	/**< Number of requests which could not be satisfied */
+	std::atomic<size_t> grows;	/**< Number of chunks which have been added */
+	std::atomic<size_t> shrinks;	/**< Number of chunks which have been released */
 };
 
 #define pool_buffer(p) ((char *) (p) + (p)->buffer_off)
@@ -46,6 +85,48 @@ struct Pool {
  */
 int pool_init(struct Pool *p, size_t cnt, size_t blocksz, struct memory::Type *mem = memory::default_type) __attribute__ ((warn_unused_result));
 
+/** Initialize an elastic pool
+ *
+ * The pool reserves \p cnt blocks upfront and grows on demand up to \p max blocks.
+ * It is resized by the housekeeping thread until it is destroyed.
+ * Memory types which do not support additional allocations for the same pool
+ * (e.g. InfiniBand or managed memory) fall back to a static pool of \p cnt blocks.
+ *
+ * @param[inout] p The pool data structure.
+ * @param[in] cnt The number of blocks which are reserved initially.
+ * @param[in] max The maximum number of blocks to which the pool may grow.
+ * @param[in] blocksz The size in bytes per block.
+ * @param[in] mem The type of memory which should be used for this pool.
+ * @retval 0 The pool has been successfully initialized.
+ * @retval <>0 There was an error during the pool initialization.
+ */
+int pool_init_elastic(struct Pool *p, size_t cnt, size_t max, size_t blocksz, struct memory::Type *mem = memory::default_type) __attribute__ ((warn_unused_result));
+
+/** Resize an elastic pool.
+ *
+ * The pool grows by one or more chunks if a request could not be satisfied or if more
+ * than three quarters of its blocks are in use. It releases its most recently added chunk
+ * after sustained low usage.
+ *
+ * This is called every POOL_MAINTAIN_INTERVAL milliseconds by a housekeeping thread
+ * for all elastic pools of the process. It must not be called from realtime threads.
+ */
+void pool_maintain(struct Pool *p);
+
+/** Parse the size of a pool from a JSON object.
+ *
+ * The configuration is either a single integer for the initial size
+ * or an object with the settings 'size' and 'max'.
+ * Values which are not given in the configuration are left untouched.
+ */
+void pool_parse(json_t *json, size_t *cnt, size_t *max);
+
+/** Get the current capacity of the pool in blocks. */
+size_t pool_capacity(const struct Pool *p);
+
+/** Get the sizes and usage statistics of the pool as a JSON object. */
+json_t * pool_to_json(const struct Pool *p);
+
 /** Destroy and release memory used by pool. */
 int pool_destroy(struct Pool *p) __attribute__ ((warn_unused_result));
 
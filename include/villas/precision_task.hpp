@@ -0,0 +1,109 @@
+/** High-precision periodic task with hybrid sleep/spin waiting
+ *
+ * @file
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+
+#include <jansson.h>
+
+#include <villas/hist.hpp>
+#include <villas/log.hpp>
+
+#define PRECISION_TASK_JITTER_BUCKETS	20
+#define PRECISION_TASK_JITTER_WARMUP	500
+
+namespace villas {
+namespace node {
+
+/** A periodic task which is a drop-in replacement for struct Task.
+ *
+ * The timerfd fires `slack` seconds before each deadline.
+ * The slack is limited to the period of the task.
+ * The remaining time is spent spinning on the clock in wait().
+ * This trades CPU time for a wakeup accuracy in the order of microseconds,
+ * which is required for fixed-rate loops of several kHz on isolated cores.
+ *
+ * With a slack of zero, the task behaves like struct Task.
+ */
+class PrecisionTask {
+
+protected:
+	int clock;		/**< The clock used for the timerfd and for spinning. */
+	int fd;			/**< The timerfd which fires `slack` seconds before the deadline. */
+
+	double slack;		/**< Time in seconds which is spent spinning before each deadline. */
+
+	struct timespec period;	/**< The period of the task (zero for one-shot timeouts). */
+	struct timespec next;	/**< The next deadline. */
+
+	uint64_t overruns;	/**< Total number of missed periods. */
+	Hist jitter;		/**< Histogram of the difference between the actual wakeup and the deadline in seconds. */
+
+	/** Arm the timerfd for the next deadline. */
+	void arm();
+
+	struct timespec now() const;
+
+public:
+	PrecisionTask(int clock = CLOCK_MONOTONIC);
+
+	~PrecisionTask();
+
+	/** Parse timer settings.
+	 *
+	 * Accepts an object with the setting "slack" in seconds.
+	 */
+	void parse(json_t *json);
+
+	/** Wait until the next deadline.
+	 *
+	 * @return The number of periods which have elapsed since the last call.
+	 */
+	uint64_t wait();
+
+	void setNext(const struct timespec *next);
+
+	void setRate(double rate);
+
+	void setTimeout(double to);
+
+	void setSlack(double s)
+	{
+		slack = s;
+	}
+
+	double getSlack() const
+	{
+		return slack;
+	}
+
+	void stop();
+
+	int getFD() const
+	{
+		return fd;
+	}
+
+	uint64_t getOverruns() const
+	{
+		return overruns;
+	}
+
+	const Hist & getJitter() const
+	{
+		return jitter;
+	}
+
+	/** Print overrun counter and jitter histogram. */
+	void printStats(Logger logger) const;
+};
+
+} /* namespace node */
+} /* namespace villas */
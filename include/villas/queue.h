@@ -53,10 +53,23 @@ struct CQueue_cell {
 	off_t data_off; /**< Pointer relative to the queue struct */
 };
 
-/** A lock-free multiple-producer, multiple-consumer (MPMC) queue. */
+enum class QueueFlags {
+	SPSC		= (1 << 0)	/**< The queue is only accessed by a single producer and a single consumer thread. */
+};
+
+/** A lock-free multiple-producer, multiple-consumer (MPMC) queue.
+ *
+ * If initialized with QueueFlags::SPSC, the queue falls back to a
+ * single-producer, single-consumer ring which does not require
+ * compare-and-swap operations. Instead, producer and consumer only
+ * publish their indices with release stores and keep a cached copy
+ * of the other side's index.
+ */
 struct CQueue {
 	std::atomic<enum State> state;
 
+	int flags;
+
 	cacheline_pad_t _pad0;	/**< Shared area: all threads read */
 
 	size_t buffer_mask;
@@ -65,16 +78,21 @@ struct CQueue {
 	cacheline_pad_t	_pad1;	/**< Producer area: only producers read & write */
 
 	std::atomic<size_t>	tail;	/**< Queue tail pointer */
+	size_t head_cache;		/**< SPSC: Cached copy of the head pointer */
 
 	cacheline_pad_t	_pad2;	/**< Consumer area: only consumers read & write */
 
 	std::atomic<size_t>	head;	/**< Queue head pointer */
+	size_t tail_cache;		/**< SPSC: Cached copy of the tail pointer */
 
 	cacheline_pad_t	_pad3;	/**< @todo Why needed? */
 };
 
-/** Initialize MPMC queue */
-int queue_init(struct CQueue *q, size_t size, struct memory::Type *mem = memory::default_type) __attribute__ ((warn_unused_result));
+/** Initialize MPMC queue
+ *
+ * @param flags A bitmask of enum QueueFlags.
+ */
+int queue_init(struct CQueue *q, size_t size, struct memory::Type *mem = memory::default_type, int flags = 0) __attribute__ ((warn_unused_result));
 
 /** Desroy MPMC queue and release memory */
 int queue_destroy(struct CQueue *q) __attribute__ ((warn_unused_result));
@@ -91,6 +109,9 @@ int queue_push(struct CQueue *q, void *ptr);
 int queue_pull(struct CQueue *q, void **ptr);
 
 /** Enqueue up to \p cnt pointers of the \p ptr array into the queue.
+ *
+ * A contiguous range of free cells is reserved with a single CAS on the tail
+ * pointer. Hence, the synchronization cost is amortized over the whole batch.
  *
  * @return The number of pointers actually enqueued.
  *         This number can be smaller then \p cnt in case the queue is filled.
@@ -98,6 +119,9 @@ int queue_pull(struct CQueue *q, void **ptr);
 int queue_push_many(struct CQueue *q, void *ptr[], size_t cnt);
 
 /** Dequeue up to \p cnt pointers from the queue and place them into the \p ptr array.
+ *
+ * A contiguous range of published cells is reserved with a single CAS on the head
+ * pointer. Hence, the synchronization cost is amortized over the whole batch.
  *
  * @return The number of pointers actually dequeued.
  *         This number can be smaller than \p cnt in case the queue contained less than
@@ -26,6 +26,7 @@ enum class QueueSignalledMode {
 #endif
 };
 
+/** The lower bits are reserved for enum QueueFlags which are passed to the underlying queue. */
 enum class QueueSignalledFlags {
 	PROCESS_SHARED	= (1 << 4)
 };
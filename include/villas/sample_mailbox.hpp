@@ -0,0 +1,138 @@
+/** A latest-value mailbox for signals.
+ *
+ * @file
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <ctime>
+#include <pthread.h>
+
+#include <villas/signal_data.hpp>
+#include <villas/signal_list.hpp>
+
+namespace villas {
+namespace node {
+
+/* Forward declarations */
+struct Sample;
+
+/** Holds the latest value of each signal.
+ *
+ * Writers are serialized and publish new values under a sequence lock.
+ * Readers never block writers: they copy the values and retry if a
+ * writer modified them concurrently.
+ *
+ * Each signal carries the sequence number of its last change so that
+ * subscribers can pick up only the signals which changed since they
+ * have last looked.
+ */
+class SampleMailbox {
+
+public:
+	using Ptr = std::shared_ptr<SampleMailbox>;
+
+	struct Value {
+		unsigned index;
+		union SignalData data;
+	};
+
+protected:
+	SignalList::Ptr signals;
+
+	std::vector<union SignalData> data;
+	std::vector<uint64_t> versions;		/**< Sequence number of the last change per signal. */
+	struct timespec ts;
+	unsigned length;
+
+	std::atomic<uint64_t> sequence;		/**< Incremented by two per update. Odd while an update is in progress. */
+	std::mutex writer;			/**< Serializes writers. Readers never lock. */
+
+	/* Only used to block in wait() */
+	std::atomic<int> waiters;
+	pthread_mutex_t mutex;
+	pthread_cond_t cv;
+
+	uint64_t begin();
+	void commit(uint64_t seq);
+
+	/** Run a reader until it got a consistent copy. */
+	template<typename F>
+	uint64_t read(F f) const
+	{
+		for (;;) {
+			uint64_t seq = sequence.load(std::memory_order_acquire);
+			if (seq & 1)
+				continue;
+
+			f();
+
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (sequence.load(std::memory_order_relaxed) == seq)
+				return seq;
+		}
+	}
+
+	static
+	void waitCleanup(void *arg);
+
+public:
+	SampleMailbox(SignalList::Ptr sigs, unsigned capacity = 0);
+	~SampleMailbox();
+
+	/** Publish all values of a sample.
+	 *
+	 * Only values which differ from the previous ones are marked as changed.
+	 */
+	void put(const struct Sample *smp);
+
+	/** Publish several values at once. */
+	void put(const std::vector<Value> &values, const struct timespec *ts);
+
+	/** Get a consistent copy of all values.
+	 *
+	 * @return The sequence number of the copy.
+	 */
+	uint64_t get(struct Sample *smp) const;
+
+	/** Get the value of a single signal. */
+	uint64_t get(unsigned index, union SignalData *d, struct timespec *t) const;
+
+	/** Get the values of all signals. */
+	uint64_t getAll(std::vector<Value> &values, struct timespec *t) const;
+
+	/** Get the values of all signals which changed after sequence number since. */
+	uint64_t getChanged(uint64_t since, std::vector<Value> &values, struct timespec *t) const;
+
+	/** Block until the mailbox has been updated after sequence number since.
+	 *
+	 * This function is a cancellation point.
+	 */
+	void wait(uint64_t since);
+
+	uint64_t getSequence() const
+	{
+		return sequence.load(std::memory_order_acquire);
+	}
+
+	SignalList::Ptr getSignals() const
+	{
+		return signals;
+	}
+
+	unsigned getCapacity() const
+	{
+		return data.size();
+	}
+};
+
+} /* namespace node */
+} /* namespace villas */
@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <atomic>
+
 #include <villas/pool.hpp>
 #include <villas/queue.h>
 #include <villas/queue_signalled.h>
@@ -16,6 +18,8 @@
 #define DEFAULT_SHMEM_QUEUELEN	512u
 #define DEFAULT_SHMEM_SAMPLELEN	64u
 
+#define SHMEM_BROADCAST_MAGIC	0x56424331u /* "VBC1" */
+
 namespace villas {
 namespace node {
 
@@ -105,5 +109,134 @@ int shmem_int_alloc(struct ShmemInterface *shm, struct Sample *smps[], unsigned
  * per struct Sample. */
 size_t shmem_total_size(int queuelen, int samplelen);
 
+/** A slot of a broadcast ring.
+ *
+ * The stamp is odd while the writer updates the slot and 2 * (pos + 1)
+ * once the sample at ring position pos has been published.
+ */
+struct ShmemBroadcastSlot {
+	std::atomic<uint64_t> stamp;
+	uint64_t sequence;
+	struct timespec ts_origin;
+	struct timespec ts_received;
+	int flags;
+	unsigned length;
+	union SignalData data[];
+};
+
+/** The header of a broadcast ring which resides in the shared memory.
+ *
+ * It is followed by the latest-value slot and the ring slots.
+ * All offsets are relative, so every process may map the region at a different address.
+ */
+struct ShmemBroadcastShared {
+	uint32_t magic;			/**< SHMEM_BROADCAST_MAGIC once the writer has initialized the ring. */
+	unsigned slots;			/**< Number of slots in the ring (power of two). */
+	unsigned samplelen;		/**< Maximum number of values per slot. */
+	size_t slotsz;			/**< Size of a slot in bytes. */
+	int polling;			/**< Whether readers have to poll instead of waiting on ShmemBroadcastShared::notify. */
+	std::atomic<int> closed;	/**< Set by the writer when it detaches. */
+
+	cacheline_pad_t _pad0;		/**< Writer area: only the writer writes */
+
+	std::atomic<uint64_t> head;	/**< Number of samples published so far. */
+	std::atomic<uint32_t> notify;	/**< Futex which is incremented and woken up after each write and on close. */
+
+	cacheline_pad_t _pad1;
+
+	std::atomic<uint64_t> latest;	/**< Seqlock of the latest-value slot: odd while it is updated. */
+
+	cacheline_pad_t _pad2;
+};
+
+/** One endpoint of a single-writer, multi-reader broadcast ring.
+ *
+ * The writer never waits for readers. Each reader keeps its own cursor
+ * and detects overruns if the writer has overwritten samples which it
+ * has not consumed yet.
+ */
+struct ShmemBroadcast {
+	const char *name;
+	void *base;			/**< Base address of the mapping. */
+	size_t len;			/**< Total size of the mapping. */
+	bool writer;
+	struct ShmemBroadcastShared *shared;
+
+	uint64_t cursor;		/**< Reader: ring position of the next sample to read. */
+	uint64_t latest;		/**< Reader: seqlock version of the last sample returned by shmem_bcast_latest(). */
+	uint64_t overruns;		/**< Reader: number of samples which have been overwritten before they were read. */
+	uint32_t notified;		/**< Reader: value of ShmemBroadcastShared::notify before the last read. */
+};
+
+/** Create a broadcast ring and attach to it as its only writer.
+ *
+ * An existing object of the same name is replaced.
+ *
+ * @param slots Number of samples in the ring. Rounded up to the next power of two.
+ * @param samplelen Maximum number of values per sample.
+ * @param polling Do not wake up readers which are blocked in shmem_bcast_wait().
+ * @retval 0 Success.
+ * @retval <0 An error occured; errno is set accordingly.
+ */
+int shmem_bcast_create(const char *name, struct ShmemBroadcast *b, unsigned slots, unsigned samplelen, bool polling = false);
+
+/** Attach to an existing broadcast ring as a reader.
+ *
+ * Readers only map the ring read-only and never influence the writer.
+ *
+ * @param oldest Start with the oldest sample still in the ring instead of the next published one.
+ * @retval 0 Success.
+ * @retval <0 An error occured; errno is set accordingly.
+ */
+int shmem_bcast_attach(const char *name, struct ShmemBroadcast *b, bool oldest = false);
+
+/** Detach from a broadcast ring. The writer also unlinks the shared memory object. */
+int shmem_bcast_close(struct ShmemBroadcast *b);
+
+/** Publish samples to all readers.
+ *
+ * The values of the samples are copied into the ring. Values beyond the
+ * sample length of the ring are truncated. The last sample is also copied
+ * into the latest-value slot.
+ *
+ * @return The number of published samples.
+ */
+int shmem_bcast_write(struct ShmemBroadcast *b, const struct Sample * const smps[], unsigned cnt);
+
+/** Copy up to \p cnt samples following the cursor of a reader.
+ *
+ * If the reader lags behind by more than the ring size, its cursor is moved
+ * to the oldest sample in the ring and the missed samples are added to
+ * ShmemBroadcast::overruns.
+ *
+ * @retval >=0 Number of samples that were read. Can be 0 if no new samples are available.
+ * @retval -1 The writer has closed the ring and all samples have been read.
+ */
+int shmem_bcast_read(struct ShmemBroadcast *b, struct Sample * const smps[], unsigned cnt);
+
+/** Copy the most recently published sample if it has changed since the last call.
+ *
+ * @retval 1 A new sample has been copied.
+ * @retval 0 No sample has been published since the last call.
+ * @retval -1 The writer has closed the ring.
+ */
+int shmem_bcast_latest(struct ShmemBroadcast *b, struct Sample *smp);
+
+/** Block a reader until the writer publishes new samples or closes the ring.
+ *
+ * Must be called after shmem_bcast_read() or shmem_bcast_latest() returned 0.
+ * Returns immediately if samples have been published in the meantime
+ * or if the writer has created the ring in polling mode.
+ *
+ * @param timeout Maximum relative time to wait or nullptr to wait forever.
+ * @retval 0 The writer has published samples or the timeout expired.
+ * @retval <0 An error occured; errno is set accordingly.
+ */
+int shmem_bcast_wait(struct ShmemBroadcast *b, const struct timespec *timeout = nullptr);
+
+/** Returns the total size of a broadcast ring with the given number of slots
+ * and data elements per sample. */
+size_t shmem_bcast_total_size(unsigned slots, unsigned samplelen);
+
 } /* namespace node */
 } /* namespace villas */
@@ -10,6 +10,9 @@
 
 #include <list>
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include <jansson.h>
 
@@ -21,6 +24,21 @@ namespace node {
 
 class SignalList : public std::vector<Signal::Ptr> {
 
+protected:
+	/** Maps signal names to the index of their first occurrence. */
+	struct NameIndex {
+		size_t length;				/**< Size of the list when the index was built. */
+		std::unordered_map<std::string, unsigned> indices;
+	};
+
+	/** Built on the first lookup and shared by clones of the list.
+	 *
+	 * The index itself is never modified. It is replaced as a whole
+	 * so that concurrent lookups are safe. */
+	mutable std::shared_ptr<const NameIndex> index;
+
+	std::shared_ptr<const NameIndex> getIndex(bool rebuild = false) const;
+
 public:
 	using Ptr = std::shared_ptr<SignalList>;
 
@@ -38,9 +56,18 @@ public:
 
 	json_t * toJson() const;
 
-	int getIndexByName(const std::string &name);
-	Signal::Ptr getByName(const std::string &name);
+	/** Get the index of the first signal with the given name.
+	 *
+	 * Falls back to a linear search if the name is not found in the index.
+	 *
+	 * @retval -1 There is no signal with this name.
+	 */
+	int getIndexByName(const std::string &name) const;
+	Signal::Ptr getByName(const std::string &name) const;
 	Signal::Ptr getByIndex(unsigned idx);
+
+	/** Discard the name index after signals have been inserted, removed or renamed. */
+	void invalidateIndex();
 };
 
 } /* namespace node */
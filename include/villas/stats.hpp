@@ -51,6 +51,11 @@ public:
 		OWD,			/**< Histogram for one-way-delay (OWD) of received samples. */
 		AGE,			/**< Processing time of packets within VILLASnode. */
 		SIGNAL_COUNT,		/**< Number of signals per sample. */
+		TX_DELAY,		/**< Delay between passing a packet to the kernel and its transmit timestamp. */
+
+		/* Batching */
+		BATCH_IN,		/**< Number of samples per read (adaptive vectorization only). */
+		BATCH_OUT,		/**< Number of samples per write (adaptive vectorization only). */
 
 		/* RTP metrics */
 		RTP_LOSS_FRACTION,	/**< Fraction lost since last RTP SR/RR. */
@@ -16,7 +16,10 @@ extern "C" {
 }
 #endif
 
+#include <atomic>
 #include <fstream>
+#include <map>
+#include <mutex>
 
 #include <villas/api.hpp>
 #include <villas/web.hpp>
@@ -26,6 +29,7 @@ extern "C" {
 #include <villas/node_list.hpp>
 #include <villas/path_list.hpp>
 #include <villas/task.hpp>
+#include <villas/clock.hpp>
 #include <villas/common.hpp>
 #include <villas/kernel/if.hpp>
 
@@ -61,6 +65,7 @@ protected:
 	int affinity;		/**< Process affinity of the server and all created threads */
 	int hugepages;		/**< Number of hugepages to reserve. */
 	double statsRate;	/**< Rate at which we display the periodic stats. */
+	enum ClockSource clockSource;	/**< Clock source for sample timestamps and statistics. */
 
 	struct Task task;	/**< Task for periodic stats output */
 
@@ -72,6 +77,30 @@ protected:
 
 	Config config;		/** The configuration file. */
 
+	std::mutex mutex;			/**< Serializes reloads with the periodic tasks. */
+	std::atomic<bool> reloadPending;	/**< A reload of the configuration file has been requested. */
+	std::atomic<uint64_t> generation;	/**< Incremented whenever the running configuration changes. */
+
+	json_t *pristine;			/**< Unparsed copy of the running configuration. */
+	std::list<json_t *> retired;		/**< Previous configurations which are still referenced by nodes and paths. */
+	std::map<Path *, size_t> pathIndices;	/**< Index of each path in the 'paths' array of the configuration. */
+
+	/** Create a node from its configuration. */
+	Node * parseNode(const std::string &name, json_t *json_node);
+
+	/** Create a path and its reversed counterpart from its configuration.
+	 *
+	 * @param json_path The configuration of the path.
+	 * @param ns The nodes which the path may refer to.
+	 */
+	std::list<Path *> parsePath(json_t *json_path, NodeList &ns);
+
+	/** Parse and check a complete configuration with throwaway nodes and paths.
+	 *
+	 * The running nodes and paths are not touched.
+	 */
+	void validate(json_t *root);
+
 public:
 	/** Inititalize configuration object before parsing the configuration. */
 	SuperNode();
@@ -96,6 +125,30 @@ public:
 	void stop();
 	void run();
 
+	/** Apply a new configuration to the running super node.
+	 *
+	 * Only nodes and paths which are affected by the changes are stopped and rebuilt.
+	 * All other nodes and paths keep running. Changes of settings outside of
+	 * 'nodes' and 'paths' require a full restart and are not applied.
+	 *
+	 * @param root The new configuration. Its reference count is incremented.
+	 * @param dryRun Only report what would be restarted.
+	 * @return A JSON object describing the changes.
+	 */
+	json_t * reload(json_t *root, bool dryRun = false);
+
+	/** Wrapper for reload() which loads the config first. */
+	json_t * reload(const std::string &u, bool dryRun = false);
+
+	/** Reload the configuration file in the main loop.
+	 *
+	 * This function is async-signal-safe.
+	 */
+	void requestReload()
+	{
+		reloadPending = true;
+	}
+
 	void preparePaths();
 	void prepareNodes();
 	void prepareNodeTypes();
@@ -180,6 +233,24 @@ public:
 		return uri;
 	}
 
+	/** Get the generation of the running configuration.
+	 *
+	 * It changes whenever a reload has been applied.
+	 */
+	uint64_t getGeneration() const
+	{
+		return generation;
+	}
+
+	/** Get the mutex which serializes reloads with the periodic tasks.
+	 *
+	 * Other threads must hold it while they walk the running nodes and paths.
+	 */
+	std::mutex & getMutex()
+	{
+		return mutex;
+	}
+
 	int getAffinity() const
 	{
 		return affinity;
@@ -0,0 +1,80 @@
+/** Kernel and hardware packet timestamping (SO_TIMESTAMPING)
+ *
+ * @file
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include <sys/types.h>
+#include <sys/socket.h>
+
+#include <jansson.h>
+
+namespace villas {
+namespace node {
+
+/** Number of transmitted packets for which we keep track of the user space send time */
+#define TIMESTAMPING_TX_SLOTS 64
+
+enum class TimestampingMode {
+	NONE,		/**< Timestamps are taken in user space after the packet has been read. */
+	SOFTWARE,	/**< Timestamps are taken by the kernel when the packet passes the network stack. */
+	HARDWARE	/**< Timestamps are taken by the NIC in the time domain of its PTP hardware clock (PHC). */
+};
+
+struct Timestamping {
+	enum TimestampingMode mode;
+	int tx;				/**< Request transmit timestamps via the socket error queue. */
+
+	uint32_t tx_id;			/**< Id of the next transmitted packet (SOF_TIMESTAMPING_OPT_ID). */
+	struct timespec tx_sent[TIMESTAMPING_TX_SLOTS]; /**< User space send time of the last transmitted packets. */
+};
+
+/** Parse the timestamping settings of a node.
+ *
+ * Accepts either a string with the mode ("none", "software" or "hardware")
+ * or an object with the settings "mode" and "tx".
+ */
+int timestamping_parse(struct Timestamping *t, json_t *json);
+
+/** Enable timestamping for a socket.
+ *
+ * @param sd The socket descriptor.
+ * @param ifname The name of the interface for which hardware timestamping should be enabled (may be nullptr).
+ * @retval 0 Success. Everything went well.
+ * @retval <0 Error. Something went wrong.
+ */
+int timestamping_start(struct Timestamping *t, int sd, const char *ifname = nullptr);
+
+/** Receive a packet and its kernel/hardware receive timestamp via recvmsg(2).
+ *
+ * @param ts The receive timestamp of the packet. Zeroed if the kernel did not provide one.
+ * @return The number of bytes received or -1 on error (see recvfrom(2)).
+ */
+ssize_t timestamping_recv(struct Timestamping *t, int sd, void *buf, size_t len, int flags, struct sockaddr *src, socklen_t *srclen, struct timespec *ts);
+
+/** Remember the user space time at which a packet has been passed to the kernel.
+ *
+ * Must be called once for each successfully transmitted packet.
+ *
+ * @param ts The time right before the packet has been passed to send(2).
+ */
+void timestamping_sent(struct Timestamping *t, const struct timespec *ts);
+
+/** Collect pending transmit timestamps from the socket error queue.
+ *
+ * @param delays An array which is filled with the delays between the user space
+ *               send time and the transmit timestamp of the kernel/NIC in seconds.
+ * @return The number of delays stored in \p delays.
+ */
+int timestamping_tx_delays(struct Timestamping *t, int sd, double delays[], unsigned cnt);
+
+const char * timestamping_mode_str(enum TimestampingMode mode);
+
+} /* namespace node */
+} /* namespace villas */
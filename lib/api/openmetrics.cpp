@@ -0,0 +1,121 @@
+/** Writer for the OpenMetrics text format.
+ *
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+#include <cmath>
+#include <iterator>
+
+#include <villas/api/openmetrics.hpp>
+
+using namespace villas;
+using namespace villas::node::api;
+
+void OpenMetricsWriter::clear()
+{
+	/* Keeps the capacity of the buffer */
+	buffer.clear();
+
+	family = nullptr;
+}
+
+void OpenMetricsWriter::addFamily(const char *name, Type t, const char *help, const char *unit)
+{
+	family = name;
+	type = t;
+
+	auto out = std::back_inserter(buffer);
+
+	fmt::format_to(out, "# TYPE {} {}\n", name, t == Type::COUNTER ? "counter" : "gauge");
+
+	if (unit)
+		fmt::format_to(out, "# UNIT {} {}\n", name, unit);
+
+	fmt::format_to(out, "# HELP {} {}\n", name, help);
+}
+
+void OpenMetricsWriter::write(std::string_view str)
+{
+	buffer.append(str.data(), str.data() + str.size());
+}
+
+void OpenMetricsWriter::writeEscaped(std::string_view value)
+{
+	for (char c : value) {
+		switch (c) {
+			case '\\':
+				write("\\\\");
+				break;
+
+			case '"':
+				write("\\\"");
+				break;
+
+			case '\n':
+				write("\\n");
+				break;
+
+			default:
+				buffer.push_back(c);
+		}
+	}
+}
+
+void OpenMetricsWriter::writeSampleName(Labels labels)
+{
+	write(family);
+
+	if (type == Type::COUNTER)
+		write("_total");
+
+	if (labels.size() == 0)
+		return;
+
+	char sep = '{';
+	for (auto &l : labels) {
+		buffer.push_back(sep);
+		write(l.first);
+		write("=\"");
+		writeEscaped(l.second);
+		buffer.push_back('"');
+
+		sep = ',';
+	}
+
+	buffer.push_back('}');
+}
+
+void OpenMetricsWriter::writeValue(double value)
+{
+	if (std::isnan(value))
+		write("NaN");
+	else if (std::isinf(value))
+		write(value > 0 ? "+Inf" : "-Inf");
+	else
+		fmt::format_to(std::back_inserter(buffer), "{}", value);
+}
+
+void OpenMetricsWriter::addSample(Labels labels, double value)
+{
+	writeSampleName(labels);
+
+	buffer.push_back(' ');
+	writeValue(value);
+	buffer.push_back('\n');
+}
+
+void OpenMetricsWriter::addSample(Labels labels, uint64_t value)
+{
+	writeSampleName(labels);
+
+	fmt::format_to(std::back_inserter(buffer), " {}\n", value);
+}
+
+void OpenMetricsWriter::finish(Buffer &body)
+{
+	write("# EOF\n");
+
+	body.append(buffer.data(), buffer.size());
+}
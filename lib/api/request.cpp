@@ -9,6 +9,7 @@
 #include <villas/plugin.hpp>
 #include <villas/api.hpp>
 #include <villas/api/request.hpp>
+#include <villas/api/router.hpp>
 
 using namespace villas;
 using namespace villas::node::api;
@@ -29,16 +30,23 @@ Request * RequestFactory::create(Session *s, const std::string &uri, Session::Me
 {
 	s->logger->info("Lookup request handler for: uri={}", uri);
 
-	for (auto *rf : plugin::registry->lookup<RequestFactory>()) {
-		std::smatch mr;
-		if (not rf->match(uri, mr))
-			continue;
+	/* All request plugins have been registered during static initialization */
+	static Router router = []() {
+		Router r;
 
-		auto *p = rf->make(s);
+		for (auto *rf : plugin::registry->lookup<RequestFactory>())
+			r.add(rf->getPattern(), rf);
+
+		return r;
+	}();
 
-		for (auto m : mr)
-			p->matches.push_back(m.str());
+	std::vector<std::string> matches;
+
+	auto *rf = router.lookup(uri, matches);
+	if (rf) {
+		auto *p = rf->make(s);
 
+		p->matches = matches;
 		p->factory = rf;
 		p->method = meth;
 		p->contentLength = ct;
@@ -18,6 +18,11 @@ class CapabilitiesRequest : public Request {
 public:
 	using Request::Request;
 
+	virtual bool isCacheable() const
+	{
+		return true;
+	}
+
 	virtual Response * execute()
 	{
 		if (method != Session::Method::GET)
@@ -19,6 +19,11 @@ class ConfigRequest : public Request {
 public:
 	using Request::Request;
 
+	virtual bool isCacheable() const
+	{
+		return true;
+	}
+
 	virtual Response * execute()
 	{
 		json_t *json = session->getSuperNode()->getConfig();
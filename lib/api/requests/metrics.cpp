@@ -0,0 +1,350 @@
+/** The "metrics" API request.
+ *
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+#include <ctime>
+#include <mutex>
+
+#include <pthread.h>
+#include <uuid/uuid.h>
+
+#include <villas/node.hpp>
+#include <villas/path.hpp>
+#include <villas/path_source.hpp>
+#include <villas/path_destination.hpp>
+#include <villas/pool.hpp>
+#include <villas/stats.hpp>
+#include <villas/super_node.hpp>
+#include <villas/timing.hpp>
+#include <villas/api.hpp>
+#include <villas/api/session.hpp>
+#include <villas/api/request.hpp>
+#include <villas/api/response.hpp>
+#include <villas/api/openmetrics.hpp>
+
+namespace villas {
+namespace node {
+namespace api {
+
+/** Takes over the exposition without copying it a second time. */
+class MetricsResponse : public Response {
+
+public:
+	MetricsResponse(Session *s, OpenMetricsWriter &w) :
+		Response(s, HTTP_STATUS_OK, OpenMetricsWriter::getContentType())
+	{
+		w.finish(buffer);
+	}
+};
+
+/** Exports the metrics of all nodes and paths in the OpenMetrics text format.
+ *
+ * The nodes and paths are walked while holding the mutex of the super node
+ * so that they can not be stopped or removed by a reload in the meantime.
+ */
+class MetricsRequest : public Request {
+
+protected:
+	using Type = OpenMetricsWriter::Type;
+
+	SuperNode *sn;
+	OpenMetricsWriter *w;
+
+	/** Path ids are used as label values. */
+	struct PathId {
+		char str[37];
+
+		PathId(const Path *p)
+		{
+			uuid_unparse_lower(p->uuid, str);
+		}
+	};
+
+	/** Get the CPU time consumed by a thread in seconds or a negative value if it is not running. */
+	static
+	double getThreadTime(pthread_t tid)
+	{
+		clockid_t cid;
+		struct timespec ts;
+
+		if (pthread_getcpuclockid(tid, &cid) || clock_gettime(cid, &ts))
+			return -1;
+
+		return time_to_double(&ts);
+	}
+
+	void addNodeStats()
+	{
+		w->addFamily("villas_node_stats", Type::GAUGE, "Statistics of the samples which have been received and sent by a node.");
+
+		for (auto *n : sn->getNodes()) {
+			auto stats = n->getStats();
+			if (!stats)
+				continue;
+
+			for (auto &m : Stats::metrics) {
+				for (auto &t : Stats::types) {
+					auto val = stats->getValue(m.first, t.first);
+
+					w->addSample({
+						{ "node", n->getName() },
+						{ "metric", m.second.name },
+						{ "type", t.second.name }
+					}, t.second.signal_type == SignalType::INTEGER ? (double) val.i : val.f);
+				}
+			}
+		}
+	}
+
+	/** Add a sample of \p field for the pool of each path and path source. */
+	template<typename F>
+	void addPoolSamples(F field)
+	{
+		for (auto *p : sn->getPaths()) {
+			if (p->getState() != State::STARTED)
+				continue;
+
+			PathId id(p);
+
+			w->addSample({ { "path", id.str }, { "pool", "path" } }, (uint64_t) field(&p->pool));
+
+			for (auto ps : p->sources)
+				w->addSample({ { "path", id.str }, { "pool", "source" }, { "node", ps->getNode()->getName() } }, (uint64_t) field(ps->getPool()));
+		}
+	}
+
+	void addPools()
+	{
+		w->addFamily("villas_pool_capacity", Type::GAUGE, "Number of samples which a pool currently holds.");
+		addPoolSamples([](const struct Pool *p) { return pool_capacity(p); });
+
+		w->addFamily("villas_pool_used", Type::GAUGE, "Number of samples which are currently handed out by a pool.");
+		addPoolSamples([](const struct Pool *p) { return p->used.load(std::memory_order_relaxed); });
+
+		w->addFamily("villas_pool_high_water", Type::GAUGE, "Highest number of samples which have been handed out by a pool at once.");
+		addPoolSamples([](const struct Pool *p) { return p->high_water.load(std::memory_order_relaxed); });
+
+		w->addFamily("villas_pool_grows", Type::COUNTER, "Number of chunks which have been added to an elastic pool.");
+		addPoolSamples([](const struct Pool *p) { return p->grows.load(std::memory_order_relaxed); });
+
+		w->addFamily("villas_pool_shrinks", Type::COUNTER, "Number of chunks which have been released by an elastic pool.");
+		addPoolSamples([](const struct Pool *p) { return p->shrinks.load(std::memory_order_relaxed); });
+	}
+
+	/** Add a sample of \p field for each path destination. */
+	template<typename F>
+	void addDestinationSamples(F field)
+	{
+		for (auto *p : sn->getPaths()) {
+			if (p->getState() != State::STARTED)
+				continue;
+
+			PathId id(p);
+
+			for (auto pd : p->destinations)
+				w->addSample({ { "path", id.str }, { "node", pd->getNode()->getName() } }, (uint64_t) field(pd.get()));
+		}
+	}
+
+	void addQueues()
+	{
+		w->addFamily("villas_path_destination_queued", Type::GAUGE, "Number of samples which are held by a path destination.");
+		addDestinationSamples([](const PathDestination *pd) { return pd->getUsed(); });
+
+		w->addFamily("villas_path_destination_credits", Type::GAUGE, "Maximum number of samples which a path destination may hold.");
+		addDestinationSamples([](const PathDestination *pd) { return pd->getCredits(); });
+
+		w->addFamily("villas_path_destination_enqueued", Type::COUNTER, "Number of samples which have been queued for a path destination.");
+		addDestinationSamples([](const PathDestination *pd) { return pd->getCounters().enqueued.load(std::memory_order_relaxed); });
+
+		w->addFamily("villas_path_destination_dropped", Type::COUNTER, "Number of samples which have been discarded by the overflow policy of a path destination.");
+		for (auto *p : sn->getPaths()) {
+			if (p->getState() != State::STARTED)
+				continue;
+
+			PathId id(p);
+
+			for (auto pd : p->destinations) {
+				auto &c = pd->getCounters();
+				auto &name = pd->getNode()->getName();
+
+				w->addSample({ { "path", id.str }, { "node", name }, { "reason", "newest" } }, c.dropped_newest.load(std::memory_order_relaxed));
+				w->addSample({ { "path", id.str }, { "node", name }, { "reason", "oldest" } }, c.dropped_oldest.load(std::memory_order_relaxed));
+				w->addSample({ { "path", id.str }, { "node", name }, { "reason", "coalesced" } }, c.coalesced.load(std::memory_order_relaxed));
+			}
+		}
+
+		w->addFamily("villas_path_destination_blocked", Type::COUNTER, "Number of times a path has blocked on a full path destination.");
+		addDestinationSamples([](const PathDestination *pd) { return pd->getCounters().blocked.load(std::memory_order_relaxed); });
+
+		w->addFamily("villas_path_destination_timeouts", Type::COUNTER, "Number of times a path has given up blocking on a full path destination.");
+		addDestinationSamples([](const PathDestination *pd) { return pd->getCounters().timeouts.load(std::memory_order_relaxed); });
+
+		w->addFamily("villas_path_pipeline_queued", Type::GAUGE, "Number of samples which wait for the hook thread of a pipelined path.");
+		for (auto *p : sn->getPaths()) {
+			if (p->getState() != State::STARTED || !p->pipelined)
+				continue;
+
+			PathId id(p);
+
+			w->addSample({ { "path", id.str } }, (uint64_t) queue_signalled_available(&p->pipeline));
+		}
+	}
+
+	/** Add a sample of \p field for each stage of all pipelined paths. */
+	template<typename F>
+	void addStageSamples(F field)
+	{
+		for (auto *p : sn->getPaths()) {
+			if (p->getState() != State::STARTED || !p->pipelined)
+				continue;
+
+			PathId id(p);
+
+			w->addSample({ { "path", id.str }, { "stage", "mux" } }, field(p->mux_stage));
+			w->addSample({ { "path", id.str }, { "stage", "hooks" } }, field(p->hooks_stage));
+
+			for (auto pd : p->destinations) {
+				if (pd->isPipelined())
+					w->addSample({ { "path", id.str }, { "stage", "writer" }, { "node", pd->getNode()->getName() } }, field(pd->getStage()));
+			}
+		}
+	}
+
+	void addStages()
+	{
+		w->addFamily("villas_path_stage_busy_seconds", Type::COUNTER, "Time which a stage of a pipelined path has spent with processing samples.", "seconds");
+		addStageSamples([](const PathStage &s) { return s.busy.load(std::memory_order_relaxed) * 1e-9; });
+
+		w->addFamily("villas_path_stage_batches", Type::COUNTER, "Number of batches which have been processed by a stage of a pipelined path.");
+		addStageSamples([](const PathStage &s) { return s.batches.load(std::memory_order_relaxed); });
+
+		w->addFamily("villas_path_stage_samples", Type::COUNTER, "Number of samples which have been processed by a stage of a pipelined path.");
+		addStageSamples([](const PathStage &s) { return s.samples.load(std::memory_order_relaxed); });
+
+		w->addFamily("villas_path_stage_overruns", Type::COUNTER, "Number of samples which have been dropped because the next stage of a pipelined path was full.");
+		addStageSamples([](const PathStage &s) { return s.overruns.load(std::memory_order_relaxed); });
+	}
+
+	void addThreads()
+	{
+		w->addFamily("villas_path_cpu_seconds", Type::COUNTER, "CPU time which has been consumed by the threads of a path.", "seconds");
+
+		for (auto *p : sn->getPaths()) {
+			if (p->getState() != State::STARTED)
+				continue;
+
+			PathId id(p);
+			double secs;
+
+			secs = getThreadTime(p->tid);
+			if (secs >= 0)
+				w->addSample({ { "path", id.str }, { "thread", "path" } }, secs);
+
+			if (p->pipelined) {
+				secs = getThreadTime(p->hooks_tid);
+				if (secs >= 0)
+					w->addSample({ { "path", id.str }, { "thread", "hooks" } }, secs);
+			}
+
+			for (auto pd : p->destinations) {
+				if (!pd->isPipelined())
+					continue;
+
+				secs = getThreadTime(pd->getThread());
+				if (secs >= 0)
+					w->addSample({ { "path", id.str }, { "thread", "writer" }, { "node", pd->getNode()->getName() } }, secs);
+			}
+		}
+	}
+
+	/** Add a sample of \p field for each hook of all paths and nodes. */
+	template<typename F>
+	void addHookSamples(F field)
+	{
+		for (auto *p : sn->getPaths()) {
+			if (p->getState() != State::STARTED)
+				continue;
+
+			PathId id(p);
+			unsigned i = 0;
+
+			p->hooks.forEach([&](const Hook::Ptr &h) {
+				auto name = h->getFactory()->getName();
+				fmt::format_int idx(i++);
+
+				w->addSample({ { "path", id.str }, { "hook", name }, { "index", idx.c_str() } }, field(h.get()));
+			});
+		}
+
+		for (auto *n : sn->getNodes()) {
+			if (n->getState() != State::STARTED)
+				continue;
+
+			for (auto *d : { &n->in, &n->out }) {
+				const char *dir = d == &n->in ? "in" : "out";
+				unsigned i = 0;
+
+				d->hooks.forEach([&](const Hook::Ptr &h) {
+					auto name = h->getFactory()->getName();
+					fmt::format_int idx(i++);
+
+					w->addSample({ { "node", n->getName() }, { "direction", dir }, { "hook", name }, { "index", idx.c_str() } }, field(h.get()));
+				});
+			}
+		}
+	}
+
+	void addHooks()
+	{
+		w->addFamily("villas_hook_busy_seconds", Type::COUNTER, "Time which a hook has spent with processing the measured samples.", "seconds");
+		addHookSamples([](const Hook *h) { return h->getBusy() * 1e-9; });
+
+		w->addFamily("villas_hook_measured", Type::COUNTER, "Number of samples whose processing time has been measured.");
+		addHookSamples([](const Hook *h) { return h->getMeasured(); });
+	}
+
+public:
+	using Request::Request;
+
+	virtual Response * execute()
+	{
+		if (method != Session::Method::GET)
+			throw InvalidMethod(this);
+
+		if (body != nullptr)
+			throw BadRequest("Metrics endpoint does not accept any body data");
+
+		sn = session->getSuperNode();
+		w = &sn->getApi()->metrics;
+
+		std::lock_guard<std::mutex> guard(sn->getMutex());
+
+		if (sn->getState() != State::STARTED)
+			throw Error(HTTP_STATUS_SERVICE_UNAVAILABLE, "Not running");
+
+		w->clear();
+
+		addNodeStats();
+		addPools();
+		addQueues();
+		addStages();
+		addThreads();
+		addHooks();
+
+		return new MetricsResponse(session, *w);
+	}
+};
+
+/* Register API request */
+static char n[] = "metrics";
+static char r[] = "/metrics";
+static char d[] = "export metrics of all nodes and paths in the OpenMetrics text format";
+static RequestPlugin<MetricsRequest, n, r, d> p;
+
+} /* namespace api */
+} /* namespace node */
+} /* namespace villas */
@@ -5,6 +5,8 @@
  * @license Apache 2.0
  *********************************************************************************/
 
+#include <mutex>
+
 #include <jansson.h>
 
 #include <villas/node.hpp>
@@ -33,6 +35,10 @@ public:
 		if (body != nullptr)
 			throw BadRequest("Node endpoints do not accept any body data");
 
+		/* Do not change the state of a node while a reload or the
+		 * metrics request walks the running nodes and paths */
+		std::lock_guard<std::mutex> guard(session->getSuperNode()->getMutex());
+
 		int ret = (node->*func)();
 		if (ret)
 			throw BadRequest("Failed to execute action", "{ s: d }",
@@ -0,0 +1,80 @@
+/** The API ressource for replacing the hooks of a node.
+ *
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+#include <jansson.h>
+
+#include <villas/node.hpp>
+#include <villas/super_node.hpp>
+#include <villas/api/session.hpp>
+#include <villas/api/requests/node.hpp>
+#include <villas/api/response.hpp>
+
+namespace villas {
+namespace node {
+namespace api {
+
+class NodeHooksRequest : public NodeRequest  {
+
+public:
+	using NodeRequest::NodeRequest;
+
+	virtual Response * execute()
+	{
+		int ret;
+		json_error_t err;
+		json_t *json_in = nullptr;
+		json_t *json_out = nullptr;
+
+		switch (method) {
+			case Session::Method::GET:
+				if (body != nullptr)
+					throw BadRequest("Node hooks endpoint does not accept any body data for GET requests");
+
+				break;
+
+			case Session::Method::PUT:
+				ret = json_unpack_ex(body, &err, 0, "{ s?: o, s?: o }",
+					"in", &json_in,
+					"out", &json_out
+				);
+				if (ret)
+					throw BadRequest("Failed to parse request body");
+
+				if ((json_in && !json_is_array(json_in)) ||
+				    (json_out && !json_is_array(json_out)))
+					throw BadRequest("Hooks must be provided as a list of hook objects");
+
+				if (json_in)
+					node->in.replaceHooks(json_in);
+
+				if (json_out)
+					node->out.replaceHooks(json_out);
+
+				break;
+
+			default:
+				throw InvalidMethod(this);
+		}
+
+		auto *json_hooks = json_pack("{ s: o, s: o }",
+			"in", node->in.hooks.toJson(),
+			"out", node->out.hooks.toJson()
+		);
+
+		return new JsonResponse(session, HTTP_STATUS_OK, json_hooks);
+	}
+};
+
+/* Register API request */
+static char n[] = "node/hooks";
+static char r[] = "/node/(" RE_NODE_NAME "|" RE_UUID ")/hooks";
+static char d[] = "get or replace the hooks of a node";
+static RequestPlugin<NodeHooksRequest, n, r, d> p;
+
+} /* namespace api */
+} /* namespace node */
+} /* namespace villas */
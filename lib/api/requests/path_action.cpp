@@ -5,6 +5,8 @@
  * @license Apache 2.0
  *********************************************************************************/
 
+#include <mutex>
+
 #include <jansson.h>
 
 #include <villas/path.hpp>
@@ -33,6 +35,10 @@ public:
 		if (body != nullptr)
 			throw BadRequest("Path endpoints do not accept any body data");
 
+		/* Starting and stopping spawns and joins the threads whose
+		 * CPU time is collected by the metrics request */
+		std::lock_guard<std::mutex> guard(session->getSuperNode()->getMutex());
+
 		(path->*func)();
 
 		return new Response(session, HTTP_STATUS_OK);
@@ -0,0 +1,57 @@
+/** The API ressource for replacing the hooks of a path.
+ *
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+#include <jansson.h>
+
+#include <villas/path.hpp>
+#include <villas/super_node.hpp>
+#include <villas/api/session.hpp>
+#include <villas/api/requests/path.hpp>
+#include <villas/api/response.hpp>
+
+namespace villas {
+namespace node {
+namespace api {
+
+class PathHooksRequest : public PathRequest  {
+
+public:
+	using PathRequest::PathRequest;
+
+	virtual Response * execute()
+	{
+		switch (method) {
+			case Session::Method::GET:
+				if (body != nullptr)
+					throw BadRequest("Path hooks endpoint does not accept any body data for GET requests");
+
+				break;
+
+			case Session::Method::PUT:
+				if (!json_is_array(body))
+					throw BadRequest("Hooks must be provided as a list of hook objects");
+
+				path->replaceHooks(body);
+				break;
+
+			default:
+				throw InvalidMethod(this);
+		}
+
+		return new JsonResponse(session, HTTP_STATUS_OK, path->hooks.toJson());
+	}
+};
+
+/* Register API request */
+static char n[] = "path/hooks";
+static char r[] = "/path/(" RE_UUID ")/hooks";
+static char d[] = "get or replace the hooks of a path";
+static RequestPlugin<PathHooksRequest, n, r, d> p;
+
+} /* namespace api */
+} /* namespace node */
+} /* namespace villas */
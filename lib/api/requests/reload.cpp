@@ -0,0 +1,72 @@
+/** The "reload" API request.
+ *
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+#include <villas/super_node.hpp>
+#include <villas/api/request.hpp>
+#include <villas/api/response.hpp>
+#include <villas/api/session.hpp>
+
+namespace villas {
+namespace node {
+namespace api {
+
+class ReloadRequest : public Request {
+
+public:
+	using Request::Request;
+
+	virtual Response * execute()
+	{
+		int ret;
+		int dryRun = 0;
+		json_error_t err;
+
+		if (method != Session::Method::POST)
+			throw InvalidMethod(this);
+
+		json_t *json_config = nullptr;
+
+		if (body) {
+			ret = json_unpack_ex(body, &err, 0, "{ s?: o, s?: b }",
+				"config", &json_config,
+				"dry_run", &dryRun
+			);
+			if (ret < 0)
+				throw BadRequest("Failed to parse request body");
+		}
+
+		auto *sn = session->getSuperNode();
+		json_t *json_diff;
+
+		if (json_is_object(json_config))
+			json_diff = sn->reload(json_config, dryRun);
+		else if (json_is_string(json_config))
+			json_diff = sn->reload(json_string_value(json_config), dryRun);
+		else if (json_config == nullptr) {
+			/* If no config is provided via request, we will reload the previous one */
+			auto uri = sn->getConfigUri();
+			if (uri.empty())
+				throw BadRequest("Instance has been started without a configuration file");
+
+			json_diff = sn->reload(uri, dryRun);
+		}
+		else
+			throw BadRequest("Parameter 'config' must be either a URL (string) or a configuration (object)");
+
+		return new JsonResponse(session, HTTP_STATUS_OK, json_diff);
+	}
+};
+
+/* Register API request */
+static char n[] = "reload";
+static char r[] = "/reload";
+static char d[] = "apply a new configuration by only restarting changed nodes and paths";
+static RequestPlugin<ReloadRequest, n, r, d> p;
+
+} /* namespace api */
+} /* namespace node */
+} /* namespace villas */
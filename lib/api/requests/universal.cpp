@@ -6,6 +6,7 @@
  * @license Apache 2.0
  *********************************************************************************/
 
+#include <villas/timing.hpp>
 #include <villas/api/requests/universal.hpp>
 
 using namespace villas::node;
@@ -20,3 +21,114 @@ void UniversalRequest::prepare()
 	if (!api_node)
 		throw BadRequest("Node {} is not an univeral API node!", node->getNameShort());
 }
+
+PayloadType UniversalRequest::getPayloadType(const std::string &subResource)
+{
+	if (subResource == "event")
+		return PayloadType::EVENTS;
+	else if (subResource == "sample")
+		return PayloadType::SAMPLES;
+
+	throw BadRequest("Unsupported sub-resource: {}", subResource);
+}
+
+unsigned UniversalRequest::getChannelIndex(const APINode::Direction &dir, SampleMailbox::Ptr mb, const std::string &id, PayloadType payload, int code)
+{
+	auto sigs = mb->getSignals();
+	if (!sigs)
+		throw Error(HTTP_STATUS_NOT_FOUND, "No data available");
+
+	auto idx = sigs->getIndexByName(id);
+	if (idx < 0 || idx >= (int) mb->getCapacity())
+		throw Error(code, "Unknown signal id: {}", id);
+
+	if ((unsigned) idx < dir.channels.size() && dir.channels[idx]->payload != payload)
+		throw BadRequest("Mismatching payload type");
+
+	return idx;
+}
+
+std::vector<bool> UniversalRequest::getChannelMask(const APINode::Direction &dir, SampleMailbox::Ptr mb, PayloadType payload)
+{
+	auto sigs = mb->getSignals();
+	if (!sigs)
+		throw Error(HTTP_STATUS_NOT_FOUND, "No data available");
+
+	auto ids = getQueryArg("ids");
+	if (ids.empty()) {
+		std::vector<bool> mask(mb->getCapacity());
+
+		for (unsigned i = 0; i < mask.size(); i++)
+			mask[i] = i >= dir.channels.size() || dir.channels[i]->payload == payload;
+
+		return mask;
+	}
+
+	std::vector<bool> mask(mb->getCapacity(), false);
+
+	size_t start = 0, end;
+	do {
+		end = ids.find(',', start);
+
+		auto id = ids.substr(start, end == std::string::npos ? end : end - start);
+
+		mask[getChannelIndex(dir, mb, id, payload, HTTP_STATUS_NOT_FOUND)] = true;
+
+		start = end + 1;
+	} while (end != std::string::npos);
+
+	return mask;
+}
+
+SampleMailbox::Value UniversalRequest::parseValue(json_t *json, Signal::Ptr sig, unsigned index, struct timespec *ts)
+{
+	int ret;
+	double timestamp = 0;
+	json_t *json_value;
+	const char *validity = nullptr;
+	const char *source = nullptr;
+	const char *timesource = nullptr;
+
+	json_error_t err;
+	ret = json_unpack_ex(json, &err, 0, "{ s: F, s: o, s?: s, s?: s, s?: s }",
+		"timestamp", &timestamp,
+		"value", &json_value,
+		"validity", &validity,
+		"timesource", &timesource,
+		"source", &source
+	);
+	if (ret)
+		throw BadRequest("Malformed body: {}", err.text);
+
+	if (validity)
+		logger->warn("Attribute 'validity' is not supported by VILLASnode");
+
+	if (source)
+		logger->warn("Attribute 'source' is not supported by VILLASnode");
+
+	if (timesource)
+		logger->warn("Attribute 'timesource' is not supported by VILLASnode");
+
+	SampleMailbox::Value v;
+
+	v.index = index;
+
+	ret = v.data.parseJson(sig->type, json_value);
+	if (ret)
+		throw BadRequest("Malformed value");
+
+	*ts = time_from_double(timestamp);
+
+	return v;
+}
+
+json_t * UniversalRequest::valueToJson(Signal::Ptr sig, const union SignalData &data, const struct timespec *ts)
+{
+	return json_pack("{ s: f, s: o, s: s, s: s, s: s }",
+		"timestamp", time_to_double(ts),
+		"value", data.toJson(sig->type),
+		"validity", "unknown",
+		"source", "unknown",
+		"timesource", "unknown"
+	);
+}
@@ -0,0 +1,122 @@
+/** The Universal Data-exchange API.
+ *
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+#include <villas/api/requests/universal.hpp>
+#include <villas/api/response.hpp>
+
+namespace villas {
+namespace node {
+namespace api {
+namespace universal {
+
+/** Pushes changed channels as Server-Sent Events.
+ *
+ * The first event contains all selected channels.
+ * The response keeps a reference to the mailbox only so that it
+ * remains valid even if the node is removed by a reload.
+ */
+class SubscriptionResponse : public StreamResponse {
+
+protected:
+	SampleMailbox::Ptr mailbox;
+	std::vector<bool> mask;
+	uint64_t last;
+	bool initial;
+
+	virtual json_t * nextEvent()
+	{
+		std::vector<SampleMailbox::Value> values;
+		struct timespec ts;
+		uint64_t seq;
+
+		if (initial)
+			seq = mailbox->getAll(values, &ts);
+		else {
+			if (mailbox->getSequence() == last)
+				return nullptr;
+
+			seq = mailbox->getChanged(last, values, &ts);
+		}
+
+		initial = false;
+		last = seq;
+
+		auto sigs = mailbox->getSignals();
+		auto *json_values = json_object();
+
+		for (auto &v : values) {
+			if (v.index >= sigs->size() || !mask[v.index])
+				continue;
+
+			auto sig = sigs->getByIndex(v.index);
+
+			json_object_set_new(json_values, sig->name.c_str(), UniversalRequest::valueToJson(sig, v.data, &ts));
+		}
+
+		if (json_object_size(json_values) == 0) {
+			json_decref(json_values);
+			return nullptr;
+		}
+
+		return json_values;
+	}
+
+public:
+	SubscriptionResponse(Session *s, double rate, SampleMailbox::Ptr mb, const std::vector<bool> &m) :
+		StreamResponse(s, rate),
+		mailbox(mb),
+		mask(m),
+		last(0),
+		initial(true)
+	{ }
+};
+
+class ChannelsSubscribeRequest : public UniversalRequest {
+public:
+	using UniversalRequest::UniversalRequest;
+
+	virtual Response * execute()
+	{
+		if (method != Session::Method::GET)
+			throw InvalidMethod(this);
+
+		if (body != nullptr)
+			throw BadRequest("This endpoint does not accept any body data");
+
+		auto payload = getPayloadType(matches[2]);
+
+		auto mb = api_node->write.getMailbox();
+		if (!mb)
+			throw Error(HTTP_STATUS_NOT_FOUND, "No data available");
+
+		double rate = 10;
+
+		auto rateStr = getQueryArg("rate");
+		if (!rateStr.empty()) {
+			char *end;
+
+			rate = strtod(rateStr.c_str(), &end);
+			if (*end || rate <= 0 || rate > 1000)
+				throw BadRequest("Rate must be a number between 0 and 1000 Hz");
+		}
+
+		auto mask = getChannelMask(api_node->write, mb, payload);
+
+		return new SubscriptionResponse(session, rate, mb, mask);
+	}
+};
+
+/* Register API requests */
+static char n[] = "universal/channels/subscribe";
+static char r[] = "/universal/(" RE_NODE_NAME ")/channels/(sample|event)/subscribe";
+static char d[] = "subscribe to changed channels of universal data-exchange API node";
+static RequestPlugin<ChannelsSubscribeRequest, n, r, d> p;
+
+} /* namespace universal */
+} /* namespace api */
+} /* namespace node */
+} /* namespace villas */
@@ -0,0 +1,114 @@
+/** The Universal Data-exchange API.
+ *
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+#include <villas/api/requests/universal.hpp>
+#include <villas/api/response.hpp>
+#include <villas/timing.hpp>
+
+namespace villas {
+namespace node {
+namespace api {
+namespace universal {
+
+/** Get or set the values of many channels with a single request.
+ *
+ * The values are exchanged as an object with the channel ids as keys.
+ */
+class ChannelsValuesRequest : public UniversalRequest {
+public:
+	using UniversalRequest::UniversalRequest;
+
+	Response * executeGet(PayloadType payload)
+	{
+		if (body != nullptr)
+			throw BadRequest("This endpoint does not accept any body data");
+
+		auto mb = api_node->write.getMailbox();
+		if (!mb)
+			throw Error(HTTP_STATUS_NOT_FOUND, "No data available");
+
+		auto mask = getChannelMask(api_node->write, mb, payload);
+		auto sigs = mb->getSignals();
+
+		std::vector<SampleMailbox::Value> values;
+		struct timespec ts;
+
+		/* All values are taken from a single consistent snapshot */
+		mb->getAll(values, &ts);
+
+		auto *json_values = json_object();
+
+		for (auto &v : values) {
+			if (v.index >= sigs->size() || !mask[v.index])
+				continue;
+
+			auto sig = sigs->getByIndex(v.index);
+
+			json_object_set_new(json_values, sig->name.c_str(), valueToJson(sig, v.data, &ts));
+		}
+
+		return new JsonResponse(session, HTTP_STATUS_OK, json_values);
+	}
+
+	Response * executePut(PayloadType payload)
+	{
+		if (!json_is_object(body))
+			throw BadRequest("Body must be an object of channel values");
+
+		auto mb = api_node->read.getMailbox();
+		if (!mb)
+			throw Error(HTTP_STATUS_INTERNAL_SERVER_ERROR, "Not initialized yet");
+
+		auto sigs = mb->getSignals();
+
+		std::vector<SampleMailbox::Value> values;
+		struct timespec ts = { 0, 0 };
+
+		const char *id;
+		json_t *json_value;
+		json_object_foreach(body, id, json_value) {
+			struct timespec t;
+
+			auto idx = getChannelIndex(api_node->read, mb, id, payload, HTTP_STATUS_BAD_REQUEST);
+
+			values.push_back(parseValue(json_value, sigs->getByIndex(idx), idx, &t));
+
+			if (time_delta(&ts, &t) > 0)
+				ts = t;
+		}
+
+		/* Either all or none of the values are published */
+		mb->put(values, &ts);
+
+		return new JsonResponse(session, HTTP_STATUS_OK, json_object());
+	}
+
+	virtual Response * execute()
+	{
+		auto payload = getPayloadType(matches[2]);
+
+		switch (method) {
+		case Session::Method::GET:
+			return executeGet(payload);
+		case Session::Method::PUT:
+			return executePut(payload);
+		default:
+			throw InvalidMethod(this);
+		}
+	}
+};
+
+/* Register API requests */
+static char n[] = "universal/channels/sample";
+static char r[] = "/universal/(" RE_NODE_NAME ")/channels/(sample|event)";
+static char d[] = "retrieve or send samples of many channels via universal data-exchange API";
+static RequestPlugin<ChannelsValuesRequest, n, r, d> p;
+
+} /* namespace universal */
+} /* namespace api */
+} /* namespace node */
+} /* namespace villas */
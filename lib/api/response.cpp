@@ -8,6 +8,7 @@
 
 #include <villas/api/response.hpp>
 #include <villas/api/request.hpp>
+#include <villas/api/session.hpp>
 #include <villas/config.hpp>
 
 using namespace villas::node::api;
@@ -47,7 +48,7 @@ int Response::writeHeaders(struct lws *wsi)
 	encodeBody();
 
 	ret = lws_add_http_common_headers(wsi, code, contentType.c_str(),
-		buffer.size(),
+		isStreaming() ? LWS_ILLEGAL_HTTP_CONTENT_LEN : buffer.size(),
 		&p, end);
 	if (ret)
 		return 1;
@@ -82,3 +83,73 @@ void JsonResponse::encodeBody()
 {
 	buffer.encode(response, JSON_INDENT(4));
 }
+
+StreamResponse::StreamResponse(Session *s, double rate) :
+	Response(s, HTTP_STATUS_OK, "text/event-stream"),
+	interval(1e6 / rate)
+{
+	headers["Cache-Control:"] = "no-cache";
+}
+
+void StreamResponse::encodeEvent(json_t *json)
+{
+	char *str = json_dumps(json, JSON_COMPACT);
+
+	json_decref(json);
+
+	if (!str)
+		return;
+
+	std::string event = fmt::format("data: {}\n\n", str);
+
+	buffer.append(event.data(), event.size());
+
+	free(str);
+}
+
+void StreamResponse::encodeBody()
+{
+	buffer.clear();
+
+	json_t *json = nextEvent();
+	if (json)
+		encodeEvent(json);
+	else {
+		/* Send a comment so that the client sees the stream is open */
+		std::string comment = ": subscribed\n\n";
+
+		buffer.append(comment.data(), comment.size());
+	}
+}
+
+int StreamResponse::writeBody(struct lws *wsi)
+{
+	int ret;
+
+	if (session->getState() == Session::State::SHUTDOWN) {
+		unsigned char end[LWS_PRE + 1];
+
+		ret = lws_write(wsi, &end[LWS_PRE], 0, LWS_WRITE_HTTP_FINAL);
+
+		return ret < 0 ? -1 : 1;
+	}
+
+	if (buffer.size() == 0) {
+		json_t *json = nextEvent();
+		if (json)
+			encodeEvent(json);
+	}
+
+	if (buffer.size() > 0) {
+		ret = lws_write(wsi, (unsigned char *) buffer.data(), buffer.size(), LWS_WRITE_HTTP);
+		if (ret < 0)
+			return -1;
+
+		buffer.clear();
+	}
+
+	/* The session requests the next writeable callback once the timer fires */
+	lws_set_timer_usecs(wsi, interval);
+
+	return 0;
+}
@@ -0,0 +1,38 @@
+/** Cache of pre-serialized API responses.
+ *
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+#include <villas/api/response_cache.hpp>
+
+using namespace villas;
+using namespace villas::node::api;
+
+bool ResponseCache::lookup(const std::string &key, uint64_t generation, Buffer &body)
+{
+	std::lock_guard<std::mutex> guard(mutex);
+
+	auto it = entries.find(key);
+	if (it == entries.end() || it->second.generation != generation)
+		return false;
+
+	body = it->second.body;
+
+	return true;
+}
+
+void ResponseCache::store(const std::string &key, uint64_t generation, const Buffer &body)
+{
+	std::lock_guard<std::mutex> guard(mutex);
+
+	entries[key] = { generation, body };
+}
+
+void ResponseCache::clear()
+{
+	std::lock_guard<std::mutex> guard(mutex);
+
+	entries.clear();
+}
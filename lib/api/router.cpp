@@ -0,0 +1,182 @@
+/** API request routing.
+ *
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+#include <cstring>
+
+#include <villas/exceptions.hpp>
+#include <villas/api/router.hpp>
+
+using namespace villas;
+using namespace villas::node::api;
+
+std::vector<std::string> Router::splitPattern(const std::string &pattern)
+{
+	std::vector<std::string> segments;
+	std::string segment;
+	int depth = 0;
+
+	for (size_t i = 0; i < pattern.size(); i++) {
+		char c = pattern[i];
+
+		if (c == '\\' && i + 1 < pattern.size()) {
+			segment += c;
+			segment += pattern[++i];
+			continue;
+		}
+
+		if (c == '(' || c == '[')
+			depth++;
+		else if (c == ')' || c == ']')
+			depth--;
+		else if (c == '/' && depth == 0) {
+			segments.push_back(segment);
+			segment.clear();
+			continue;
+		}
+
+		segment += c;
+	}
+
+	segments.push_back(segment);
+
+	return segments;
+}
+
+bool Router::isLiteral(const std::string &segment)
+{
+	return segment.find_first_of("\\^$.|?*+()[]{}") == std::string::npos;
+}
+
+void Router::add(const std::string &pattern, RequestFactory *rf)
+{
+	auto segments = splitPattern(pattern);
+
+	/* Patterns start with a '/' */
+	if (segments.empty() || !segments[0].empty())
+		throw RuntimeError("API routes must start with '/': {}", pattern);
+
+	Node *n = &root;
+
+	for (size_t i = 1; i < segments.size(); i++) {
+		auto &seg = segments[i];
+
+		if (seg.find('/') != std::string::npos) {
+			std::string tail = seg;
+			for (size_t j = i + 1; j < segments.size(); j++)
+				tail += "/" + segments[j];
+
+			n->tails.push_back({ std::regex(tail), rf });
+			return;
+		}
+
+		if (isLiteral(seg)) {
+			auto &child = n->literals[seg];
+			if (!child)
+				child = std::make_unique<Node>();
+
+			n = child.get();
+		}
+		else {
+			Param *param = nullptr;
+			for (auto &p : n->params) {
+				if (p.pattern == seg) {
+					param = &p;
+					break;
+				}
+			}
+
+			if (!param) {
+				n->params.push_back({ seg, std::regex(seg), std::make_unique<Node>() });
+				param = &n->params.back();
+			}
+
+			n = param->child.get();
+		}
+	}
+
+	if (n->factory)
+		throw RuntimeError("Duplicate API route: {}", pattern);
+
+	n->factory = rf;
+}
+
+bool Router::match(const Node *n, const std::vector<size_t> &offsets, size_t i, const std::string &uri, std::vector<std::string> &captures, RequestFactory **rf) const
+{
+	/* Number of segments: the last offset marks the end of the URI */
+	size_t num = offsets.size() - 1;
+
+	if (i == num) {
+		*rf = n->factory;
+		return n->factory != nullptr;
+	}
+
+	/* Segments exclude the '/' separators */
+	auto segment = uri.substr(offsets[i] + 1, offsets[i + 1] - offsets[i] - 1);
+
+	auto it = n->literals.find(segment);
+	if (it != n->literals.end() && match(it->second.get(), offsets, i + 1, uri, captures, rf))
+		return true;
+
+	size_t mark = captures.size();
+
+	for (auto &p : n->params) {
+		std::smatch m;
+		if (!std::regex_match(segment, m, p.regex))
+			continue;
+
+		for (size_t j = 1; j < m.size(); j++)
+			captures.push_back(m[j].str());
+
+		if (match(p.child.get(), offsets, i + 1, uri, captures, rf))
+			return true;
+
+		captures.resize(mark);
+	}
+
+	auto rest = uri.substr(offsets[i] + 1);
+
+	for (auto &t : n->tails) {
+		std::smatch m;
+		if (!std::regex_match(rest, m, t.regex))
+			continue;
+
+		for (size_t j = 1; j < m.size(); j++)
+			captures.push_back(m[j].str());
+
+		*rf = t.factory;
+		return true;
+	}
+
+	return false;
+}
+
+RequestFactory * Router::lookup(const std::string &uri, std::vector<std::string> &matches) const
+{
+	if (uri.empty() || uri[0] != '/')
+		return nullptr;
+
+	/* Offsets of all '/' separators and the end of the URI */
+	std::vector<size_t> offsets;
+	for (size_t pos = 0; pos < uri.size(); pos++) {
+		if (uri[pos] == '/')
+			offsets.push_back(pos);
+	}
+
+	offsets.push_back(uri.size());
+
+	std::vector<std::string> captures;
+	RequestFactory *rf;
+
+	if (!match(&root, offsets, 0, uri, captures, &rf))
+		return nullptr;
+
+	matches.clear();
+	matches.push_back(uri);
+	matches.insert(matches.end(), captures.begin(), captures.end());
+
+	return rf;
+}
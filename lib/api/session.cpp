@@ -53,7 +53,28 @@ void Session::execute()
 	logger->debug("Running API request: {}", request->toString());
 
 	try {
-		response = std::unique_ptr<Response>(request->execute());
+		bool cacheable = request->isCacheable() &&
+				 request->method == Method::GET &&
+				 request->body == nullptr;
+
+		auto generation = getSuperNode()->getGeneration();
+		auto &key = request->matches[0];
+
+		Buffer cached;
+		if (cacheable && api->cache.lookup(key, generation, cached))
+			response = std::make_unique<Response>(this, HTTP_STATUS_OK, "application/json", cached);
+		else {
+			response = std::unique_ptr<Response>(request->execute());
+
+			if (cacheable && response->code == HTTP_STATUS_OK) {
+				/* Encode the body only once and keep it for later requests */
+				response->encodeBody();
+
+				api->cache.store(key, generation, response->buffer);
+
+				response = std::make_unique<Response>(this, HTTP_STATUS_OK, response->contentType, response->buffer);
+			}
+		}
 
 		logger->debug("Completed API request: {}", request->toString());
 	} catch (const Error &e) {
@@ -232,11 +253,17 @@ int Session::protocolCallback(struct lws *wsi, enum lws_callback_reasons reason,
 				if (lws_http_transaction_completed(wsi))
 					return -1;
 			}
-			else
+			else if (!s->response || !s->response->isStreaming())
 				lws_callback_on_writable(wsi);
 
 			break;
 
+		case LWS_CALLBACK_TIMER:
+			/* Streaming responses are resumed by a timer */
+			lws_callback_on_writable(wsi);
+
+			break;
+
 		default:
 			break;
 	}
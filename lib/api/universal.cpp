@@ -53,6 +53,7 @@ void Channel::parse(json_t *json)
 	if (desc)
 		description = desc;
 
+	payload = PayloadType::SAMPLES;
 	if (pl) {
 		if (!strcmp(pl, "samples"))
 			payload = PayloadType::SAMPLES;
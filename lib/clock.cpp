@@ -0,0 +1,261 @@
+/** Wall-clock time source with an optional calibrated TSC fast path
+ *
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+#include <atomic>
+#include <cstring>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+  #include <villas/tsc.hpp>
+  #define CLOCK_HAS_TSC
+#endif
+
+#include <villas/clock.hpp>
+#include <villas/exceptions.hpp>
+#include <villas/timing.hpp>
+#include <villas/log.hpp>
+
+/** Fixed-point shift of the nanoseconds per cycle multiplier */
+#define CLOCK_TSC_SHIFT 32
+
+using namespace villas;
+using namespace villas::node;
+
+static std::atomic<bool> use_tsc(false);
+
+#ifdef CLOCK_HAS_TSC
+/* The calibration is protected by a sequence lock.
+ * Readers never block, and retry if a recalibration happened in the meantime. */
+static std::atomic<unsigned> calib_seq(0);
+static std::atomic<uint64_t> calib_tsc;		/**< TSC value of the last calibration point. */
+static std::atomic<int64_t> calib_ns;		/**< CLOCK_REALTIME of the last calibration point in nanoseconds. */
+static std::atomic<uint64_t> calib_mult;	/**< Nanoseconds per cycle as fixed-point number. */
+static std::atomic<uint64_t> calib_next;	/**< TSC value after which we recalibrate. */
+static std::atomic_flag calibrating = ATOMIC_FLAG_INIT;
+
+static uint64_t calib_interval;			/**< Recalibration interval in cycles. */
+
+static struct Tsc tsc_info;
+
+/** Take a (TSC, CLOCK_REALTIME) pair with the smallest possible measurement window. */
+static
+void clock_sample(uint64_t *tsc, int64_t *ns)
+{
+	uint64_t best = UINT64_MAX;
+
+	for (int i = 0; i < 5; i++) {
+		struct timespec ts;
+
+		uint64_t before = tsc_now(&tsc_info);
+		clock_gettime(CLOCK_REALTIME, &ts);
+		uint64_t after = tsc_now(&tsc_info);
+
+		if (after - before < best) {
+			best = after - before;
+
+			*tsc = before + best / 2;
+			*ns = time_to_ns(&ts);
+		}
+	}
+}
+
+static
+void clock_publish(uint64_t tsc, int64_t ns, uint64_t mult)
+{
+	calib_seq.fetch_add(1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	calib_tsc.store(tsc, std::memory_order_relaxed);
+	calib_ns.store(ns, std::memory_order_relaxed);
+	calib_mult.store(mult, std::memory_order_relaxed);
+
+	calib_seq.fetch_add(1, std::memory_order_release);
+
+	calib_next.store(tsc + calib_interval, std::memory_order_relaxed);
+}
+
+static
+int64_t clock_tsc_to_ns(uint64_t tsc)
+{
+	unsigned seq;
+	uint64_t base_tsc, mult;
+	int64_t base_ns;
+
+	do {
+		seq = calib_seq.load(std::memory_order_acquire);
+
+		base_tsc = calib_tsc.load(std::memory_order_relaxed);
+		base_ns = calib_ns.load(std::memory_order_relaxed);
+		mult = calib_mult.load(std::memory_order_relaxed);
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+	} while ((seq & 1) || seq != calib_seq.load(std::memory_order_relaxed));
+
+	/* The TSC might be slightly behind the calibration point if it has been read before a concurrent recalibration */
+	if (tsc >= base_tsc)
+		return base_ns + (int64_t) (((unsigned __int128) (tsc - base_tsc) * mult) >> CLOCK_TSC_SHIFT);
+	else
+		return base_ns - (int64_t) (((unsigned __int128) (base_tsc - tsc) * mult) >> CLOCK_TSC_SHIFT);
+}
+
+/** Update the frequency estimate and move the calibration point to the current time. */
+static
+void clock_recalibrate()
+{
+	uint64_t tsc, mult = calib_mult.load(std::memory_order_relaxed);
+	int64_t ns;
+
+	clock_sample(&tsc, &ns);
+
+	uint64_t prev_tsc = calib_tsc.load(std::memory_order_relaxed);
+	int64_t prev_ns = calib_ns.load(std::memory_order_relaxed);
+	int64_t error = ns - clock_tsc_to_ns(tsc);
+
+	/* Only update the frequency if CLOCK_REALTIME has not been stepped (e.g. by settimeofday(2)).
+	 * Slewing by NTP is tracked by the new frequency estimate. */
+	if (tsc > prev_tsc && ns > prev_ns && error > -1000000 && error < 1000000)
+		mult = ((unsigned __int128) (ns - prev_ns) << CLOCK_TSC_SHIFT) / (tsc - prev_tsc);
+
+	clock_publish(tsc, ns, mult);
+}
+
+/** Check if the TSC runs at a constant rate in all ACPI P-, C- and T-states. */
+static
+bool clock_tsc_invariant()
+{
+	if (tsc_init(&tsc_info) || !tsc_info.is_invariant)
+		return false;
+
+	/* The kernel removes the TSC from the available clock sources if it detected that it is unstable or not synchronized across cores */
+	std::ifstream f("/sys/devices/system/clocksource/clocksource0/available_clocksource");
+	if (f.is_open()) {
+		std::string sources;
+		std::getline(f, sources);
+
+		if (sources.find("tsc") == std::string::npos)
+			return false;
+	}
+
+	return true;
+}
+
+static
+int clock_tsc_init()
+{
+	uint64_t tsc0, tsc1, mult;
+	int64_t ns0, ns1;
+
+	if (!clock_tsc_invariant())
+		return -1;
+
+	struct timespec ts = { 0, 10000000 };
+
+	clock_sample(&tsc0, &ns0);
+	nanosleep(&ts, nullptr);
+	clock_sample(&tsc1, &ns1);
+
+	if (tsc1 <= tsc0 || ns1 <= ns0)
+		return -1;
+
+	mult = ((unsigned __int128) (ns1 - ns0) << CLOCK_TSC_SHIFT) / (tsc1 - tsc0);
+
+	double freq = 1e9 * (tsc1 - tsc0) / (ns1 - ns0);
+	if (freq < 1e8 || freq > 1e10)
+		return -1;
+
+	calib_interval = freq * CLOCK_TSC_RECALIBRATION_INTERVAL;
+
+	clock_publish(tsc1, ns1, mult);
+
+	return 0;
+}
+#endif /* CLOCK_HAS_TSC */
+
+int villas::node::clock_parse(enum ClockSource *src, json_t *json)
+{
+	const char *str = json_string_value(json);
+	if (!str)
+		throw ConfigError(json, "node-config-clock", "Setting 'clock' must be a string");
+
+	if (!strcmp(str, "system"))
+		*src = ClockSource::SYSTEM;
+	else if (!strcmp(str, "tsc"))
+		*src = ClockSource::TSC;
+	else
+		throw ConfigError(json, "node-config-clock", "Invalid clock source: {}", str);
+
+	return 0;
+}
+
+int villas::node::clock_init(enum ClockSource src)
+{
+	use_tsc = false;
+
+	if (src == ClockSource::SYSTEM)
+		return 0;
+
+#ifdef CLOCK_HAS_TSC
+	if (!clock_tsc_init()) {
+		use_tsc = true;
+		return 0;
+	}
+#endif /* CLOCK_HAS_TSC */
+
+	auto logger = logging.get("clock");
+	logger->warn("The TSC is not invariant or could not be calibrated. Falling back to the system clock.");
+
+	return -1;
+}
+
+struct timespec villas::node::clock_now()
+{
+#ifdef CLOCK_HAS_TSC
+	if (use_tsc.load(std::memory_order_relaxed)) {
+		uint64_t tsc = tsc_now(&tsc_info);
+
+		if (tsc >= calib_next.load(std::memory_order_relaxed) &&
+		    !calibrating.test_and_set(std::memory_order_acquire)) {
+			clock_recalibrate();
+			calibrating.clear(std::memory_order_release);
+		}
+
+		return time_from_ns(clock_tsc_to_ns(tsc));
+	}
+#endif /* CLOCK_HAS_TSC */
+
+	return time_now();
+}
+
+enum ClockSource villas::node::clock_source()
+{
+	return use_tsc ? ClockSource::TSC : ClockSource::SYSTEM;
+}
+
+double villas::node::clock_tsc_frequency()
+{
+#ifdef CLOCK_HAS_TSC
+	if (use_tsc)
+		return 1e9 * ((uint64_t) 1 << CLOCK_TSC_SHIFT) / calib_mult.load(std::memory_order_relaxed);
+#endif /* CLOCK_HAS_TSC */
+
+	return 0;
+}
+
+const char * villas::node::clock_source_str(enum ClockSource src)
+{
+	switch (src) {
+		case ClockSource::SYSTEM:
+			return "system";
+
+		case ClockSource::TSC:
+			return "tsc";
+	}
+
+	return nullptr;
+}
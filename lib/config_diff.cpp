@@ -0,0 +1,328 @@
+/** Differences between two super node configurations.
+ *
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+#include <cstring>
+
+#include <villas/config_diff.hpp>
+
+using namespace villas::node;
+
+static
+void add_node_names(std::set<std::string> &names, json_t *json)
+{
+	size_t i;
+	json_t *json_entry;
+
+	if (json_is_string(json)) {
+		/* Mapping entries are prefixed by the node name: "node.data[0-3]" */
+		std::string str = json_string_value(json);
+
+		names.insert(str.substr(0, str.find_first_of(".[")));
+	}
+	else if (json_is_array(json)) {
+		json_array_foreach(json, i, json_entry)
+			add_node_names(names, json_entry);
+	}
+}
+
+std::set<std::string> ConfigDiff::getPathNodes(json_t *json_path, bool sources_only)
+{
+	std::set<std::string> names;
+
+	add_node_names(names, json_object_get(json_path, "in"));
+
+	if (!sources_only)
+		add_node_names(names, json_object_get(json_path, "out"));
+
+	return names;
+}
+
+/** Count the paths which write to each node. */
+static
+std::map<std::string, unsigned> count_writers(json_t *json_paths)
+{
+	std::map<std::string, unsigned> writers;
+	std::set<std::string> names;
+
+	size_t i;
+	json_t *json_path;
+
+	json_array_foreach(json_paths, i, json_path) {
+		names.clear();
+		add_node_names(names, json_object_get(json_path, "out"));
+
+		for (auto &n : names)
+			writers[n]++;
+	}
+
+	return writers;
+}
+
+/** Loopback nodes select a single-producer queue at prepare time if at most one path writes to them. */
+static
+bool is_auto_spsc(json_t *json_node)
+{
+	const char *type = json_string_value(json_object_get(json_node, "type"));
+
+	return type && !strcmp(type, "loopback") && !json_object_get(json_node, "spsc");
+}
+
+json_t * ConfigDiff::withoutHooks(json_t *json_node)
+{
+	json_t *json = json_deep_copy(json_node);
+
+	json_object_del(json, "hooks");
+
+	for (auto dir : { "in", "out" }) {
+		json_t *json_dir = json_object_get(json, dir);
+		if (json_is_object(json_dir))
+			json_object_del(json_dir, "hooks");
+	}
+
+	return json;
+}
+
+ConfigDiff::ConfigDiff(json_t *old_cfg, json_t *new_cfg) :
+	global(false)
+{
+	/* Global settings */
+	json_t *old_global = old_cfg ? json_copy(old_cfg) : json_object();
+	json_t *new_global = new_cfg ? json_copy(new_cfg) : json_object();
+
+	for (auto key : { "nodes", "paths" }) {
+		json_object_del(old_global, key);
+		json_object_del(new_global, key);
+	}
+
+	global = !json_equal(old_global, new_global);
+
+	json_decref(old_global);
+	json_decref(new_global);
+
+	/* Nodes */
+	const char *name;
+	json_t *json_old, *json_new;
+	json_t *old_nodes = json_object_get(old_cfg, "nodes");
+	json_t *new_nodes = json_object_get(new_cfg, "nodes");
+
+	json_object_foreach(old_nodes, name, json_old) {
+		json_new = json_object_get(new_nodes, name);
+
+		if (!json_new)
+			nodes[name] = Change::REMOVED;
+		else if (json_equal(json_old, json_new))
+			nodes[name] = Change::NONE;
+		else {
+			json_t *old_base = withoutHooks(json_old);
+			json_t *new_base = withoutHooks(json_new);
+
+			nodes[name] = json_equal(old_base, new_base)
+				? Change::HOOKS
+				: Change::CHANGED;
+
+			json_decref(old_base);
+			json_decref(new_base);
+		}
+	}
+
+	json_object_foreach(new_nodes, name, json_new) {
+		if (!json_object_get(old_nodes, name))
+			nodes[name] = Change::ADDED;
+	}
+
+	/* A running node whose queue only supports a single producer
+	 * must be rebuilt if more than one path writes to it now */
+	json_t *old_paths = json_object_get(old_cfg, "paths");
+	json_t *new_paths = json_object_get(new_cfg, "paths");
+
+	auto old_writers = count_writers(old_paths);
+	auto new_writers = count_writers(new_paths);
+
+	for (auto &n : nodes) {
+		if (n.second != Change::NONE && n.second != Change::HOOKS)
+			continue;
+
+		json_new = json_object_get(new_nodes, n.first.c_str());
+		if (!is_auto_spsc(json_new))
+			continue;
+
+		if (old_writers[n.first] <= 1 && new_writers[n.first] > 1)
+			n.second = Change::CHANGED;
+	}
+
+	/* Paths are matched by their configuration */
+	size_t i, j;
+
+	oldPaths.assign(json_array_size(old_paths), Change::REMOVED);
+	newPaths.assign(json_array_size(new_paths), Change::ADDED);
+	pathMatches.assign(json_array_size(old_paths), -1);
+
+	json_array_foreach(old_paths, i, json_old) {
+		json_array_foreach(new_paths, j, json_new) {
+			if (newPaths[j] != Change::ADDED)
+				continue;
+
+			if (json_equal(json_old, json_new)) {
+				oldPaths[i] = Change::NONE;
+				newPaths[j] = Change::NONE;
+				pathMatches[i] = j;
+				break;
+			}
+		}
+
+		if (oldPaths[i] != Change::NONE)
+			continue;
+
+		/* Restart paths whose nodes are rebuilt or removed.
+		 * New hooks are swapped into the running nodes. They keep
+		 * their output signals, so the paths can keep running. */
+		for (auto &n : getPathNodes(json_old)) {
+			if (isNodeStale(n)) {
+				oldPaths[i] = Change::RESTARTED;
+				newPaths[pathMatches[i]] = Change::RESTARTED;
+				break;
+			}
+		}
+	}
+
+	/* Paths sharing a source node are linked by master / secondary path sources.
+	 * If one of them is rebuilt, all others have to be rebuilt as well. */
+	bool again;
+	do {
+		std::set<std::string> tainted;
+
+		json_array_foreach(old_paths, i, json_old) {
+			if (oldPaths[i] != Change::NONE) {
+				auto names = getPathNodes(json_old, true);
+				tainted.insert(names.begin(), names.end());
+			}
+		}
+
+		json_array_foreach(new_paths, j, json_new) {
+			if (newPaths[j] != Change::NONE) {
+				auto names = getPathNodes(json_new, true);
+				tainted.insert(names.begin(), names.end());
+			}
+		}
+
+		again = false;
+		json_array_foreach(old_paths, i, json_old) {
+			if (oldPaths[i] != Change::NONE)
+				continue;
+
+			for (auto &n : getPathNodes(json_old, true)) {
+				if (tainted.find(n) != tainted.end()) {
+					oldPaths[i] = Change::RESTARTED;
+					newPaths[pathMatches[i]] = Change::RESTARTED;
+					again = true;
+					break;
+				}
+			}
+		}
+	} while (again);
+}
+
+bool ConfigDiff::isNodeStale(const std::string &name) const
+{
+	auto it = nodes.find(name);
+
+	return it != nodes.end() &&
+	       (it->second == Change::CHANGED || it->second == Change::REMOVED);
+}
+
+bool ConfigDiff::isNodeFresh(const std::string &name) const
+{
+	auto it = nodes.find(name);
+
+	return it != nodes.end() &&
+	       (it->second == Change::CHANGED || it->second == Change::ADDED);
+}
+
+bool ConfigDiff::isEmpty() const
+{
+	if (global)
+		return false;
+
+	for (auto &n : nodes) {
+		if (n.second != Change::NONE)
+			return false;
+	}
+
+	for (auto c : oldPaths) {
+		if (c != Change::NONE)
+			return false;
+	}
+
+	for (auto c : newPaths) {
+		if (c != Change::NONE)
+			return false;
+	}
+
+	return true;
+}
+
+const char * ConfigDiff::changeToString(Change c)
+{
+	switch (c) {
+		case Change::NONE:
+			return "unchanged";
+
+		case Change::ADDED:
+			return "added";
+
+		case Change::REMOVED:
+			return "removed";
+
+		case Change::CHANGED:
+			return "changed";
+
+		case Change::HOOKS:
+			return "hooks";
+
+		case Change::RESTARTED:
+			return "restarted";
+	}
+
+	return "unknown";
+}
+
+json_t * ConfigDiff::toJson() const
+{
+	json_t *json_nodes = json_object();
+	json_t *json_paths = json_object();
+
+	auto append = [](json_t *json, Change c, json_t *json_value) {
+		const char *key = changeToString(c);
+
+		json_t *json_list = json_object_get(json, key);
+		if (!json_list) {
+			json_list = json_array();
+			json_object_set_new(json, key, json_list);
+		}
+
+		json_array_append_new(json_list, json_value);
+	};
+
+	for (auto &n : nodes)
+		append(json_nodes, n.second, json_string(n.first.c_str()));
+
+	/* Paths are referred to by their index in the old 'paths' array.
+	 * Only added paths use the index in the new array. */
+	for (size_t i = 0; i < oldPaths.size(); i++)
+		append(json_paths, oldPaths[i], json_integer(i));
+
+	for (size_t j = 0; j < newPaths.size(); j++) {
+		if (newPaths[j] == Change::ADDED)
+			append(json_paths, Change::ADDED, json_integer(j));
+	}
+
+	return json_pack("{ s: b, s: o, s: o }",
+		"global", global,
+		"nodes", json_nodes,
+		"paths", json_paths
+	);
+}
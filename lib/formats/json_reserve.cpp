@@ -165,10 +165,8 @@ int JsonReserveFormat::unpackSample(json_t *json_smp, struct Sample *smp)
 		if (ret)
 			return -1;
 
-		auto sig = signals->getByName(name);
-		if (sig)
-			idx = signals->getIndexByName(name);
-		else {
+		idx = signals->getIndexByName(name);
+		if (idx < 0) {
 			ret = sscanf(name, "signal_%d", &idx);
 			if (ret != 1)
 				continue;
@@ -34,7 +34,9 @@ Hook::Hook(Path *p, Node *n, int fl, int prio, bool en) :
 	enabled(en),
 	path(p),
 	node(n),
-	config(nullptr)
+	config(nullptr),
+	busy(0),
+	measured(0)
 { }
 
 void Hook::prepare(SignalList::Ptr sigs)
@@ -45,6 +47,9 @@ void Hook::prepare(SignalList::Ptr sigs)
 
 	prepare();
 
+	/* Hooks may have inserted, removed or renamed signals */
+	signals->invalidateIndex();
+
 	state = State::PREPARED;
 }
 
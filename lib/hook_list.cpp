@@ -10,11 +10,28 @@
 #include <villas/hook_list.hpp>
 #include <villas/list.hpp>
 #include <villas/utils.hpp>
+#include <villas/node/log.hpp>
+#include <villas/node/trace.hpp>
 #include <villas/sample.hpp>
 
 using namespace villas;
 using namespace villas::node;
 
+HookList::~HookList()
+{
+	auto *hl = next.exchange(nullptr);
+	if (hl) {
+		if (hl->started)
+			hl->stop();
+
+		delete hl;
+	}
+
+	collect();
+
+	json_decref(config);
+}
+
 void HookList::parse(json_t *json, int mask, Path *o, Node *n)
 {
 	if (!json_is_array(json))
@@ -94,24 +111,144 @@ skip_add:
 		sigs = h->getSignals();
 
 		auto logger = h->getLogger();
-		logger->debug("Signal list after hook #{}:", i++);
+		VILLAS_LOG_DEBUG(logger, "Signal list after hook #{}:", i++);
 		if (logger->level() <= spdlog::level::debug)
 			sigs->dump(logger);
 	}
 }
 
+static
+bool signals_compatible(SignalList::Ptr a, SignalList::Ptr b)
+{
+	if (a == b)
+		return true;
+
+	if (!a || !b || a->size() != b->size())
+		return false;
+
+	for (unsigned i = 0; i < a->size(); i++) {
+		if ((*a)[i]->type != (*b)[i]->type)
+			return false;
+	}
+
+	return true;
+}
+
+void HookList::replace(json_t *json, int mask, SignalList::Ptr sigs, int m, Path *p, Node *n, bool running)
+{
+	auto *hl = new HookList();
+
+	/* Hooks keep references to their configuration */
+	hl->config = json_deep_copy(json);
+
+	try {
+		if (hl->config)
+			hl->parse(hl->config, mask, p, n);
+
+		hl->check();
+		hl->prepare(sigs, m, p, n);
+
+		SignalList::Ptr sigs_old, sigs_new;
+		{
+			std::shared_lock<std::shared_mutex> guard(mutex);
+
+			sigs_old = size() > 0 ? getSignals() : sigs;
+			sigs_new = hl->size() > 0 ? hl->getSignals() : sigs;
+		}
+
+		if (!signals_compatible(sigs_old, sigs_new))
+			throw RuntimeError("New hooks must not change the output signals");
+
+		if (running)
+			hl->start();
+	} catch (...) {
+		delete hl;
+		throw;
+	}
+
+	collect();
+
+	/* A replacement which has not been swapped in yet is superseded.
+	 * The lock makes sure that toJson() does not use it anymore. */
+	HookList *prev;
+	{
+		std::unique_lock<std::shared_mutex> guard(mutex);
+
+		prev = next.exchange(hl);
+	}
+
+	if (prev) {
+		if (prev->started)
+			prev->stop();
+
+		delete prev;
+	}
+
+	if (!running) {
+		update();
+		collect();
+	}
+}
+
+void HookList::update()
+{
+	/* Waits until concurrent calls of process() have finished their batch */
+	std::unique_lock<std::shared_mutex> guard(mutex);
+
+	auto *hl = next.exchange(nullptr);
+	if (!hl)
+		return;
+
+	/* Afterwards, hl holds the old hooks */
+	std::list<Hook::Ptr>::swap(*hl);
+	std::swap(config, hl->config);
+	std::swap(started, hl->started);
+
+	retired.push_back(hl);
+}
+
+void HookList::collect()
+{
+	std::list<HookList *> old;
+
+	{
+		std::unique_lock<std::shared_mutex> guard(mutex);
+
+		old.swap(retired);
+	}
+
+	for (auto *hl : old) {
+		if (hl->started)
+			hl->stop();
+
+		delete hl;
+	}
+}
+
 int HookList::process(struct Sample * smps[], unsigned cnt)
 {
 	unsigned current, processed = 0;
 
+	/* Swap in new hooks between two batches */
+	if (next.load(std::memory_order_relaxed))
+		update();
+
+	/* Uncontended unless another thread processes samples with the same hooks */
+	std::shared_lock<std::shared_mutex> guard(mutex);
+
 	if (size() == 0)
 		return cnt;
 
+	VILLAS_TRACE(hooks_start, this, cnt);
+
+	/* Measuring every sample would cost more than most hooks */
+	bool measure = batches.fetch_add(1, std::memory_order_relaxed) % HOOK_TIMING_INTERVAL == 0;
+
 	for (current = 0; current < cnt; current++) {
 		struct Sample *smp = smps[current];
 
 		for (auto h : *this) {
-			auto ret = h->process(smp);
+			auto ret = measure ? h->processTimed(smp) : h->process(smp);
 			smp->signals = h->getSignals();
 			switch (ret) {
 				case Hook::Reason::ERROR:
@@ -133,11 +270,23 @@ stop:	SWAP(smps[processed], smps[current]);
 skip: {}
 	}
 
-		return processed;
+	VILLAS_TRACE(hooks_done, this, cnt, processed);
+
+	if (VILLAS_TRACE_ENABLED(hooks_sample)) {
+		for (unsigned i = 0; i < processed; i++)
+			VILLAS_TRACE(hooks_sample, this, smps[i], smps[i]->sequence);
+	}
+
+	return processed;
 }
 
 void HookList::periodic()
 {
+	/* Replaced hooks are released here after the processing thread has left them */
+	collect();
+
+	std::shared_lock<std::shared_mutex> guard(mutex);
+
 	for (auto h : *this)
 		h->periodic();
 }
@@ -146,12 +295,16 @@ void HookList::start()
 {
 	for (auto h : *this)
 		h->start();
+
+	started = true;
 }
 
 void HookList::stop()
 {
 	for (auto h : *this)
 		h->stop();
+
+	started = false;
 }
 
 SignalList::Ptr HookList::getSignals() const
@@ -181,7 +334,13 @@ json_t * HookList::toJson() const
 {
 	json_t *json_hooks = json_array();
 
-	for (auto h : *this)
+	std::shared_lock<std::shared_mutex> guard(mutex);
+
+	/* A replacement which has not been swapped in yet is reported already */
+	auto *hl = next.load();
+	const HookList &hooks = hl ? *hl : *this;
+
+	for (auto h : hooks)
 		json_array_append(json_hooks, h->getConfig());
 
 	return json_hooks;
@@ -189,9 +348,9 @@ json_t * HookList::toJson() const
 
 void HookList::dump(Logger logger, std::string subject) const
 {
-	logger->debug("Hooks of {}:", subject);
+	VILLAS_LOG_DEBUG(logger, "Hooks of {}:", subject);
 
 	unsigned i = 0;
 	for (auto h : *this)
-		logger->debug("      {}: {}", i++, h->getFactory()->getName());
+		VILLAS_LOG_DEBUG(logger, "      {}: {}", i++, h->getFactory()->getName());
 }
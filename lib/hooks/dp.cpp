@@ -8,11 +8,13 @@
 #include <cmath>
 #include <cstring>
 
+#include <algorithm>
 #include <complex>
+#include <functional>
+#include <vector>
 
 #include <villas/hook.hpp>
 #include <villas/sample.hpp>
-#include <villas/dsp/window.hpp>
 #include <villas/utils.hpp>
 
 using namespace std::complex_literals;
@@ -24,8 +26,9 @@ namespace node {
 class DPHook : public Hook {
 
 protected:
-	char *signal_name;
-	unsigned signal_index;
+	std::vector<std::string> signalNames;	/**< Names of the input signals. Empty if selected by index. */
+	std::vector<unsigned> signalIndices;	/**< Indices of the input signals in the order of the configuration. */
+	std::vector<unsigned> removeOrder;	/**< Indices of the input signals in descending order. */
 
 	int offset;
 	int inverse;
@@ -33,110 +36,196 @@ protected:
 	double f0;
 	double timestep;
 	double time;
-	double steps;
 
-	std::complex<double> *coeffs;
-	int *fharmonics;
-	int  fharmonics_len;
+	std::vector<int> fharmonics;
 
-	dsp::Window<double> window;
+	unsigned windowSize;			/**< Number of samples per period of the fundamental frequency. */
+	unsigned phase;				/**< Number of processed samples modulo windowSize. */
 
-	void step(double *in, std::complex<float> *out)
+	/* Tables which are precomputed in prepare().
+	 * All of them are stored with separate real and imaginary parts
+	 * so that the harmonic loops can be vectorized. */
+	std::vector<double> rotRe, rotIm;	/**< Rotation factors of the recursive update per harmonic. */
+	std::vector<double> twRe, twIm;		/**< Twiddle factors of the full DFT (harmonic-major). */
+	std::vector<double> corrRe, corrIm;	/**< Stationary phasor correction (phase-major). */
+
+	/* Per-signal state in SoA layout (signal-major) */
+	std::vector<double> history;		/**< Sliding windows of all input signals. */
+	std::vector<double> coeffsRe, coeffsIm;	/**< Current DFT coefficients or rotating phasors of the inverse transform. */
+
+	/** Recalculate all coefficients with a full DFT over the current window.
+	 *
+	 * The recursive update accumulates rounding errors. We re-synchronize
+	 * once per window to keep the result identical to a full DFT.
+	 */
+	void resync()
 	{
-		int N = window.size();
-		__attribute__((unused)) std::complex<double> om_k, corr;
-		double newest = *in;
-		__attribute__((unused)) double oldest = window.update(newest);
+		unsigned N = windowSize;
+		unsigned K = fharmonics.size();
 
-		for (int k = 0; k < fharmonics_len; k++) {
-			om_k = 2.0i * M_PI * (double) fharmonics[k] / (double) N;
+		for (unsigned s = 0; s < signalIndices.size(); s++) {
+			const double *hist = &history[s * N];
 
-			/* Correction for stationary phasor */
-			corr = std::exp(-om_k * (steps - (N + 1)));
-			//corr = 1;
+			for (unsigned k = 0; k < K; k++) {
+				const double *wr = &twRe[k * N];
+				const double *wi = &twIm[k * N];
+				double xr = 0, xi = 0;
 
-#if 0
-			/* Recursive update */
-			coeffs[k] = std::exp(om) * (coeffs[k] + (newest - oldest));
+				/* The oldest sample is located at index 'phase' */
+				for (unsigned n = 0; n < N; n++) {
+					double x_n = hist[(phase + n) % N];
+
+					xr += x_n * wr[n];
+					xi += x_n * wi[n];
+				}
+
+				coeffsRe[s * K + k] = xr;
+				coeffsIm[s * K + k] = xi;
+			}
+		}
+	}
+
+	void step(const double *in, std::complex<float> *out)
+	{
+		unsigned N = windowSize;
+		unsigned K = fharmonics.size();
+
+		const double *cr = &corrRe[phase * K];
+		const double *ci = &corrIm[phase * K];
+
+		for (unsigned s = 0; s < signalIndices.size(); s++) {
+			double *hist = &history[s * N];
+			double *xr = &coeffsRe[s * K];
+			double *xi = &coeffsIm[s * K];
+
+			double oldest = hist[phase];
+			double newest = in[s];
 
-			out[k] = (2.0 / N) * (coeffs[i] * corr);
+			hist[phase] = newest;
 
-			/* DC component */
-			if (fharmonics[k] == 0)
-				out[k] /= 2.0;
-#else
-			/* Full DFT */
-			std::complex<double> X_k = 0;
+			double delta = newest - oldest;
 
-			for (int n = 0; n < N; n++) {
-				double x_n = window[n];
+			/* Recursive update */
+			#pragma omp simd
+			for (unsigned k = 0; k < K; k++) {
+				double re = xr[k] + delta;
+				double im = xi[k];
 
-				X_k += x_n * std::exp(om_k * (double) n);
+				xr[k] = rotRe[k] * re - rotIm[k] * im;
+				xi[k] = rotIm[k] * re + rotRe[k] * im;
 			}
+		}
 
-			out[k] = X_k / (corr * (double) N);
-#endif
+		phase = (phase + 1) % N;
+		if (phase == 0)
+			resync();
+
+		/* Correction for stationary phasor */
+		for (unsigned s = 0; s < signalIndices.size(); s++) {
+			const double *xr = &coeffsRe[s * K];
+			const double *xi = &coeffsIm[s * K];
+
+			#pragma omp simd
+			for (unsigned k = 0; k < K; k++)
+				out[s * K + k] = std::complex<float>(
+					xr[k] * cr[k] - xi[k] * ci[k],
+					xr[k] * ci[k] + xi[k] * cr[k]
+				);
 		}
 	}
 
-	void istep(std::complex<float> *in, double *out)
+	void istep(const std::complex<float> * const *in, double *out)
 	{
-		std::complex<double> value = 0;
+		unsigned K = fharmonics.size();
 
-		/* Reconstruct the original signal */
-		for (int k = 0; k < fharmonics_len; k++) {
-			double freq = fharmonics[k];
-			// cppcheck-suppress objectIndex
-			std::complex<double> coeff = in[k];
-			std::complex<double> om = 2.0i * M_PI * freq * time;
+		/* Reconstruct the original signals */
+		for (unsigned s = 0; s < signalIndices.size(); s++) {
+			const std::complex<float> *coeffs = in[s];
+			double value = 0;
 
-			value += coeff * std::exp(om);
+			#pragma omp simd reduction(+:value)
+			for (unsigned k = 0; k < K; k++)
+				value += coeffs[k].real() * coeffsRe[k] - coeffs[k].imag() * coeffsIm[k];
+
+			out[s] = value;
 		}
+	}
+
+	/** Advance the rotating phasors of the inverse transform to the current time. */
+	void irotate()
+	{
+		unsigned K = fharmonics.size();
+
+		phase = (phase + 1) % windowSize;
+		if (phase == 0) {
+			/* Re-synchronize to avoid a drift of magnitude and phase */
+			for (unsigned k = 0; k < K; k++) {
+				auto om = std::exp(2.0i * M_PI * (double) fharmonics[k] * time);
 
-		*out = std::real(value);
+				coeffsRe[k] = om.real();
+				coeffsIm[k] = om.imag();
+			}
+		}
+		else {
+			#pragma omp simd
+			for (unsigned k = 0; k < K; k++) {
+				double re = coeffsRe[k];
+				double im = coeffsIm[k];
+
+				coeffsRe[k] = rotRe[k] * re - rotIm[k] * im;
+				coeffsIm[k] = rotIm[k] * re + rotRe[k] * im;
+			}
+		}
+	}
+
+	void parseSignal(json_t *json_signal)
+	{
+		switch (json_typeof(json_signal)) {
+			case JSON_STRING:
+				signalNames.emplace_back(json_string_value(json_signal));
+				signalIndices.push_back(0);
+				break;
+
+			case JSON_INTEGER:
+				signalNames.emplace_back();
+				signalIndices.push_back(json_integer_value(json_signal));
+				break;
+
+			default:
+				throw ConfigError(json_signal, "node-config-hook-dp-signal", "Invalid value for setting 'signal'");
+		}
 	}
 
 public:
 
 	DPHook(Path *p, Node *n, int fl, int prio, bool en = true) :
 		Hook(p, n, fl, prio, en),
-		signal_name(nullptr),
-		signal_index(0),
 		offset(0),
 		inverse(0),
 		f0(50.0),
 		timestep(50e-6),
 		time(),
-		steps(0),
-		coeffs(),
-		fharmonics(),
-		fharmonics_len(0)
+		windowSize(0),
+		phase(0)
 	{ }
 
-	virtual ~DPHook()
-	{
-		/* Release memory */
-		if (fharmonics)
-			delete fharmonics;
-
-		if (coeffs)
-			delete coeffs;
-
-		if (signal_name)
-			free(signal_name);
-	}
-
 	virtual void start()
 	{
 		assert(state == State::PREPARED);
 
 		time = 0;
-		steps = 0;
-
-		for (int i = 0; i < fharmonics_len; i++)
-			coeffs[i] = 0;
+		phase = 0;
 
-		window = dsp::Window<double>((1.0 / f0) / timestep, 0.0);
+		if (inverse) {
+			/* Phasors exp(j * 2pi * f_k * t) at t = 0 */
+			std::fill(coeffsRe.begin(), coeffsRe.end(), 1.0);
+			std::fill(coeffsIm.begin(), coeffsIm.end(), 0.0);
+		}
+		else {
+			std::fill(history.begin(), history.end(), 0.0);
+			std::fill(coeffsRe.begin(), coeffsRe.end(), 0.0);
+			std::fill(coeffsIm.begin(), coeffsIm.end(), 0.0);
+		}
 
 		state = State::STARTED;
 	}
@@ -145,15 +234,18 @@ public:
 	{
 		int ret;
 		json_error_t err;
-		json_t *json_harmonics, *json_harmonic, *json_signal;
+		json_t *json_harmonics, *json_harmonic;
+		json_t *json_signal = nullptr;
+		json_t *json_signals = nullptr;
 		size_t i;
 
 		Hook::parse(json);
 
 		double rate = -1, dt = -1;
 
-		ret = json_unpack_ex(json, &err, 0, "{ s: o, s: F, s?: F, s?: F, s: o, s?: b }",
+		ret = json_unpack_ex(json, &err, 0, "{ s?: o, s?: o, s: F, s?: F, s?: F, s: o, s?: b }",
 			"signal", &json_signal,
+			"signals", &json_signals,
 			"f0", &f0,
 			"dt", &dt,
 			"rate", &rate,
@@ -173,89 +265,176 @@ public:
 		if (!json_is_array(json_harmonics))
 			throw ConfigError(json_harmonics, "node-config-hook-dp-harmonics", "Setting 'harmonics' must be a list of integers");
 
-		switch (json_typeof(json_signal)) {
-			case JSON_STRING:
-				signal_name = strdup(json_string_value(json_signal));
-				break;
+		signalNames.clear();
+		signalIndices.clear();
 
-			case JSON_INTEGER:
-				signal_name = nullptr;
-				signal_index = json_integer_value(json_signal);
-				break;
+		if (json_signals) {
+			if (!json_is_array(json_signals))
+				throw ConfigError(json_signals, "node-config-hook-dp-signals", "Setting 'signals' must be a list of signal names or indices");
 
-			default:
-				throw ConfigError(json_signal, "node-config-hook-dp-signal", "Invalid value for setting 'signal'");
+			json_array_foreach(json_signals, i, json_signal)
+				parseSignal(json_signal);
 		}
+		else if (json_signal)
+			parseSignal(json_signal);
+		else
+			throw ConfigError(json, "node-config-hook-dp-signal", "Missing 'signal' or 'signals' setting");
 
-		fharmonics_len = json_array_size(json_harmonics);
-		fharmonics = new int[fharmonics_len];
-		coeffs = new std::complex<double>[fharmonics_len];
-		if (!fharmonics || !coeffs)
-			throw MemoryAllocationError();
-
+		fharmonics.clear();
 		json_array_foreach(json_harmonics, i, json_harmonic) {
 			if (!json_is_integer(json_harmonic))
 				throw ConfigError(json_harmonic, "node-config-hook-dp-harmonics", "Setting 'harmonics' must be a list of integers");
 
-			fharmonics[i] = json_integer_value(json_harmonic);
+			fharmonics.push_back(json_integer_value(json_harmonic));
 		}
 
 		state = State::PARSED;
 	}
 
+	virtual void check()
+	{
+		assert(state == State::PARSED);
+
+		windowSize = (1.0 / f0) / timestep;
+		if (windowSize == 0)
+			throw RuntimeError("The timestep must be smaller than the period of the fundamental frequency");
+
+		if (signalIndices.empty())
+			throw RuntimeError("At least a single signal must be provided");
+
+		state = State::CHECKED;
+	}
+
 	virtual void prepare()
 	{
 		assert(state == State::CHECKED);
 
-		char *new_sig_name;
+		unsigned N = windowSize;
+		unsigned K = fharmonics.size();
+		unsigned S = signalIndices.size();
 
-		assert(state != State::STARTED);
+		for (unsigned s = 0; s < S; s++) {
+			if (signalNames[s].empty())
+				continue;
 
-		if (signal_name) {
-			signal_index = signals->getIndexByName(signal_name);
-			if (signal_index < 0)
-				throw RuntimeError("Failed to find signal: {}", signal_name);
+			int index = signals->getIndexByName(signalNames[s]);
+			if (index < 0)
+				throw RuntimeError("Failed to find signal: {}", signalNames[s]);
+
+			signalIndices[s] = index;
+		}
+
+		/* Signals are removed from the back to keep the remaining indices valid */
+		removeOrder = signalIndices;
+		std::sort(removeOrder.begin(), removeOrder.end(), std::greater<unsigned>());
+
+		unsigned width = inverse ? K : 1;
+		for (unsigned s = 1; s < S; s++) {
+			if (removeOrder[s - 1] < removeOrder[s] + width)
+				throw RuntimeError("Input signals must not overlap");
 		}
 
+		std::vector<Signal::Ptr> newSigs;
+
 		if (inverse) {
 			/* Remove complex-valued coefficient signals */
-			for (int i = 0; i < fharmonics_len; i++) {
-				auto orig_sig = signals->getByIndex(signal_index + i);
-				if (!orig_sig)
+			for (unsigned s = 0; s < S; s++) {
+				for (unsigned k = 0; k < K; k++) {
+					if (signalIndices[s] + k >= signals->size())
+						throw RuntimeError("Failed to find signal");
+
+					auto orig_sig = signals->getByIndex(signalIndices[s] + k);
+					if (orig_sig->type != SignalType::COMPLEX)
+						throw RuntimeError("Signal is not complex");
+				}
+			}
+
+			for (auto index : removeOrder)
+				signals->erase(signals->begin() + index, signals->begin() + index + K);
+
+			/* Add new real-valued reconstructed signals */
+			for (unsigned s = 0; s < S; s++) {
+				auto new_sig = std::make_shared<Signal>(S > 1 ? fmt::format("dp{}", s) : "dp", "idp", SignalType::FLOAT);
+				if (!new_sig)
+					throw RuntimeError("Failed to create signal");
+
+				newSigs.push_back(new_sig);
+			}
+		}
+		else {
+			for (unsigned s = 0; s < S; s++) {
+				if (signalIndices[s] >= signals->size())
 					throw RuntimeError("Failed to find signal");
 
-				if (orig_sig->type != SignalType::COMPLEX)
-					throw RuntimeError("Signal is not complex");
+				auto orig_sig = signals->getByIndex(signalIndices[s]);
+				if (orig_sig->type != SignalType::FLOAT)
+					throw RuntimeError("Signal is not float");
 
-				signals->erase(signals->begin() + signal_index + i);
+				for (unsigned k = 0; k < K; k++) {
+					auto new_sig = std::make_shared<Signal>(fmt::format("{}_harm{}", orig_sig->name, k), orig_sig->unit, SignalType::COMPLEX);
+					if (!new_sig)
+						throw RuntimeError("Failed to create new signal");
+
+					newSigs.push_back(new_sig);
+				}
 			}
 
-			/* Add new real-valued reconstructed signals */
-			auto new_sig = std::make_shared<Signal>("dp", "idp", SignalType::FLOAT);
-			if (!new_sig)
-				throw RuntimeError("Failed to create signal");
+			for (auto index : removeOrder)
+				signals->erase(signals->begin() + index);
+		}
+
+		if ((unsigned) offset > signals->size())
+			throw RuntimeError("Invalid offset: {}", offset);
+
+		signals->insert(signals->begin() + offset, newSigs.begin(), newSigs.end());
 
-			signals->insert(signals->begin() + offset, new_sig);
+		/* Precompute rotation factors, twiddles and correction tables */
+		rotRe.resize(K);
+		rotIm.resize(K);
+
+		if (inverse) {
+			for (unsigned k = 0; k < K; k++) {
+				auto rot = std::exp(2.0i * M_PI * (double) fharmonics[k] * timestep);
+
+				rotRe[k] = rot.real();
+				rotIm[k] = rot.imag();
+			}
+
+			coeffsRe.resize(K);
+			coeffsIm.resize(K);
 		}
 		else {
-			auto orig_sig = signals->getByIndex(signal_index);
-			if (!orig_sig)
-				throw RuntimeError("Failed to find signal");
+			twRe.resize(K * N);
+			twIm.resize(K * N);
+			corrRe.resize(N * K);
+			corrIm.resize(N * K);
 
-			if (orig_sig->type != SignalType::FLOAT)
-				throw RuntimeError("Signal is not float");
+			for (unsigned k = 0; k < K; k++) {
+				std::complex<double> om_k = 2.0i * M_PI * (double) fharmonics[k] / (double) N;
 
-			signals->erase(signals->begin() + signal_index);
+				auto rot = std::exp(-om_k);
 
-			for (int i = 0; i < fharmonics_len; i++) {
-				new_sig_name = strf("%s_harm%d", orig_sig->name, i);
+				rotRe[k] = rot.real();
+				rotIm[k] = rot.imag();
 
-				auto new_sig = std::make_shared<Signal>(new_sig_name, orig_sig->unit, SignalType::COMPLEX);
-				if (!new_sig)
-					throw RuntimeError("Failed to create new signal");
+				for (unsigned n = 0; n < N; n++) {
+					auto tw = std::exp(om_k * (double) n);
 
-				signals->insert(signals->begin() + offset, new_sig);
+					twRe[k * N + n] = tw.real();
+					twIm[k * N + n] = tw.imag();
+
+					/* The correction is periodic in the window size
+					 * as all harmonics are integer multiples of f0 */
+					auto corr = 1.0 / (std::exp(-om_k * ((double) n - (N + 1))) * (double) N);
+
+					corrRe[n * K + k] = corr.real();
+					corrIm[n * K + k] = corr.imag();
+				}
 			}
+
+			history.resize(S * N);
+			coeffsRe.resize(S * K);
+			coeffsIm.resize(S * K);
 		}
 
 		state = State::PREPARED;
@@ -263,30 +442,50 @@ public:
 
 	virtual Hook::Reason process(struct Sample *smp)
 	{
-		if (signal_index >= smp->length)
-			return Hook::Reason::ERROR;
+		unsigned K = fharmonics.size();
+		unsigned S = signalIndices.size();
 
 		if (inverse) {
-			double signal;
-			std::complex<float> *coeffs = reinterpret_cast<std::complex<float> *>(&smp->data[signal_index].z);
+			const std::complex<float> *coeffs[S];
+			double values[S];
+
+			for (unsigned s = 0; s < S; s++) {
+				if (signalIndices[s] + K > smp->length)
+					return Hook::Reason::ERROR;
+
+				coeffs[s] = reinterpret_cast<std::complex<float> *>(&smp->data[signalIndices[s]].z);
+			}
 
-			istep(coeffs, &signal);
+			istep(coeffs, values);
 
-			sample_data_remove(smp, signal_index, fharmonics_len);
-			sample_data_insert(smp, (union SignalData *) &signal, offset, 1);
+			for (auto index : removeOrder)
+				sample_data_remove(smp, index, K);
+
+			sample_data_insert(smp, (union SignalData *) values, offset, S);
 		}
 		else {
-			double signal = smp->data[signal_index].f;
-			std::complex<float> coeffs[fharmonics_len];
+			double values[S];
+			std::complex<float> coeffs[S * K];
+
+			for (unsigned s = 0; s < S; s++) {
+				if (signalIndices[s] >= smp->length)
+					return Hook::Reason::ERROR;
+
+				values[s] = smp->data[signalIndices[s]].f;
+			}
+
+			step(values, coeffs);
 
-			step(&signal, coeffs);
+			for (auto index : removeOrder)
+				sample_data_remove(smp, index, 1);
 
-			sample_data_remove(smp, signal_index, 1);
-			sample_data_insert(smp, (union SignalData *) coeffs, offset, fharmonics_len);
+			sample_data_insert(smp, (union SignalData *) coeffs, offset, S * K);
 		}
 
 		time += timestep;
-		steps++;
+
+		if (inverse)
+			irotate();
 
 		return Reason::OK;
 	}
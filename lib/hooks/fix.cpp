@@ -11,6 +11,7 @@
 #include <villas/node.hpp>
 #include <villas/sample.hpp>
 #include <villas/timing.hpp>
+#include <villas/clock.hpp>
 
 namespace villas {
 namespace node {
@@ -24,15 +25,14 @@ public:
 	{
 		assert(state == State::STARTED);
 
-		timespec now = time_now();
-
 		if (!(smp->flags & (int) SampleFlags::HAS_SEQUENCE) && node) {
 			smp->sequence = node->sequence++;
 			smp->flags |= (int) SampleFlags::HAS_SEQUENCE;
 		}
 
 		if (!(smp->flags & (int) SampleFlags::HAS_TS_RECEIVED)) {
-			smp->ts.received = now;
+			/* Only read the clock if the node did not provide a receive timestamp */
+			smp->ts.received = clock_now();
 			smp->flags |= (int) SampleFlags::HAS_TS_RECEIVED;
 		}
 
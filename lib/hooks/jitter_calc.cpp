@@ -11,6 +11,7 @@
 
 #include <villas/hook.hpp>
 #include <villas/timing.hpp>
+#include <villas/clock.hpp>
 #include <villas/sample.hpp>
 #include <villas/utils.hpp>
 
@@ -56,7 +57,7 @@ public:
 	{
 		assert(state == State::STARTED);
 
-		timespec now = time_now();
+		timespec now = clock_now();
 		int64_t delay_sec, delay_nsec, curr_delay_us;
 
 		delay_sec = now.tv_sec - smp->ts.origin.tv_sec;
@@ -8,6 +8,7 @@
 #include <cstring>
 
 #include <villas/timing.hpp>
+#include <villas/clock.hpp>
 #include <villas/sample.hpp>
 #include <villas/hooks/limit_rate.hpp>
 
@@ -56,7 +57,7 @@ Hook::Reason LimitRateHook::process(struct Sample *smp)
 	timespec next;
 	switch (mode) {
 		case LIMIT_RATE_LOCAL:
-			next = time_now();
+			next = clock_now();
 			break;
 
 		case LIMIT_RATE_ORIGIN:
@@ -13,6 +13,7 @@
 #include <villas/stats.hpp>
 #include <villas/node.hpp>
 #include <villas/timing.hpp>
+#include <villas/clock.hpp>
 
 namespace villas {
 namespace node {
@@ -220,7 +221,7 @@ public:
 
 Hook::Reason StatsWriteHook::process(struct Sample *smp)
 {
-	timespec now = time_now();
+	timespec now = clock_now();
 
 	parent->stats->update(Stats::Metric::AGE, time_delta(&smp->ts.received, &now));
 
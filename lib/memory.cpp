@@ -5,6 +5,7 @@
  * @license Apache 2.0
  *********************************************************************************/
 
+#include <mutex>
 #include <unordered_map>
 
 #include <unistd.h>
@@ -26,6 +27,7 @@ using namespace villas::node;
 using namespace villas::node::memory;
 
 static std::unordered_map<void *, struct Allocation *> allocations;
+static std::mutex allocations_mutex; /* Elastic pools allocate from multiple threads at runtime */
 static Logger logger;
 
 int villas::node::memory::init(int hugepages)
@@ -114,7 +116,10 @@ void * villas::node::memory::alloc_aligned(size_t len, size_t alignment, struct
 		return nullptr;
 	}
 
-	allocations[ma->address] = ma;
+	{
+		std::lock_guard<std::mutex> guard(allocations_mutex);
+		allocations[ma->address] = ma;
+	}
 
 	logger->debug("Allocated {:#x} bytes of {:#x}-byte-aligned {} memory: {}", ma->length, ma->alignment, ma->type->name, ma->address);
 
@@ -125,11 +130,15 @@ int villas::node::memory::free(void *ptr)
 {
 	int ret;
 
+	std::lock_guard<std::mutex> guard(allocations_mutex);
+
 	/* Find corresponding memory allocation entry */
-	struct Allocation *ma = allocations[ptr];
-	if (!ma)
+	auto iter = allocations.find(ptr);
+	if (iter == allocations.end())
 		return -1;
 
+	struct Allocation *ma = iter->second;
+
 	logger->debug("Releasing {:#x} bytes of {} memory: {}", ma->length, ma->type->name, ma->address);
 
 	ret = ma->type->free(ma, ma->type);
@@ -137,10 +146,6 @@ int villas::node::memory::free(void *ptr)
 		return ret;
 
 	/* Remove allocation entry */
-	auto iter = allocations.find(ptr);
-	if (iter == allocations.end())
-		return -1;
-
 	allocations.erase(iter);
 	delete ma;
 
@@ -149,6 +154,8 @@ int villas::node::memory::free(void *ptr)
 
 struct Allocation * villas::node::memory::get_allocation(void *ptr)
 {
+	std::lock_guard<std::mutex> guard(allocations_mutex);
+
 	return allocations[ptr];
 }
 
@@ -6,6 +6,7 @@
  *********************************************************************************/
 
 #include <regex>
+#include <chrono>
 #include <cstring>
 #include <cctype>
 #include <openssl/md5.h>
@@ -23,6 +24,8 @@
 #include <villas/node_list.hpp>
 #include <villas/path.hpp>
 #include <villas/utils.hpp>
+#include <villas/node/log.hpp>
+#include <villas/node/trace.hpp>
 #include <villas/uuid.hpp>
 #include <villas/colors.hpp>
 #include <villas/mapping.hpp>
@@ -176,7 +179,7 @@ int Node::parse(json_t *json, const uuid_t sn_uuid)
 		{ "out", &out }
 	};
 
-	const char *fields[] = { "signals", "builtin", "vectorize", "hooks" };
+	const char *fields[] = { "signals", "builtin", "vectorize", "adaptive", "hooks" };
 
 	for (unsigned j = 0; j < ARRAY_LEN(dirs); j++) {
 		json_t *json_dir = json_object_get(json, dirs[j].str);
@@ -298,6 +301,32 @@ int Node::restart()
 	return 0;
 }
 
+int Node::reloadHooks(json_t *json)
+{
+	logger->info("Reloading hooks of node");
+
+	struct {
+		const char *str;
+		struct NodeDirection *dir;
+	} dirs[] = {
+		{ "in", &in },
+		{ "out", &out }
+	};
+
+	for (unsigned j = 0; j < ARRAY_LEN(dirs); j++) {
+		json_t *json_dir = json_object_get(json, dirs[j].str);
+
+		/* Hooks of the node are used unless the direction has its own */
+		json_t *json_hooks = json_dir ? json_object_get(json_dir, "hooks") : nullptr;
+		if (!json_hooks)
+			json_hooks = json_object_get(json, "hooks");
+
+		dirs[j].dir->replaceHooks(json_hooks);
+	}
+
+	return 0;
+}
+
 int Node::read(struct Sample * smps[], unsigned cnt)
 {
 	int toread, readd, nread = 0;
@@ -312,6 +341,10 @@ int Node::read(struct Sample * smps[], unsigned cnt)
 	if (!vect)
 		vect = cnt;
 
+	auto start = std::chrono::steady_clock::now();
+
+	VILLAS_TRACE(node_read_start, getName().c_str(), cnt);
+
 	while (cnt - nread > 0) {
 		toread = MIN(cnt - nread, vect);
 		readd = _read(&smps[nread], toread);
@@ -319,6 +352,23 @@ int Node::read(struct Sample * smps[], unsigned cnt)
 			return readd;
 
 		nread += readd;
+
+		/* Do not wait for a full batch if there is no backlog */
+		if (in.adaptive.enabled && readd < toread)
+			break;
+	}
+
+	VILLAS_TRACE(node_read_done, getName().c_str(), cnt, nread);
+
+	if (VILLAS_TRACE_ENABLED(node_read_sample)) {
+		for (int i = 0; i < nread; i++)
+			VILLAS_TRACE(node_read_sample, getName().c_str(), smps[i], smps[i]->sequence);
+	}
+
+	if (in.adaptive.enabled) {
+		std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+
+		in.adapt(cnt, nread, duration.count());
 	}
 
 #ifdef WITH_HOOKS
@@ -332,14 +382,14 @@ int Node::read(struct Sample * smps[], unsigned cnt)
 		if (stats != nullptr)
 			stats->update(Stats::Metric::SMPS_SKIPPED, skipped);
 
-		logger->debug("Received {} samples of which {} have been skipped", nread, skipped);
+		VILLAS_LOG_DEBUG(logger, "Received {} samples of which {} have been skipped", nread, skipped);
 	}
 	else
-		logger->debug("Received {} samples", nread);
+		VILLAS_LOG_DEBUG(logger, "Received {} samples", nread);
 
 	return rread;
 #else
-	logger->debug("Received {} samples", nread);
+	VILLAS_LOG_DEBUG(logger, "Received {} samples", nread);
 
 	return nread;
 #endif /* WITH_HOOKS */
@@ -355,6 +405,8 @@ int Node::write(struct Sample * smps[], unsigned cnt)
 	else if (state != State::STARTED && state != State::CONNECTED)
 		return -1;
 
+	VILLAS_TRACE(node_write_start, getName().c_str(), cnt);
+
 #ifdef WITH_HOOKS
 	/* Run write hooks */
 	cnt = out.hooks.process(smps, cnt);
@@ -373,7 +425,14 @@ int Node::write(struct Sample * smps[], unsigned cnt)
 			return sent;
 
 		nsent += sent;
-		logger->debug("Sent {} samples", sent);
+		VILLAS_LOG_DEBUG(logger, "Sent {} samples", sent);
+	}
+
+	VILLAS_TRACE(node_write_done, getName().c_str(), cnt, nsent);
+
+	if (VILLAS_TRACE_ENABLED(node_write_sample)) {
+		for (int i = 0; i < nsent; i++)
+			VILLAS_TRACE(node_write_sample, getName().c_str(), smps[i], smps[i]->sequence);
 	}
 
 	return nsent;
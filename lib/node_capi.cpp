@@ -7,7 +7,13 @@
  **********************************************************************************/
 
 
+#include <algorithm>
+#include <limits>
+
 #include <villas/node.hpp>
+#include <villas/pool.hpp>
+#include <villas/sample.hpp>
+#include <villas/utils.hpp>
 
 extern "C" {
 	#include <villas/node.h>
@@ -110,6 +116,18 @@ unsigned node_output_signals_max_cnt(vnode *n)
 	return nc->getOutputSignalsMaxCount();
 }
 
+unsigned node_input_vectorize(vnode *n)
+{
+	auto *nc = (Node *) n;
+	return nc->in.vectorize;
+}
+
+unsigned node_output_vectorize(vnode *n)
+{
+	auto *nc = (Node *) n;
+	return nc->out.vectorize;
+}
+
 int node_reverse(vnode *n)
 {
 	auto *nc = (Node *) n;
@@ -220,6 +238,103 @@ void sample_decref(vsample *smp)
 	sample_decref((Sample *) smp);
 }
 
+vpool * pool_new(unsigned cnt, unsigned len)
+{
+	auto *p = new struct Pool();
+
+	int ret = pool_init(p, cnt, SAMPLE_LENGTH(len));
+	if (ret) {
+		delete p;
+		return nullptr;
+	}
+
+	return (vpool *) p;
+}
+
+int pool_delete(vpool *p)
+{
+	auto *pc = (Pool *) p;
+
+	int ret = pool_destroy(pc);
+	if (ret)
+		return ret;
+
+	delete pc;
+
+	return 0;
+}
+
+int sample_alloc_many(vpool *p, vsample **smps, unsigned cnt)
+{
+	return villas::node::sample_alloc_many((Pool *) p, (Sample **) smps, cnt);
+}
+
+void sample_decref_many(vsample **smps, unsigned cnt)
+{
+	villas::node::sample_decref_many((Sample **) smps, cnt);
+}
+
+int sample_pack_many(vsample **smps, unsigned cnt, const uint64_t *seq, const struct timespec *ts_origin, const struct timespec *ts_received, const unsigned *lens, unsigned len, const double *values)
+{
+	for (unsigned i = 0; i < cnt; i++) {
+		auto *smp = (Sample *) smps[i];
+		unsigned l = lens ? MIN(lens[i], len) : len;
+
+		smp->length = MIN(l, smp->capacity);
+		smp->flags = (int) SampleFlags::HAS_DATA;
+
+		if (seq) {
+			smp->sequence = seq[i];
+			smp->flags |= (int) SampleFlags::HAS_SEQUENCE;
+		}
+
+		if (ts_origin) {
+			smp->ts.origin = ts_origin[i];
+			if (ts_origin[i].tv_sec || ts_origin[i].tv_nsec)
+				smp->flags |= (int) SampleFlags::HAS_TS_ORIGIN;
+		}
+
+		if (ts_received) {
+			smp->ts.received = ts_received[i];
+			if (ts_received[i].tv_sec || ts_received[i].tv_nsec)
+				smp->flags |= (int) SampleFlags::HAS_TS_RECEIVED;
+		}
+
+		memcpy((double *) smp->data, values + (size_t) i * len, sizeof(double) * smp->length);
+	}
+
+	return cnt;
+}
+
+int sample_unpack_many(vsample **smps, unsigned cnt, uint64_t *seq, struct timespec *ts_origin, struct timespec *ts_received, int *flags, unsigned *lens, unsigned len, double *values)
+{
+	for (unsigned i = 0; i < cnt; i++) {
+		auto *smp = (Sample *) smps[i];
+		auto *row = values + (size_t) i * len;
+		unsigned l = MIN(len, smp->length);
+
+		if (seq)
+			seq[i] = smp->sequence;
+
+		if (ts_origin)
+			ts_origin[i] = smp->ts.origin;
+
+		if (ts_received)
+			ts_received[i] = smp->ts.received;
+
+		if (flags)
+			flags[i] = smp->flags;
+
+		if (lens)
+			lens[i] = l;
+
+		memcpy(row, (double *) smp->data, sizeof(double) * l);
+		std::fill(row + l, row + len, std::numeric_limits<double>::quiet_NaN());
+	}
+
+	return cnt;
+}
+
 int memory_init(int hugepages)
 {
 	return memory::init(hugepages);
@@ -13,6 +13,7 @@
 #include <villas/utils.hpp>
 #include <villas/node_direction.hpp>
 #include <villas/exceptions.hpp>
+#include <villas/stats.hpp>
 #include <villas/node_compat_type.hpp>
 
 using namespace villas;
@@ -26,6 +27,7 @@ NodeDirection::NodeDirection(enum NodeDirection::Direction dir, Node *n) :
 	enabled(1),
 	builtin(1),
 	vectorize(1),
+	adaptive{ 0, 1e-3, 0, 1 },
 	config(nullptr)
 { }
 
@@ -36,19 +38,36 @@ int NodeDirection::parse(json_t *json)
 	json_error_t err;
 	json_t *json_hooks = nullptr;
 	json_t *json_signals = nullptr;
+	json_t *json_adaptive = nullptr;
 
 	config = json;
 
-	ret = json_unpack_ex(json, &err, 0, "{ s?: o, s?: o, s?: i, s?: b, s?: b }",
+	ret = json_unpack_ex(json, &err, 0, "{ s?: o, s?: o, s?: i, s?: b, s?: b, s?: o }",
 		"hooks", &json_hooks,
 		"signals", &json_signals,
 		"vectorize", &vectorize,
 		"builtin", &builtin,
-		"enabled", &enabled
+		"enabled", &enabled,
+		"adaptive", &json_adaptive
 	);
 	if (ret)
 		throw ConfigError(json, err, "node-config-node-in");
 
+	if (json_is_boolean(json_adaptive))
+		adaptive.enabled = json_boolean_value(json_adaptive);
+	else if (json_is_object(json_adaptive)) {
+		adaptive.enabled = 1;
+
+		ret = json_unpack_ex(json_adaptive, &err, 0, "{ s?: b, s?: F }",
+			"enabled", &adaptive.enabled,
+			"latency", &adaptive.latency
+		);
+		if (ret)
+			throw ConfigError(json_adaptive, err, "node-config-node-adaptive");
+	}
+	else if (json_adaptive)
+		throw ConfigError(json_adaptive, "node-config-node-adaptive", "Setting 'adaptive' must be a boolean or an object");
+
 	if (node->getFactory()->getFlags() & (int) NodeFactory::Flags::PROVIDES_SIGNALS) {
 		/* Do nothing.. Node-type will provide signals */
 		signals = std::make_shared<SignalList>();
@@ -128,6 +147,9 @@ void NodeDirection::check()
 	if (vectorize <= 0)
 		throw RuntimeError("Invalid setting 'vectorize' with value {}. Must be natural number!", vectorize);
 
+	if (adaptive.enabled && adaptive.latency <= 0)
+		throw RuntimeError("Invalid setting 'adaptive.latency' with value {}. Must be positive!", adaptive.latency);
+
 #ifdef WITH_HOOKS
 	hooks.check();
 #endif /* WITH_HOOKS */
@@ -147,6 +169,9 @@ int NodeDirection::prepare()
 
 int NodeDirection::start()
 {
+	adaptive.cost.store(0, std::memory_order_relaxed);
+	adaptive.current.store(1, std::memory_order_relaxed);
+
 #ifdef WITH_HOOKS
 	hooks.start();
 #endif /* WITH_HOOKS */
@@ -163,6 +188,21 @@ int NodeDirection::stop()
 	return 0;
 }
 
+void NodeDirection::replaceHooks(json_t *json_hooks)
+{
+#ifdef WITH_HOOKS
+	int t = direction == NodeDirection::Direction::OUT ? (int) Hook::Flags::NODE_WRITE : (int) Hook::Flags::NODE_READ;
+	int m = builtin ? t | (int) Hook::Flags::BUILTIN : 0;
+
+	bool running = node->getState() == State::STARTED ||
+	               node->getState() == State::PAUSED;
+
+	hooks.replace(json_hooks, t, signals, m, nullptr, node, running);
+#else
+	throw RuntimeError("Hooks are not supported");
+#endif /* WITH_HOOKS */
+}
+
 SignalList::Ptr NodeDirection::getSignals(int after_hooks) const
 {
 #ifdef WITH_HOOKS
@@ -182,3 +222,39 @@ unsigned NodeDirection::getSignalsMaxCount() const
 
 	return signals->size();
 }
+
+void NodeDirection::adapt(unsigned requested, unsigned cnt, double duration)
+{
+	if (!adaptive.enabled)
+		return;
+
+	/* The batch size only varies with adaptive vectorization */
+	auto stats = node->getStats();
+	if (stats != nullptr)
+		stats->update(direction == Direction::IN ? Stats::Metric::BATCH_IN : Stats::Metric::BATCH_OUT, cnt);
+
+	/* No backlog: shrink to what has been available */
+	if (cnt < requested) {
+		adaptive.current.store(MAX(cnt, 1U), std::memory_order_relaxed);
+		return;
+	}
+
+	/* Exponential moving average of the time per sample */
+	double cost = duration / cnt;
+	double avg = adaptive.cost.load(std::memory_order_relaxed);
+
+	avg = avg > 0
+		? avg + 0.25 * (cost - avg)
+		: cost;
+
+	adaptive.cost.store(avg, std::memory_order_relaxed);
+
+	/* Backlog: grow as long as a full batch stays within the latency bound */
+	unsigned limit = avg > 0
+		? MIN((double) vectorize, adaptive.latency / avg)
+		: vectorize;
+
+	unsigned current = adaptive.current.load(std::memory_order_relaxed);
+
+	adaptive.current.store(MAX(MIN(2 * current, limit), 1U), std::memory_order_relaxed);
+}
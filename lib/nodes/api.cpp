@@ -9,6 +9,7 @@
 #include <vector>
 
 #include <villas/exceptions.hpp>
+#include <villas/utils.hpp>
 #include <villas/api/universal.hpp>
 #include <villas/nodes/api.hpp>
 
@@ -19,42 +20,25 @@ using namespace villas::node::api::universal;
 APINode::APINode(const std::string &name) :
 	Node(name),
 	read(),
-	write()
-{
-	int ret;
-	auto dirs = std::vector{&read, &write};
-
-	for (auto dir : dirs) {
-		ret = pthread_mutex_init(&dir->mutex, nullptr);
-		if (ret)
-			throw RuntimeError("failed to initialize mutex");
-
-		ret = pthread_cond_init(&dir->cv, nullptr);
-		if (ret)
-			throw RuntimeError("failed to initialize mutex");
-	}
-}
+	write(),
+	lastRead(0)
+{ }
 
 int APINode::prepare()
 {
-	auto signals_in = getInputSignals(false);
-
-	read.sample = sample_alloc_mem(signals_in->size());
-	if (!read.sample)
-		throw MemoryAllocationError();
+	std::atomic_store(&read.mailbox, std::make_shared<SampleMailbox>(getInputSignals(false)));
 
-	write.sample = sample_alloc_mem(64);
-	if (!write.sample)
-		throw MemoryAllocationError();
+	return Node::prepare();
+}
 
-	unsigned j = 0;
-	for (auto sig : *signals_in)
-		read.sample->data[j++] = sig->init;
+int APINode::start()
+{
+	/* The output signals are known once the paths have been prepared */
+	auto sigs = getOutputSignals();
 
-	read.sample->length = j;
-	read.sample->signals = signals_in;
+	std::atomic_store(&write.mailbox, std::make_shared<SampleMailbox>(sigs, MAX(getOutputSignalsMaxCount(), 64U)));
 
-	return Node::prepare();
+	return Node::start();
 }
 
 int APINode::check()
@@ -76,22 +60,20 @@ int APINode::_read(struct Sample *smps[], unsigned cnt)
 {
 	assert(cnt == 1);
 
-	pthread_cond_wait(&read.cv, &read.mutex);
+	/* Wait for new values from the API */
+	read.mailbox->wait(lastRead);
 
-	sample_copy(smps[0], read.sample);
+	lastRead = read.mailbox->get(smps[0]);
 
 	return 1;
 }
 
 int APINode::_write(struct Sample *smps[], unsigned cnt)
 {
-	assert(cnt == 1);
+	for (unsigned i = 0; i < cnt; i++)
+		write.mailbox->put(smps[i]);
 
-	sample_copy(write.sample, smps[0]);
-
-	pthread_cond_signal(&write.cv);
-
-	return 1;
+	return cnt;
 }
 
 int APINode::parse(json_t *json, const uuid_t sn_uuid)
@@ -22,9 +22,12 @@
 #include <villas/node_compat.hpp>
 #include <villas/nodes/can.hpp>
 #include <villas/utils.hpp>
+#include <villas/node/log.hpp>
 #include <villas/sample.hpp>
 #include <villas/signal.hpp>
 #include <villas/exceptions.hpp>
+#include <villas/stats.hpp>
+#include <villas/clock.hpp>
 
 using namespace villas;
 using namespace villas::node;
@@ -43,6 +46,8 @@ int villas::node::can_init(NodeCompat *n)
 	c->sample_buf_num = 0;
 	c->in = nullptr;
 	c->out = nullptr;
+	c->timestamping.mode = TimestampingMode::NONE;
+	c->timestamping.tx = 0;
 
 	return 0;
 }
@@ -112,13 +117,15 @@ int villas::node::can_parse(NodeCompat *n, json_t *json)
 	json_t *json_in_signals;
 	json_t *json_out_signals;
 	json_t *json_signal;
+	json_t *json_timestamping = nullptr;
 	json_error_t err;
 
 	c->in = nullptr;
 	c->out = nullptr;
 
-	ret = json_unpack_ex(json, &err, 0, "{ s: s, s?: { s?: o }, s?: { s?: o } }",
+	ret = json_unpack_ex(json, &err, 0, "{ s: s, s?: o, s?: { s?: o }, s?: { s?: o } }",
 		"interface_name", &c->interface_name,
+		"timestamping", &json_timestamping,
 		"in",
 			"signals", &json_in_signals,
 		"out",
@@ -127,6 +134,12 @@ int villas::node::can_parse(NodeCompat *n, json_t *json)
 	if (ret)
 		throw ConfigError(json, err, "node-config-node-can");
 
+	if (json_timestamping) {
+		ret = timestamping_parse(&c->timestamping, json_timestamping);
+		if (ret)
+			return ret;
+	}
+
 	c->in = (struct can_signal*) calloc(
 			json_array_size(json_in_signals),
 			sizeof(struct can_signal));
@@ -208,6 +221,10 @@ int villas::node::can_start(NodeCompat *n)
 	if (ret < 0)
 		throw SystemError("Could not bind to interface with name '{}' ({}).", c->interface_name, ifr.ifr_ifindex);
 
+	ret = timestamping_start(&c->timestamping, c->socket, c->interface_name);
+	if (ret)
+		throw SystemError("Failed to enable timestamping for interface '{}'", c->interface_name);
+
 	return 0;
 }
 
@@ -365,26 +382,32 @@ int villas::node::can_read(NodeCompat *n, struct Sample * const smps[], unsigned
 	unsigned nread = 0;
 	struct can_frame frame;
 	struct timeval tv;
+	struct timespec ts;
 	bool found_id = false;
 
 	auto *c = n->getData<struct can>();
 
 	assert(cnt >= 1 && smps[0]->capacity >= 1);
 
-	nbytes = read(c->socket, &frame, sizeof(struct can_frame));
+	nbytes = timestamping_recv(&c->timestamping, c->socket, &frame, sizeof(struct can_frame), 0, nullptr, nullptr, &ts);
 	if (nbytes == -1)
 		throw RuntimeError("CAN read() returned -1. Is the CAN interface up?");
 
 	if ((unsigned)nbytes != sizeof(struct can_frame))
 		throw RuntimeError("CAN read() error. Returned {} bytes but expected {}", nbytes, sizeof(struct can_frame));
 
-	n->logger->debug("Received can message: (id={}, len={}, data={:#x}:{:#x})",
+	VILLAS_LOG_DEBUG(n->logger, "Received can message: (id={}, len={}, data={:#x}:{:#x})",
 		frame.can_id,
 		frame.can_dlc,
 		((uint32_t*)&frame.data)[0],
 		((uint32_t*)&frame.data)[1]);
 
-	if (ioctl(c->socket, SIOCGSTAMP, &tv) == 0) {
+	/* In hardware mode, we do not fall back to software timestamps as they are taken by a different clock */
+	if (ts.tv_sec || ts.tv_nsec) {
+		smps[nread]->ts.received = ts;
+		smps[nread]->flags |= (int) SampleFlags::HAS_TS_RECEIVED;
+	}
+	else if (c->timestamping.mode != TimestampingMode::HARDWARE && ioctl(c->socket, SIOCGSTAMP, &tv) == 0) {
 		TIMEVAL_TO_TIMESPEC(&tv, &smps[nread]->ts.received);
 		smps[nread]->flags |= (int) SampleFlags::HAS_TS_RECEIVED;
 	}
@@ -406,7 +429,7 @@ int villas::node::can_read(NodeCompat *n, struct Sample * const smps[], unsigned
 	if (!found_id)
 		throw RuntimeError("Did not find signal for can id {}", frame.can_id);
 
-	n->logger->debug("Received {} signals", c->sample_buf_num);
+	VILLAS_LOG_DEBUG(n->logger, "Received {} signals", c->sample_buf_num);
 
 	/* Copy signal data to sample only when all signals have been received */
 	if (c->sample_buf_num == n->getInputSignals(false)->size()) {
@@ -477,22 +500,35 @@ int villas::node::can_write(NodeCompat *n, struct Sample * const smps[], unsigne
 		}
 
 		for (size_t j=0; j < fsize; j++) {
-			n->logger->debug("Writing CAN message: (id={}, dlc={}, data={:#x}:{:#x})",
+			VILLAS_LOG_DEBUG(n->logger, "Writing CAN message: (id={}, dlc={}, data={:#x}:{:#x})",
 				frame[j].can_id,
 				frame[j].can_dlc,
 				((uint32_t*)&frame[j].data)[0],
 				((uint32_t*)&frame[j].data)[1]
 			);
 
+			struct timespec ts_sent = clock_now();
+
 			if ((nbytes = write(c->socket, &frame[j], sizeof(struct can_frame))) == -1)
 				throw RuntimeError("CAN write() returned -1. Is the CAN interface up?");
 
 			if ((unsigned)nbytes != sizeof(struct can_frame))
 				throw RuntimeError("CAN write() returned {} bytes but expected {}",
 					nbytes, sizeof(struct can_frame));
+
+			timestamping_sent(&c->timestamping, &ts_sent);
 		}
 	}
 
+	/* Collect transmit timestamps of previously sent frames */
+	double delays[16];
+	int num = timestamping_tx_delays(&c->timestamping, c->socket, delays, ARRAY_LEN(delays));
+	auto stats = n->getStats();
+	if (stats) {
+		for (int i = 0; i < num; i++)
+			stats->update(Stats::Metric::TX_DELAY, delays[i]);
+	}
+
 	return nwrite;
 }
 
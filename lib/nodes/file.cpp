@@ -16,6 +16,7 @@
 #include <villas/nodes/file.hpp>
 #include <villas/utils.hpp>
 #include <villas/timing.hpp>
+#include <villas/clock.hpp>
 #include <villas/queue.h>
 #include <villas/format.hpp>
 #include <villas/exceptions.hpp>
@@ -75,15 +76,17 @@ int villas::node::file_parse(NodeCompat *n, json_t *json)
 	int ret;
 	json_error_t err;
 	json_t *json_format = nullptr;
+	json_t *json_timer = nullptr;
 
 	const char *uri_tmpl = nullptr;
 	const char *eof = nullptr;
 	const char *epoch = nullptr;
 	double epoch_flt = 0;
 
-	ret = json_unpack_ex(json, &err, 0, "{ s: s, s?: o, s?: { s?: s, s?: F, s?: s, s?: F, s?: i, s?: i }, s?: { s?: b, s?: i } }",
+	ret = json_unpack_ex(json, &err, 0, "{ s: s, s?: o, s?: o, s?: { s?: s, s?: F, s?: s, s?: F, s?: i, s?: i }, s?: { s?: b, s?: i } }",
 		"uri", &uri_tmpl,
 		"format", &json_format,
+		"timer", &json_timer,
 		"in",
 			"eof", &eof,
 			"rate", &f->rate,
@@ -98,6 +101,9 @@ int villas::node::file_parse(NodeCompat *n, json_t *json)
 	if (ret)
 		throw ConfigError(json, err, "node-config-node-file");
 
+	if (json_timer)
+		f->task.parse(json_timer);
+
 	f->epoch = time_from_double(epoch_flt);
 	f->uri_tmpl = uri_tmpl ? strdup(uri_tmpl) : nullptr;
 
@@ -203,6 +209,9 @@ char * villas::node::file_print(NodeCompat *n)
 	if (f->rate)
 		strcatf(&buf, ", in.rate=%.1f", f->rate);
 
+	if (f->task.getSlack() > 0)
+		strcatf(&buf, ", timer.slack=%g", f->task.getSlack());
+
 	if (f->first.tv_sec || f->first.tv_nsec)
 		strcatf(&buf, ", first=%.2f", time_to_double(&f->first));
 
@@ -283,7 +292,8 @@ int villas::node::file_start(NodeCompat *n)
 	}
 
 	/* Create timer */
-	f->task.setRate(f->rate);
+	if (f->rate)
+		f->task.setRate(f->rate);
 
 	/* Get timestamp of first line */
 	if (f->epoch_mode != file::EpochMode::ORIGINAL) {
@@ -325,6 +335,9 @@ int villas::node::file_stop(NodeCompat *n)
 
 	f->task.stop();
 
+	if (f->task.getSlack() > 0)
+		f->task.printStats(n->logger);
+
 	fclose(f->stream_in);
 	fclose(f->stream_out);
 
@@ -381,7 +394,7 @@ retry:	ret = f->formatter->scan(f->stream_in, smps, cnt);
 	if (f->rate) {
 		steps = f->task.wait();
 
-		smps[0]->ts.origin = time_now();
+		smps[0]->ts.origin = clock_now();
 	}
 	else {
 		smps[0]->ts.origin = time_add(&smps[0]->ts.origin, &f->offset);
@@ -438,7 +451,7 @@ int villas::node::file_init(NodeCompat *n)
 {
 	auto *f = n->getData<struct file>();
 
-	new (&f->task) Task(CLOCK_REALTIME);
+	new (&f->task) PrecisionTask(CLOCK_REALTIME);
 
 	/* Default values */
 	f->rate = 0;
@@ -458,7 +471,7 @@ int villas::node::file_destroy(NodeCompat *n)
 {
 	auto *f = n->getData<struct file>();
 
-	f->task.~Task();
+	f->task.~PrecisionTask();
 
 	if (f->uri)
 		delete[] f->uri;
@@ -9,10 +9,10 @@
 #include <villas/nodes/go.hpp>
 #include <villas/plugin.hpp>
 #include <villas/format.hpp>
+#include <villas/utils.hpp>
 
 extern "C" {
 	#include <libvillas-go.h>
-	#include <villas/nodes/go.h>
 }
 
 using namespace villas;
@@ -38,7 +38,10 @@ void _go_logger_log(_go_logger l, int level, char *msg)
 GoNode::GoNode(uintptr_t n) :
 	Node(),
 	node(n),
-	formatter(nullptr)
+	formatter(nullptr),
+	samples(false),
+	convert(false),
+	convert_out(false)
 { }
 
 GoNode::~GoNode()
@@ -63,11 +66,19 @@ int GoNode::parse(json_t *json, const uuid_t sn_uuid)
 	if (ret)
 		throw ConfigError(json, err, "node-config-node-format", "Failed to parse node configuration");
 
-	formatter = json_format
-			? FormatFactory::make(json_format)
-			: FormatFactory::make("json");
-	if (!formatter)
-		throw ConfigError(json_format, "node-config-node-format", "Invalid format configuration");
+	/* Node-types which exchange samples directly do not require a format */
+	samples = GoNodeSupportsSamples(node);
+	if (samples) {
+		if (json_format)
+			logger->warn("Setting 'format' is ignored as node-type {} exchanges samples directly", factory->getName());
+	}
+	else {
+		formatter = json_format
+				? FormatFactory::make(json_format)
+				: FormatFactory::make("json");
+		if (!formatter)
+			throw ConfigError(json_format, "node-config-node-format", "Invalid format configuration");
+	}
 
 	auto *cfg = json_dumps(json, JSON_COMPACT);
 	ret = GoNodeParse(node, cfg);
@@ -101,7 +112,15 @@ int GoNode::start()
 	       state == State::PAUSED);
 
 	/* Initialize IO */
-	formatter->start(getInputSignals(false));
+	if (formatter)
+		formatter->start(getInputSignals(false));
+
+	if (samples) {
+		convert = !isFloat(getInputSignals(false));
+
+		auto sigs = getOutputSignals(true);
+		convert_out = sigs && !isFloat(sigs);
+	}
 
 	ret = GoNodeStart(node);
 	if (ret)
@@ -197,12 +216,92 @@ std::vector<int> GoNode::getNetemFDs()
 	return std::vector<int>(begin, end);
 }
 
+/** Check if all signals are passed to the Go node-type as float64 values without conversion.
+ *
+ * @param len Only check the first \p len signals.
+ * @throws RuntimeError if a signal is complex, as it can not be represented by a single float64.
+ */
+bool GoNode::isFloat(SignalList::Ptr sigs, unsigned len)
+{
+	bool all = true;
+
+	for (unsigned i = 0; i < sigs->size() && i < len; i++) {
+		auto sig = sigs->getByIndex(i);
+
+		if (sig->type == SignalType::COMPLEX)
+			throw RuntimeError("Node-type {} exchanges samples as float64 values and does not support complex signal '{}'", factory->getName(), sig->name);
+
+		if (sig->type != SignalType::FLOAT)
+			all = false;
+	}
+
+	return all;
+}
+
+void GoNode::prepareViews(std::vector<_go_sample> &views, struct Sample * smps[], unsigned cnt)
+{
+	if (views.size() < cnt)
+		views.resize(cnt);
+
+	for (unsigned i = 0; i < cnt; i++) {
+		auto *smp = smps[i];
+		auto *v = &views[i];
+
+		v->sequence = smp->sequence;
+		v->length = smp->length;
+		v->capacity = smp->capacity;
+		v->flags = smp->flags;
+		v->ts_origin[0] = smp->ts.origin.tv_sec;
+		v->ts_origin[1] = smp->ts.origin.tv_nsec;
+		v->ts_received[0] = smp->ts.received.tv_sec;
+		v->ts_received[1] = smp->ts.received.tv_nsec;
+		v->data = &smp->data[0].f;
+	}
+}
+
 int GoNode::_read(struct Sample * smps[], unsigned cnt)
 {
 	int ret;
 	char data[DEFAULT_FORMAT_BUFFER_LENGTH];
 	size_t rbytes;
 
+	if (samples) {
+		prepareViews(views_in, smps, cnt);
+
+		for (unsigned i = 0; i < cnt; i++)
+			views_in[i].length = 0;
+
+		auto r = GoNodeReadSamples(node, views_in.data(), cnt);
+		if (r.r1)
+			return r.r1;
+
+		/* The values have been written in-place, only the header needs to be copied back */
+		for (int i = 0; i < r.r0; i++) {
+			auto *smp = smps[i];
+			auto *v = &views_in[i];
+
+			smp->sequence = v->sequence;
+			smp->length = MIN(v->length, smp->capacity);
+			smp->flags = v->flags;
+			smp->ts.origin.tv_sec = v->ts_origin[0];
+			smp->ts.origin.tv_nsec = v->ts_origin[1];
+			smp->ts.received.tv_sec = v->ts_received[0];
+			smp->ts.received.tv_nsec = v->ts_received[1];
+			smp->signals = in.signals;
+
+			/* The samples are owned by us, so we can convert the values in-place */
+			if (convert) {
+				for (unsigned j = 0; j < smp->length && j < in.signals->size(); j++) {
+					auto type = in.signals->getByIndex(j)->type;
+					if (type != SignalType::FLOAT)
+						smp->data[j] = smp->data[j].cast(SignalType::FLOAT, type);
+				}
+			}
+		}
+
+		return r.r0;
+	}
+
 	auto d = GoNodeRead(node, data, sizeof(data));
 	if (d.r1)
 		return d.r1;
@@ -222,6 +321,49 @@ int GoNode::_write(struct Sample * smps[], unsigned cnt)
 	char buf[DEFAULT_FORMAT_BUFFER_LENGTH];
 	size_t wbytes;
 
+	if (samples) {
+		prepareViews(views_out, smps, cnt);
+
+		/* The samples might be shared with other destinations.
+		 * Hence, values of non-float signals are converted into a separate buffer. */
+		if (convert_out) {
+			size_t total = 0;
+			for (unsigned i = 0; i < cnt; i++)
+				total += smps[i]->length;
+
+			if (values_out.size() < total)
+				values_out.resize(total);
+
+			size_t offset = 0;
+			for (unsigned i = 0; i < cnt; i++) {
+				auto *smp = smps[i];
+
+				if (!smp->signals)
+					continue;
+
+				double *vals = &values_out[offset];
+				for (unsigned j = 0; j < smp->length; j++) {
+					auto sig = smp->signals->getByIndex(j);
+
+					vals[j] = sig
+						? smp->data[j].cast(sig->type, SignalType::FLOAT).f
+						: smp->data[j].f;
+				}
+
+				views_out[i].data = vals;
+				views_out[i].capacity = smp->length;
+
+				offset += smp->length;
+			}
+		}
+
+		auto r = GoNodeWriteSamples(node, views_out.data(), cnt);
+		if (r.r1)
+			return r.r1;
+
+		return r.r0;
+	}
+
 	ret = formatter->sprint(buf, DEFAULT_FORMAT_BUFFER_LENGTH, &wbytes, smps, cnt);
 	if (ret < 0)
 		return ret;
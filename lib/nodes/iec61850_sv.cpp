@@ -10,6 +10,9 @@
 #include <unistd.h>
 
 #include <villas/utils.hpp>
+#include <villas/timing.hpp>
+#include <villas/clock.hpp>
+#include <villas/node/log.hpp>
 #include <villas/node_compat.hpp>
 #include <villas/exceptions.hpp>
 #include <villas/nodes/iec61850_sv.hpp>
@@ -35,7 +38,7 @@ void iec61850_sv_listener(SVSubscriber subscriber, void *ctx, SVSubscriber_ASDU
 	int confrev      = SVSubscriber_ASDU_getConfRev(asdu);
 	int sz;
 
-	n->logger->debug("Received SV: svid={}, smpcnt={}, confrev={}", svid, smpcnt, confrev);
+	VILLAS_LOG_DEBUG(n->logger, "Received SV: svid={}, smpcnt={}, confrev={}", svid, smpcnt, confrev);
 
 	sz = SVSubscriber_ASDU_getDataSize(asdu);
 	if (sz < i->in.total_size) {
@@ -64,6 +67,14 @@ void iec61850_sv_listener(SVSubscriber subscriber, void *ctx, SVSubscriber_ASDU
 	smp->length = 0;
 	smp->signals = n->getInputSignals(false);
 
+	/* libiec61850 does not expose the socket of its receivers, so we can not query kernel timestamps.
+	 * The listener is called synchronously by the receiver right after reading the frame.
+	 * Hence, taking the timestamp here at least excludes the queuing delay until the node is read. */
+	if (i->in.timestamping.mode != TimestampingMode::NONE) {
+		smp->ts.received = clock_now();
+		smp->flags |= (int) SampleFlags::HAS_TS_RECEIVED;
+	}
+
 	if (SVSubscriber_ASDU_hasRefrTm(asdu)) {
 		uint64_t refrtm = SVSubscriber_ASDU_getRefrTmAsMs(asdu);
 
@@ -142,6 +153,8 @@ int villas::node::iec61850_sv_parse(NodeCompat *n, json_t *json)
 	/* Default values */
 	i->out.enabled = false;
 	i->in.enabled = false;
+	i->in.timestamping.mode = TimestampingMode::NONE;
+	i->in.timestamping.tx = 0;
 	i->out.smpmod = -1; /* do not set smpmod */
 	i->out.smprate = -1; /* do not set smpmod */
 	i->out.confrev = 1;
@@ -205,15 +218,28 @@ int villas::node::iec61850_sv_parse(NodeCompat *n, json_t *json)
 	}
 
 	if (json_in) {
+		json_t *json_timestamping = nullptr;
+
 		i->in.enabled = true;
 
 		json_signals = nullptr;
-		ret = json_unpack_ex(json_in, &err, 0, "{ s: o }",
-			"signals", &json_signals
+		ret = json_unpack_ex(json_in, &err, 0, "{ s: o, s?: o }",
+			"signals", &json_signals,
+			"timestamping", &json_timestamping
 		);
 		if (ret)
 			throw ConfigError(json_in, err, "node-config-node-iec61850-in");
 
+		if (json_timestamping) {
+			ret = timestamping_parse(&i->in.timestamping, json_timestamping);
+			if (ret)
+				return ret;
+
+			/* libiec61850 reads the frames itself, so we can not access their control messages */
+			if (i->in.timestamping.mode == TimestampingMode::HARDWARE || i->in.timestamping.tx)
+				throw ConfigError(json_timestamping, "node-config-node-iec61850-timestamping", "Only software receive timestamps are supported by the IEC 61850-9-2 node-type");
+		}
+
 		ret = iec61850_parse_signals(json_signals, &i->in.signals, n->getInputSignals(false));
 		if (ret <= 0)
 			throw RuntimeError("Failed to parse setting 'signals'");
@@ -14,9 +14,11 @@
 #include <villas/node_compat.hpp>
 #include <villas/nodes/infiniband.hpp>
 #include <villas/utils.hpp>
+#include <villas/node/log.hpp>
 #include <villas/node/memory.hpp>
 #include <villas/memory/ib.h>
 #include <villas/timing.hpp>
+#include <villas/clock.hpp>
 #include <villas/exceptions.hpp>
 
 using namespace villas;
@@ -732,7 +734,7 @@ int villas::node::ib_read(NodeCompat *n, struct Sample * const smps[], unsigned
 	struct timespec ts_receive;
 	int ret = 0, wcs = 0, read_values = 0, max_wr_post;
 
-	n->logger->debug("ib_read is called");
+	VILLAS_LOG_DEBUG(n->logger, "ib_read is called");
 
 	if (n->getState() == State::CONNECTED || n->getState() == State::PENDING_CONNECT) {
 
@@ -753,9 +755,9 @@ int villas::node::ib_read(NodeCompat *n, struct Sample * const smps[], unsigned
 				wcs = ibv_poll_cq(ib->ctx.recv_cq, cnt, wc);
 				if (wcs) {
 					/* Get time directly after something arrived in Completion Queue */
-					ts_receive = time_now();
+					ts_receive = clock_now();
 
-					n->logger->debug("Received {} Work Completions", wcs);
+					VILLAS_LOG_DEBUG(n->logger, "Received {} Work Completions", wcs);
 
 					read_values = wcs; /* Value to return */
 					max_wr_post = wcs; /* Make space free in smps[] */
@@ -823,15 +825,15 @@ int villas::node::ib_read(NodeCompat *n, struct Sample * const smps[], unsigned
 
 		wr[max_wr_post-1].next = nullptr;
 
-		n->logger->debug("Prepared {} new receive Work Requests", max_wr_post);
-		n->logger->debug("{} receive Work Requests in Receive Queue", ib->conn.available_recv_wrs);
+		VILLAS_LOG_DEBUG(n->logger, "Prepared {} new receive Work Requests", max_wr_post);
+		VILLAS_LOG_DEBUG(n->logger, "{} receive Work Requests in Receive Queue", ib->conn.available_recv_wrs);
 
 		/* Post list of Work Requests */
 		ret = ibv_post_recv(ib->ctx.id->qp, &wr[0], &bad_wr);
 		if (ret)
 			throw RuntimeError("Was unable to post receive WR: {}, bad WR ID: {:#x}", ret, bad_wr->wr_id);
 
-		n->logger->debug("Succesfully posted receive Work Requests");
+		VILLAS_LOG_DEBUG(n->logger, "Succesfully posted receive Work Requests");
 
 		/* Doesn't start if wcs == 0 */
 		for (int j = 0; j < wcs; j++) {
@@ -841,7 +843,7 @@ int villas::node::ib_read(NodeCompat *n, struct Sample * const smps[], unsigned
 			}
 
 			if (wc[j].status == IBV_WC_WR_FLUSH_ERR)
-				n->logger->debug("Received IBV_WC_WR_FLUSH_ERR (ib_read). Ignore it.");
+				VILLAS_LOG_DEBUG(n->logger, "Received IBV_WC_WR_FLUSH_ERR (ib_read). Ignore it.");
 			else if (wc[j].status != IBV_WC_SUCCESS)
 				n->logger->warn("Work Completion status was not IBV_WC_SUCCESS: {}",
 					wc[j].status);
@@ -876,7 +878,7 @@ int villas::node::ib_write(NodeCompat *n, struct Sample * const smps[], unsigned
 	int ret;
 	unsigned sent = 0; /* Used for first loop: prepare work requests to post to send queue */
 
-	n->logger->debug("ib_write is called");
+	VILLAS_LOG_DEBUG(n->logger, "ib_write is called");
 
 	if (n->getState() == State::CONNECTED) {
 		// TODO: fix release logic
@@ -930,7 +932,7 @@ int villas::node::ib_write(NodeCompat *n, struct Sample * const smps[], unsigned
 				&& ((++ib->signaling_counter % ib->periodic_signaling) != 0)  ?
 				ib->conn.send_inline : 0;
 
-			n->logger->debug("Sample will be send inline [0/1]: {}", send_inline);
+			VILLAS_LOG_DEBUG(n->logger, "Sample will be send inline [0/1]: {}", send_inline);
 
 			/* Set Send Work Request */
 			wr[sent].wr_id = (uintptr_t) smps[sent];
@@ -942,12 +944,12 @@ int villas::node::ib_write(NodeCompat *n, struct Sample * const smps[], unsigned
 			wr[sent].opcode = IBV_WR_SEND;
 		}
 
-		n->logger->debug("Prepared {} send Work Requests", cnt);
+		VILLAS_LOG_DEBUG(n->logger, "Prepared {} send Work Requests", cnt);
 		wr[cnt-1].next = nullptr;
 
 		/* Send linked list of Work Requests */
 		ret = ibv_post_send(ib->ctx.id->qp, wr, &bad_wr);
-		n->logger->debug("Posted send Work Requests");
+		VILLAS_LOG_DEBUG(n->logger, "Posted send Work Requests");
 
 		/* Reorder list. Place inline and unposted samples to the top
 		 * m will always be equal or smaller than *release
@@ -960,7 +962,7 @@ int villas::node::ib_write(NodeCompat *n, struct Sample * const smps[], unsigned
 				/* The remaining work requests will be bad. Ripple through list
 				 * and prepare them to be released
 				 */
-				n->logger->debug("Bad WR occured with ID: {:#x} and S/G address: {:#x}: {}",
+				VILLAS_LOG_DEBUG(n->logger, "Bad WR occured with ID: {:#x} and S/G address: {:#x}: {}",
 					bad_wr->wr_id, (void *) bad_wr->sg_list, ret);
 
 				while (1) {
@@ -12,6 +12,7 @@
 #include <villas/node_compat.hpp>
 #include <villas/nodes/kafka.hpp>
 #include <villas/utils.hpp>
+#include <villas/node/log.hpp>
 #include <villas/exceptions.hpp>
 
 using namespace villas;
@@ -59,7 +60,7 @@ void kafka_message_cb(void *ctx, const rd_kafka_message_t *msg)
 	auto *k = n->getData<struct kafka>();
 	struct Sample *smps[n->in.vectorize];
 
-	n->logger->debug("Received a message of {} bytes from broker {}", msg->len, k->server);
+	VILLAS_LOG_DEBUG(n->logger, "Received a message of {} bytes from broker {}", msg->len, k->server);
 
 	ret = sample_alloc_many(&k->pool, smps, n->in.vectorize);
 	if (ret <= 0) {
@@ -75,7 +76,7 @@ void kafka_message_cb(void *ctx, const rd_kafka_message_t *msg)
 	}
 
 	if (ret == 0) {
-		n->logger->debug("Skip empty message");
+		VILLAS_LOG_DEBUG(n->logger, "Skip empty message");
 		sample_decref_many(smps, n->in.vectorize);
 		return;
 	}
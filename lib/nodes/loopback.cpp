@@ -21,7 +21,8 @@ using namespace villas::utils;
 LoopbackNode::LoopbackNode(const std::string &name) :
 	Node(name),
 	queuelen(DEFAULT_QUEUE_LENGTH),
-	mode(QueueSignalledMode::AUTO)
+	mode(QueueSignalledMode::AUTO),
+	spsc(-1)
 {
 	queue.queue.state = State::DESTROYED;
 }
@@ -37,7 +38,14 @@ int LoopbackNode::prepare()
 {
 	assert(state == State::CHECKED);
 
-	int ret = queue_signalled_init(&queue, queuelen, &memory::mmap, mode);
+	/* Samples are only written by the path which uses this node as destination
+	 * and only read by the master path source of this node. */
+	if (spsc < 0)
+		spsc = destinations.size() <= 1;
+
+	int flags = spsc ? (int) QueueFlags::SPSC : 0;
+
+	int ret = queue_signalled_init(&queue, queuelen, &memory::mmap, mode, flags);
 	if (ret)
 		throw RuntimeError("Failed to initialize queue");
 
@@ -109,9 +117,10 @@ int LoopbackNode::parse(json_t *json)
 	json_error_t err;
 	int ret;
 
-	ret = json_unpack_ex(json, &err, 0, "{ s?: i, s?: s }",
-		"queuelen", queuelen,
-		"mode", &mode_str
+	ret = json_unpack_ex(json, &err, 0, "{ s?: i, s?: s, s?: b }",
+		"queuelen", &queuelen,
+		"mode", &mode_str,
+		"spsc", &spsc
 	);
 	if (ret)
 		throw ConfigError(json, err, "node-config-node-loopback");
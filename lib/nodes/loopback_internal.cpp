@@ -37,7 +37,8 @@ InternalLoopbackNode::InternalLoopbackNode(Node *src, unsigned id, unsigned ql)
 
 	in.signals = source->getInputSignals(false);
 
-	ret = queue_signalled_init(&queue, queuelen);
+	/* Only the master path source writes to and only the secondary path reads from this queue */
+	ret = queue_signalled_init(&queue, queuelen, memory::default_type, QueueSignalledMode::AUTO, (int) QueueFlags::SPSC);
 	if (ret)
 		throw RuntimeError("Failed to initialize queue");
 
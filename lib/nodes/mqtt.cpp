@@ -13,6 +13,7 @@
 #include <villas/node_compat.hpp>
 #include <villas/nodes/mqtt.hpp>
 #include <villas/utils.hpp>
+#include <villas/node/log.hpp>
 #include <villas/exceptions.hpp>
 
 using namespace villas;
@@ -81,7 +82,7 @@ void mqtt_message_cb(struct mosquitto *mosq, void *ctx, const struct mosquitto_m
 	auto *m = n->getData<struct mqtt>();
 	struct Sample *smps[n->in.vectorize];
 
-	n->logger->debug("Received a message of {} bytes from broker {}", msg->payloadlen, m->host);
+	VILLAS_LOG_DEBUG(n->logger, "Received a message of {} bytes from broker {}", msg->payloadlen, m->host);
 
 	ret = sample_alloc_many(&m->pool, smps, n->in.vectorize);
 	if (ret <= 0) {
@@ -97,7 +98,7 @@ void mqtt_message_cb(struct mosquitto *mosq, void *ctx, const struct mosquitto_m
 	}
 
 	if (ret == 0) {
-		n->logger->debug("Skip empty message");
+		VILLAS_LOG_DEBUG(n->logger, "Skip empty message");
 		sample_decref_many(smps, n->in.vectorize);
 		return;
 	}
@@ -14,6 +14,7 @@
 #include <villas/nodes/redis.hpp>
 #include <villas/nodes/redis_helpers.hpp>
 #include <villas/utils.hpp>
+#include <villas/node/log.hpp>
 #include <villas/sample.hpp>
 #include <villas/exceptions.hpp>
 #include <villas/super_node.hpp>
@@ -181,11 +182,13 @@ int redis_get(NodeCompat *n, struct Sample * const smps[], unsigned cnt)
 				auto &name = it.first;
 				auto &value = it.second;
 
-				auto sig = n->getInputSignals(false)->getByName(name);
-				if (!sig)
+				auto sigs = n->getInputSignals(false);
+
+				auto idx = sigs->getIndexByName(name);
+				if (idx < 0)
 					continue;
 
-				auto idx = n->getInputSignals(false)->getIndexByName(name);
+				auto sig = sigs->getByIndex(idx);
 				if (idx > max_idx)
 					max_idx = idx;
 
@@ -214,7 +217,7 @@ void redis_on_message(NodeCompat *n, const std::string &channel, const std::stri
 {
 	auto *r = n->getData<struct redis>();
 
-	n->logger->debug("Message: {}: {}", channel, msg);
+	VILLAS_LOG_DEBUG(n->logger, "Message: {}: {}", channel, msg);
 
 	int alloc, scanned, pushed;
 	unsigned cnt = n->in.vectorize;
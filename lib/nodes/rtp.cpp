@@ -28,6 +28,7 @@ extern "C" {
 #include <villas/node_compat.hpp>
 #include <villas/nodes/socket.hpp>
 #include <villas/utils.hpp>
+#include <villas/node/log.hpp>
 #include <villas/stats.hpp>
 #include <villas/hook.hpp>
 #include <villas/super_node.hpp>
@@ -65,13 +66,13 @@ int rtp_aimd(NodeCompat *n, double loss_frac)
 
 	if (r->aimd.rate_hook) {
 		r->aimd.rate_hook->setRate(r->aimd.rate);
-		n->logger->debug("AIMD: Set rate limit to: {}", r->aimd.rate);
+		VILLAS_LOG_DEBUG(n->logger, "AIMD: Set rate limit to: {}", r->aimd.rate);
 	}
 
 	if (r->aimd.log)
 		*(r->aimd.log) << r->rtcp.num_rrs << "\t" << loss_frac << "\t" << r->aimd.rate << std::endl;
 
-	n->logger->debug("AIMD: {}\t{}\t{}", r->rtcp.num_rrs, loss_frac, r->aimd.rate);
+	VILLAS_LOG_DEBUG(n->logger, "AIMD: {}\t{}\t{}", r->rtcp.num_rrs, loss_frac, r->aimd.rate);
 
 	return 0;
 }
@@ -282,7 +283,7 @@ void rtcp_handler(const struct sa *src, struct rtcp_msg *msg, void *arg)
 	/* source not used */
 	(void) src;
 
-	n->logger->debug("RTCP: recv {}", rtcp_type_name((enum rtcp_type) msg->hdr.pt));
+	VILLAS_LOG_DEBUG(n->logger, "RTCP: recv {}", rtcp_type_name((enum rtcp_type) msg->hdr.pt));
 
 	if (msg->hdr.pt == RTCP_SR) {
 		if (msg->hdr.count > 0) {
@@ -302,7 +303,7 @@ void rtcp_handler(const struct sa *src, struct rtcp_msg *msg, void *arg)
 			n->logger->info("RTCP: rr: num_rrs={}, loss_frac={}, pkts_lost={}, jitter={}", r->rtcp.num_rrs, loss_frac, rr->lost, rr->jitter);
 		}
 		else
-			n->logger->debug("RTCP: Received sender report with zero reception reports");
+			VILLAS_LOG_DEBUG(n->logger, "RTCP: Received sender report with zero reception reports");
 	}
 
 	r->rtcp.num_rrs++;
@@ -15,6 +15,7 @@
 
 #include <villas/kernel/kernel.hpp>
 #include <villas/log.hpp>
+#include <villas/node/log.hpp>
 #include <villas/exceptions.hpp>
 #include <villas/shmem.hpp>
 #include <villas/node_compat.hpp>
@@ -35,6 +36,10 @@ int villas::node::shmem_init(NodeCompat *n)
 	shm->conf.samplelen = -1;
 	shm->conf.polling = false;
 	shm->exec = nullptr;
+	shm->in_name = nullptr;
+	shm->out_name = nullptr;
+	shm->broadcast = false;
+	shm->latest = false;
 
 	return 0;
 }
@@ -44,22 +49,39 @@ int villas::node::shmem_parse(NodeCompat *n, json_t *json)
 	auto *shm = n->getData<struct shmem>();
 	const char *val, *mode_str = nullptr;
 
-	int ret;
+	int ret, broadcast = 0, latest = 0;
 	json_t *json_exec = nullptr;
 	json_error_t err;
 
-	ret = json_unpack_ex(json, &err, 0, "{ s: { s: s }, s: { s: s }, s?: i, s?: o, s?: s }",
+	ret = json_unpack_ex(json, &err, 0, "{ s?: { s?: s }, s?: { s?: s, s?: b }, s?: i, s?: o, s?: s, s?: b }",
 		"out",
 			"name", &shm->out_name,
 		"in",
 			"name", &shm->in_name,
+			"latest", &latest,
 		"queuelen", &shm->conf.queuelen,
 		"exec", &json_exec,
-		"mode", &mode_str
+		"mode", &mode_str,
+		"broadcast", &broadcast
 	);
 	if (ret)
 		throw ConfigError(json, err, "node-config-node-shmem");
 
+	shm->broadcast = broadcast;
+	shm->latest = latest;
+
+	if (shm->broadcast) {
+		if (!shm->in_name && !shm->out_name)
+			throw ConfigError(json, "node-config-node-shmem", "Setting 'in.name' or 'out.name' is required in broadcast mode");
+	}
+	else {
+		if (!shm->in_name || !shm->out_name)
+			throw ConfigError(json, "node-config-node-shmem", "Settings 'in.name' and 'out.name' are required");
+
+		if (shm->latest)
+			throw ConfigError(json, "node-config-node-shmem", "Setting 'in.latest' requires broadcast mode");
+	}
+
 	if (mode_str) {
 		if (!strcmp(mode_str, "polling"))
 			shm->conf.polling = true;
@@ -113,6 +135,30 @@ int villas::node::shmem_prepare(NodeCompat *n)
 	return 0;
 }
 
+/** Attach to the input ring.
+ *
+ * @retval 1 Attached.
+ * @retval 0 The ring has not been created by its writer yet.
+ * @retval -1 An error occured; errno is set accordingly.
+ */
+static int shmem_attach_broadcast(NodeCompat *n)
+{
+	auto *shm = n->getData<struct shmem>();
+	int ret;
+
+	ret = shmem_bcast_attach(shm->in_name, &shm->bcast_in);
+	if (ret) {
+		shm->bcast_in.shared = nullptr;
+
+		/* The ring does not exist or its writer is still initializing it */
+		return errno == ENOENT || errno == EINVAL ? 0 : -1;
+	}
+
+	n->logger->info("Attached to broadcast ring {}", shm->in_name);
+
+	return 1;
+}
+
 int villas::node::shmem_start(NodeCompat *n)
 {
 	auto *shm = n->getData<struct shmem>();
@@ -126,6 +172,27 @@ int villas::node::shmem_start(NodeCompat *n)
 		sleep(1);
 	}
 
+	if (shm->broadcast) {
+		if (shm->out_name) {
+			ret = shmem_bcast_create(shm->out_name, &shm->bcast_out, shm->conf.queuelen, shm->conf.samplelen, shm->conf.polling);
+			if (ret)
+				throw SystemError("Failed to create broadcast ring {}", shm->out_name);
+		}
+
+		/* The writer of the input ring might not have been started yet.
+		 * In this case, shmem_read() keeps trying to attach to it. */
+		shm->bcast_in.shared = nullptr;
+		if (shm->in_name) {
+			ret = shmem_attach_broadcast(n);
+			if (ret < 0)
+				throw SystemError("Failed to attach to broadcast ring {}", shm->in_name);
+			else if (ret == 0)
+				n->logger->info("Waiting for writer of broadcast ring {}", shm->in_name);
+		}
+
+		return 0;
+	}
+
 	ret = shmem_int_open(shm->out_name, shm->in_name, &shm->intf, &shm->conf);
 	if (ret < 0)
 		throw SystemError("Opening shared memory interface failed (ret={})", ret);
@@ -136,16 +203,95 @@ int villas::node::shmem_start(NodeCompat *n)
 int villas::node::shmem_stop(NodeCompat *n)
 {
 	auto* shm = n->getData<struct shmem>();
+	int ret;
+
+	if (shm->broadcast) {
+		if (shm->bcast_in.shared) {
+			ret = shmem_bcast_close(&shm->bcast_in);
+			if (ret)
+				return ret;
+
+			shm->bcast_in.shared = nullptr;
+		}
+
+		if (shm->out_name) {
+			ret = shmem_bcast_close(&shm->bcast_out);
+			if (ret)
+				return ret;
+		}
+
+		return 0;
+	}
 
 	return shmem_int_close(&shm->intf);
 }
 
+static int shmem_read_broadcast(NodeCompat *n, struct Sample * const smps[], unsigned cnt)
+{
+	auto *shm = n->getData<struct shmem>();
+	uint64_t overruns;
+	int ret, recv;
+
+	/* Wake up regularly to allow the reading thread to be cancelled */
+	const struct timespec timeout = { 0, 100000000 };
+
+	if (!shm->in_name)
+		return -1;
+
+	while (!shm->bcast_in.shared) {
+		ret = shmem_attach_broadcast(n);
+		if (ret < 0) {
+			n->logger->error("Failed to attach to broadcast ring {}: {}", shm->in_name, strerror(errno));
+			return -1;
+		}
+		else if (ret == 0)
+			nanosleep(&timeout, nullptr);
+	}
+
+	overruns = shm->bcast_in.overruns;
+
+	for (;;) {
+		recv = shm->latest
+			? shmem_bcast_latest(&shm->bcast_in, smps[0])
+			: shmem_bcast_read(&shm->bcast_in, smps, cnt);
+		if (recv != 0)
+			break;
+
+		/* Blocks unless the writer has created the ring in polling mode */
+		ret = shmem_bcast_wait(&shm->bcast_in, &timeout);
+		if (ret)
+			return -1;
+
+		pthread_testcancel();
+	}
+
+	if (shm->bcast_in.overruns != overruns)
+		VILLAS_LOG_WARN(n->logger, "Missed {} samples of broadcast ring {}", shm->bcast_in.overruns - overruns, shm->in_name);
+
+	if (recv < 0) {
+		n->logger->info("Broadcast ring has been closed by its writer.");
+
+		n->setState(State::STOPPING);
+
+		return recv;
+	}
+
+	/** @todo signal descriptions are currently not shared between processes */
+	for (int i = 0; i < recv; i++)
+		smps[i]->signals = n->getInputSignals(false);
+
+	return recv;
+}
+
 int villas::node::shmem_read(NodeCompat *n, struct Sample * const smps[], unsigned cnt)
 {
 	auto *shm = n->getData<struct shmem>();
 	int recv;
 	struct Sample *shared_smps[cnt];
 
+	if (shm->broadcast)
+		return shmem_read_broadcast(n, smps, cnt);
+
 	do {
 		recv = shmem_int_read(&shm->intf, shared_smps, cnt);
 	} while (recv == 0);
@@ -177,6 +323,9 @@ int villas::node::shmem_write(NodeCompat *n, struct Sample * const smps[], unsig
 	struct Sample *shared_smps[cnt]; /* Samples need to be copied to the shared pool first */
 	int avail, pushed, copied;
 
+	if (shm->broadcast)
+		return shm->out_name ? shmem_bcast_write(&shm->bcast_out, smps, cnt) : -1;
+
 	avail = sample_alloc_many(&shm->intf.write.shared->pool, shared_smps, cnt);
 	if (avail != (int) cnt)
 		n->logger->warn("Pool underrun for shmem node {}", shm->out_name);
@@ -198,7 +347,10 @@ char * villas::node::shmem_print(NodeCompat *n)
 	char *buf = nullptr;
 
 	strcatf(&buf, "out_name=%s, in_name=%s, queuelen=%d, polling=%s",
-		shm->out_name, shm->in_name, shm->conf.queuelen, shm->conf.polling ? "yes" : "no");
+		shm->out_name ? shm->out_name : "none", shm->in_name ? shm->in_name : "none", shm->conf.queuelen, shm->conf.polling ? "yes" : "no");
+
+	if (shm->broadcast)
+		strcatf(&buf, ", broadcast=yes, latest=%s", shm->latest ? "yes" : "no");
 
 	if (shm->exec) {
 		strcatf(&buf, ", exec='");
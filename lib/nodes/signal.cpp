@@ -9,11 +9,13 @@
 #include <list>
 #include <cmath>
 #include <cstring>
+#include <algorithm>
 
 #include <villas/exceptions.hpp>
 #include <villas/node_compat.hpp>
 #include <villas/nodes/signal.hpp>
 #include <villas/utils.hpp>
+#include <villas/clock.hpp>
 
 using namespace villas;
 using namespace villas::node;
@@ -136,7 +138,7 @@ void SignalNodeSignal::read(unsigned c, double t, double r, SignalData *d)
 			break;
 
 		case Type::PULSE:
-			d->f = abs(fmod(t * frequency + (phase / (2 * M_PI)) , 1)) <= (pulse_width / r)
+			d->f = fabs(fmod(t * frequency + (phase / (2 * M_PI)) , 1)) <= (pulse_width / r)
 					? pulse_high
 					: pulse_low;
 			d->f += offset;
@@ -188,10 +190,163 @@ Signal::Ptr SignalNodeSignal::toSignal(Signal::Ptr tpl) const
 	return sig;
 }
 
+void SignalNodeGroup::add(unsigned idx, const SignalNodeSignal &sig, double rate)
+{
+	index.push_back(idx);
+	offset.push_back(sig.offset);
+	amplitude.push_back(sig.amplitude);
+	frequency.push_back(sig.frequency);
+	phase.push_back(sig.phase);
+
+	/* The phasor is rotated by the phase advance of a single step */
+	double w = 2 * M_PI * sig.frequency / rate;
+	re.push_back(0);
+	im.push_back(0);
+	rot_re.push_back(cos(w));
+	rot_im.push_back(sin(w));
+
+	/* Ramps wrap around after 'frequency' seconds, all other signals after one period */
+	double i = type == SignalNodeSignal::Type::RAMP
+		? 1.0 / (sig.frequency * rate)
+		: sig.frequency / rate;
+	acc.push_back(0);
+	inc.push_back(i - floor(i)); /* The accumulator must not advance by more than one period per step */
+
+	threshold.push_back(sig.pulse_width / rate);
+	high.push_back(sig.pulse_high);
+	low.push_back(sig.pulse_low);
+
+	stddev.push_back(sig.stddev);
+	last.push_back(sig.offset);
+
+	values.push_back(0);
+}
+
+void SignalNodeGroup::seek(uint64_t counter, double rate)
+{
+	double t = counter / rate;
+
+	switch (type) {
+		case SignalNodeSignal::Type::SINE:
+			for (unsigned i = 0; i < index.size(); i++) {
+				double arg = t * frequency[i] * 2 * M_PI + phase[i];
+
+				re[i] = cos(arg);
+				im[i] = sin(arg);
+			}
+			break;
+
+		case SignalNodeSignal::Type::TRIANGLE:
+		case SignalNodeSignal::Type::SQUARE:
+		case SignalNodeSignal::Type::PULSE:
+			for (unsigned i = 0; i < index.size(); i++) {
+				double x = t * frequency[i] + phase[i] / (2 * M_PI);
+
+				acc[i] = x - floor(x);
+			}
+			break;
+
+		case SignalNodeSignal::Type::RAMP:
+			for (unsigned i = 0; i < index.size(); i++) {
+				double x = t / frequency[i];
+
+				acc[i] = x - floor(x);
+			}
+			break;
+
+		default:
+			break;
+	}
+}
+
+void SignalNodeGroup::step(uint64_t counter)
+{
+	unsigned n = index.size();
+
+	double *v = values.data();
+	const double *o = offset.data();
+	const double *a = amplitude.data();
+
+	/* The switch is hoisted out of the loops, so that each loop is branch-free */
+	switch (type) {
+		case SignalNodeSignal::Type::CONSTANT:
+			for (unsigned i = 0; i < n; i++)
+				v[i] = o[i] + a[i];
+			break;
+
+		case SignalNodeSignal::Type::COUNTER:
+			for (unsigned i = 0; i < n; i++)
+				v[i] = o[i] + a[i] * counter;
+			break;
+
+		case SignalNodeSignal::Type::SINE: {
+			double *x = re.data(), *y = im.data();
+			const double *rx = rot_re.data(), *ry = rot_im.data();
+
+			for (unsigned i = 0; i < n; i++) {
+				v[i] = o[i] + a[i] * y[i];
+
+				double nx = x[i] * rx[i] - y[i] * ry[i];
+				double ny = x[i] * ry[i] + y[i] * rx[i];
+
+				x[i] = nx;
+				y[i] = ny;
+			}
+			break;
+		}
+
+		case SignalNodeSignal::Type::TRIANGLE:
+		case SignalNodeSignal::Type::SQUARE:
+		case SignalNodeSignal::Type::PULSE:
+		case SignalNodeSignal::Type::RAMP: {
+			double *p = acc.data();
+			const double *d = inc.data();
+
+			if (type == SignalNodeSignal::Type::TRIANGLE) {
+				for (unsigned i = 0; i < n; i++)
+					v[i] = o[i] + a[i] * (fabs(p[i] - .5) - 0.25) * 4;
+			}
+			else if (type == SignalNodeSignal::Type::SQUARE) {
+				for (unsigned i = 0; i < n; i++)
+					v[i] = o[i] + a[i] * (p[i] < .5 ? -1 : 1);
+			}
+			else if (type == SignalNodeSignal::Type::PULSE) {
+				const double *th = threshold.data(), *hi = high.data(), *lo = low.data();
+
+				for (unsigned i = 0; i < n; i++)
+					v[i] = o[i] + (p[i] <= th[i] ? hi[i] : lo[i]);
+			}
+			else {
+				const double *f = frequency.data();
+
+				for (unsigned i = 0; i < n; i++)
+					v[i] = o[i] + a[i] * f[i] * p[i];
+			}
+
+			for (unsigned i = 0; i < n; i++) {
+				p[i] += d[i];
+				p[i] -= p[i] >= 1.0 ? 1.0 : 0.0;
+			}
+			break;
+		}
+
+		case SignalNodeSignal::Type::RANDOM:
+			for (unsigned i = 0; i < n; i++) {
+				last[i] += boxMuller(0, stddev[i]);
+				v[i] = last[i];
+			}
+			break;
+
+		case SignalNodeSignal::Type::MIXED:
+			break;
+	}
+}
+
 SignalNode::SignalNode(const std::string &name) :
 	Node(name),
 	task(CLOCK_MONOTONIC),
 	rt(1),
+	batch(false),
 	rate(10),
 	monitor_missed(true),
 	limit(-1),
@@ -217,7 +372,7 @@ int SignalNode::prepare()
 
 int SignalNode::parse(json_t *json, const uuid_t sn_uuid)
 {
-	int r = -1, m = -1, ret = Node::parse(json, sn_uuid);
+	int r = -1, m = -1, b = -1, ret = Node::parse(json, sn_uuid);
 	if (ret)
 		return ret;
 
@@ -225,12 +380,15 @@ int SignalNode::parse(json_t *json, const uuid_t sn_uuid)
 
 	size_t i;
 	json_t *json_signals, *json_signal;
+	json_t *json_timer = nullptr;
 
-	ret = json_unpack_ex(json, &err, 0, "{ s?: b, s?: i, s?: F, s?: b, s: { s: o } }",
+	ret = json_unpack_ex(json, &err, 0, "{ s?: b, s?: b, s?: i, s?: F, s?: b, s?: o, s: { s: o } }",
 		"realtime", &r,
+		"batch", &b,
 		"limit", &limit,
 		"rate", &rate,
 		"monitor_missed", &m,
+		"timer", &json_timer,
 		"in",
 			"signals", &json_signals
 	);
@@ -243,6 +401,16 @@ int SignalNode::parse(json_t *json, const uuid_t sn_uuid)
 	if (m >= 0)
 		monitor_missed = m != 0;
 
+	if (b >= 0)
+		batch = b != 0;
+
+	/* The timer period is derived from a fixed block size of in.vectorize samples */
+	if (batch && in.adaptive.enabled)
+		throw ConfigError(json, "node-config-node-signal", "Setting 'batch' can not be combined with 'in.adaptive'");
+
+	if (json_timer)
+		task.parse(json_timer);
+
 	signals.clear();
 	unsigned j = 0;
 	json_array_foreach(json_signals, i, json_signal) {
@@ -265,14 +433,29 @@ int SignalNode::start()
 	       state == State::PAUSED);
 
 	missed_steps = 0;
-	started = time_now();
+	started = clock_now();
 
-	for (auto sig : signals)
+	for (auto &sig : signals)
 		sig.start();
 
+	groups.clear();
+	if (batch) {
+		for (unsigned i = 0; i < signals.size(); i++) {
+			auto &sig = signals[i];
+
+			auto it = std::find_if(groups.begin(), groups.end(), [&sig](const SignalNodeGroup &g) {
+				return g.type == sig.type;
+			});
+			if (it == groups.end())
+				it = groups.emplace(groups.end(), sig.type);
+
+			it->add(i, sig, rate);
+		}
+	}
+
 	/* Setup task */
 	if (rt)
-		task.setRate(rate);
+		task.setRate(batch ? rate / in.vectorize : rate);
 
 	int ret = Node::start();
 	if (!ret)
@@ -291,9 +474,13 @@ int SignalNode::stop()
 	if (ret)
 		return ret;
 
-	if (rt)
+	if (rt) {
 		task.stop();
 
+		if (task.getSlack() > 0)
+			task.printStats(logger);
+	}
+
 	if (missed_steps > 0 && monitor_missed)
 		logger->warn("Missed a total of {} steps.", missed_steps);
 
@@ -304,6 +491,9 @@ int SignalNode::stop()
 
 int SignalNode::_read(struct Sample *smps[], unsigned cnt)
 {
+	if (batch)
+		return readBatch(smps, cnt);
+
 	struct Sample *t = smps[0];
 
 	struct timespec ts;
@@ -312,7 +502,7 @@ int SignalNode::_read(struct Sample *smps[], unsigned cnt)
 	assert(cnt == 1);
 
 	if (rt)
-		ts = time_now();
+		ts = clock_now();
 	else {
 		struct timespec offset = time_from_double(counter * 1.0 / rate);
 		ts = time_add(&started, &offset);
@@ -356,6 +546,69 @@ int SignalNode::_read(struct Sample *smps[], unsigned cnt)
 	return 1;
 }
 
+int SignalNode::readBatch(struct Sample *smps[], unsigned cnt)
+{
+	struct timespec ts;
+	uint64_t steps, counter = sequence - sequence_init;
+
+	if (limit > 0) {
+		if (counter >= (unsigned) limit) {
+			logger->info("Reached limit.");
+
+			setState(State::STOPPING);
+			return -1;
+		}
+
+		cnt = MIN(cnt, limit - counter);
+	}
+
+	if (rt)
+		ts = clock_now();
+	else {
+		struct timespec offset = time_from_double(counter * 1.0 / rate);
+		ts = time_add(&started, &offset);
+	}
+
+	for (auto &g : groups)
+		g.seek(counter, rate);
+
+	for (unsigned k = 0; k < cnt; k++) {
+		struct Sample *t = smps[k];
+		struct timespec offset = time_from_double(k * 1.0 / rate);
+
+		t->flags = (int) SampleFlags::HAS_TS_ORIGIN | (int) SampleFlags::HAS_DATA | (int) SampleFlags::HAS_SEQUENCE;
+		t->ts.origin = time_add(&ts, &offset);
+		t->sequence = sequence + k;
+		t->length = MIN(signals.size(), t->capacity);
+		t->signals = in.signals;
+
+		for (auto &g : groups) {
+			g.step(counter + k);
+
+			for (unsigned i = 0; i < g.index.size(); i++) {
+				if (g.index[i] < t->length)
+					t->data[g.index[i]].f = g.values[i];
+			}
+		}
+	}
+
+	/* Throttle output if desired */
+	if (rt) {
+		/* Block until in.vectorize/p->rate seconds elapsed */
+		steps = task.wait();
+		if (steps > 1 && monitor_missed) {
+			logger->debug("Missed steps: {}", (steps-1) * cnt);
+			missed_steps += (steps-1) * cnt;
+		}
+	}
+	else
+		steps = 1;
+
+	sequence += steps * cnt;
+
+	return cnt;
+}
+
 const std::string & SignalNode::getDetails()
 {
 	if (details.empty()) {
@@ -364,6 +617,12 @@ const std::string & SignalNode::getDetails()
 		if (limit > 0)
 			details += fmt::format(", limit={}", limit);
 
+		if (batch)
+			details += fmt::format(", batch={}", in.vectorize);
+
+		if (rt && task.getSlack() > 0)
+			details += fmt::format(", slack={}", task.getSlack());
+
 	}
 
 	return details;
@@ -14,6 +14,7 @@
 #include <villas/node_compat.hpp>
 #include <villas/nodes/signal_old.hpp>
 #include <villas/utils.hpp>
+#include <villas/clock.hpp>
 
 using namespace villas;
 using namespace villas::node;
@@ -296,7 +297,7 @@ int villas::node::signal_node_start(NodeCompat *n)
 
 	s->missed_steps = 0;
 	s->counter = 0;
-	s->started = time_now();
+	s->started = clock_now();
 	s->last = new double[s->values];
 	if (!s->last)
 		throw MemoryAllocationError();
@@ -337,7 +338,7 @@ int villas::node::signal_node_read(NodeCompat *n, struct Sample * const smps[],
 	assert(cnt == 1);
 
 	if (s->rt)
-		ts = time_now();
+		ts = clock_now();
 	else {
 		struct timespec offset = time_from_double(s->counter * 1.0 / s->rate);
 
@@ -8,8 +8,12 @@
 #include <unistd.h>
 #include <cstring>
 #include <cerrno>
+#include <cstddef>
+#include <poll.h>
+#include <sys/mman.h>
 #include <arpa/inet.h>
 #include <netinet/ip.h>
+#include <netinet/ip6.h>
 
 #include <villas/node_compat.hpp>
 #include <villas/nodes/socket.hpp>
@@ -18,11 +22,20 @@
 #include <villas/queue.h>
 #include <villas/compat.hpp>
 #include <villas/super_node.hpp>
+#include <villas/timing.hpp>
+#include <villas/clock.hpp>
+#include <villas/stats.hpp>
 
 #ifdef WITH_SOCKET_LAYER_ETH
+  #include <net/if.h>
   #include <netinet/ether.h>
 #endif /* WITH_SOCKET_LAYER_ETH */
 
+#ifdef __linux__
+  #include <linux/filter.h>
+  #include <linux/net_tstamp.h>
+#endif /* __linux__ */
+
 #ifdef WITH_NETEM
   #include <villas/kernel/if.hpp>
   #include <villas/kernel/nl.hpp>
@@ -66,6 +79,13 @@ int villas::node::socket_init(NodeCompat *n)
 
 	s->formatter = nullptr;
 
+	s->ring.enabled = 0;
+	s->ring.map = nullptr;
+
+	s->reuseport.enabled = 0;
+	s->reuseport.shards = 1;
+	s->reuseport.steering = 0;
+
 	return 0;
 }
 
@@ -108,6 +128,16 @@ char * villas::node::socket_print(NodeCompat *n)
 
 	buf = strf("layer=%s, in.address=%s, out.address=%s", layer, local, remote);
 
+	if (s->reuseport.enabled)
+		strcatf(&buf, ", in.reuseport.shards=%d, in.reuseport.steering=%s", s->reuseport.shards, s->reuseport.steering ? "source" : "none");
+
+	if (s->ring.enabled)
+		strcatf(&buf, ", in.ring.block_size=%d, in.ring.block_count=%d, in.ring.frame_size=%d, in.ring.timeout=%d",
+			s->ring.block_size, s->ring.block_count, s->ring.frame_size, s->ring.timeout);
+
+	if (s->timestamping.mode != TimestampingMode::NONE)
+		strcatf(&buf, ", timestamping=%s, timestamping.tx=%s", timestamping_mode_str(s->timestamping.mode), s->timestamping.tx ? "yes" : "no");
+
 	if (s->multicast.enabled) {
 		char group[INET_ADDRSTRLEN];
 		char interface[INET_ADDRSTRLEN];
@@ -152,6 +182,37 @@ int villas::node::socket_check(NodeCompat *n)
 	}
 #endif /* WITH_SOCKET_LAYER_ETH */
 
+	if (s->reuseport.enabled) {
+		if (s->layer != SocketLayer::UDP)
+			throw RuntimeError("Sharding via SO_REUSEPORT is only supported by the udp layer");
+
+		if (s->reuseport.shards < 1)
+			throw RuntimeError("The number of shards must be positive");
+
+#ifndef SO_ATTACH_REUSEPORT_CBPF
+		if (s->reuseport.steering)
+			throw RuntimeError("Steering of shards by source address is not supported on this platform");
+#endif /* SO_ATTACH_REUSEPORT_CBPF */
+	}
+
+	if (s->ring.enabled) {
+#ifdef WITH_SOCKET_LAYER_ETH
+		if (s->layer != SocketLayer::ETH)
+			throw RuntimeError("The memory-mapped receive ring is only supported by the eth layer");
+
+		if (s->ring.block_size <= 0 || s->ring.block_size % getpagesize())
+			throw RuntimeError("The ring block size must be a multiple of the page size ({})", getpagesize());
+
+		if (s->ring.frame_size < TPACKET_ALIGNMENT || s->ring.frame_size % TPACKET_ALIGNMENT || s->ring.block_size % s->ring.frame_size)
+			throw RuntimeError("The ring frame size must be a multiple of {} and a divisor of the block size", TPACKET_ALIGNMENT);
+
+		if (s->ring.block_count <= 0)
+			throw RuntimeError("The ring must consist of at least one block");
+#else
+		throw RuntimeError("The memory-mapped receive ring is not supported on this platform");
+#endif /* WITH_SOCKET_LAYER_ETH */
+	}
+
 	if (s->multicast.enabled) {
 		if (s->in.saddr.sa.sa_family != AF_INET)
 			throw RuntimeError("Multicast is only supported by IPv4");
@@ -199,6 +260,46 @@ int villas::node::socket_start(NodeCompat *n)
 	if (s->sd < 0)
 		throw SystemError("Failed to create socket");
 
+#ifdef WITH_SOCKET_LAYER_ETH
+	/* Setup memory-mapped receive ring before binding the socket */
+	if (s->ring.enabled) {
+		int version = TPACKET_V3;
+		ret = setsockopt(s->sd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version));
+		if (ret)
+			throw SystemError("Failed to set packet version");
+
+		struct tpacket_req3 req;
+		memset(&req, 0, sizeof(req));
+
+		req.tp_block_size = s->ring.block_size;
+		req.tp_block_nr = s->ring.block_count;
+		req.tp_frame_size = s->ring.frame_size;
+		req.tp_frame_nr = (s->ring.block_size / s->ring.frame_size) * s->ring.block_count;
+		req.tp_retire_blk_tov = s->ring.timeout;
+
+		/* Let the ring carry the hardware timestamps instead of the software ones */
+		if (s->timestamping.mode == TimestampingMode::HARDWARE) {
+			int req_ts = SOF_TIMESTAMPING_RAW_HARDWARE;
+			ret = setsockopt(s->sd, SOL_PACKET, PACKET_TIMESTAMP, &req_ts, sizeof(req_ts));
+			if (ret)
+				throw SystemError("Failed to request hardware timestamps for receive ring");
+		}
+
+		ret = setsockopt(s->sd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req));
+		if (ret)
+			throw SystemError("Failed to setup receive ring");
+
+		void *map = mmap(nullptr, (size_t) s->ring.block_size * s->ring.block_count, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_LOCKED, s->sd, 0);
+		if (map == MAP_FAILED)
+			throw SystemError("Failed to map receive ring");
+
+		s->ring.map = (char *) map;
+		s->ring.block = 0;
+		s->ring.remaining = 0;
+		s->ring.packet = nullptr;
+	}
+#endif /* WITH_SOCKET_LAYER_ETH */
+
 	/* Delete Unix domain socket if already existing */
 	if (s->layer == SocketLayer::UNIX) {
 		ret = unlink(s->in.saddr.sun.sun_path);
@@ -206,6 +307,14 @@ int villas::node::socket_start(NodeCompat *n)
 			return ret;
 	}
 
+	/* Share the local address with the other shards */
+	if (s->reuseport.enabled) {
+		int on = 1;
+		ret = setsockopt(s->sd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on));
+		if (ret)
+			throw SystemError("Failed to set SO_REUSEPORT");
+	}
+
 	/* Bind socket for receiving */
 	socklen_t addrlen = 0;
 	switch(s->in.saddr.ss.ss_family) {
@@ -234,6 +343,33 @@ int villas::node::socket_start(NodeCompat *n)
 	if (ret < 0)
 		throw SystemError("Failed to bind socket");
 
+#ifdef SO_ATTACH_REUSEPORT_CBPF
+	if (s->reuseport.enabled && s->reuseport.steering) {
+		/* Select the socket by the (lower 32 bits of the) source address modulo the number of shards.
+		 * The program runs with the packet data pointing to the UDP payload. */
+		uint32_t off = s->in.saddr.sa.sa_family == AF_INET6
+				? offsetof(struct ip6_hdr, ip6_src) + 12
+				: offsetof(struct ip, ip_src);
+
+		struct sock_filter code[] = {
+			BPF_STMT(BPF_LD  | BPF_W   | BPF_ABS, (uint32_t) SKF_NET_OFF + off),
+			BPF_STMT(BPF_ALU | BPF_MOD | BPF_K,   (uint32_t) s->reuseport.shards),
+			BPF_STMT(BPF_RET | BPF_A,             0)
+		};
+
+		struct sock_fprog prog = {
+			.len = ARRAY_LEN(code),
+			.filter = code
+		};
+
+		/* The program is shared by all sockets of the reuseport group.
+		 * It must be attached after binding, as the group is created by bind(). */
+		ret = setsockopt(s->sd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog));
+		if (ret)
+			throw SystemError("Failed to attach steering program");
+	}
+#endif /* SO_ATTACH_REUSEPORT_CBPF */
+
 	if (s->multicast.enabled) {
 		ret = setsockopt(s->sd, IPPROTO_IP, IP_MULTICAST_LOOP, &s->multicast.loop, sizeof(s->multicast.loop));
 		if (ret)
@@ -273,6 +409,18 @@ int villas::node::socket_start(NodeCompat *n)
 #endif /* __linux__ */
 	}
 
+	/* Enable kernel / hardware timestamping */
+	const char *ifname = nullptr;
+#ifdef WITH_SOCKET_LAYER_ETH
+	char ifname_buf[IF_NAMESIZE];
+	if (s->layer == SocketLayer::ETH)
+		ifname = if_indextoname(s->in.saddr.sll.sll_ifindex, ifname_buf);
+#endif /* WITH_SOCKET_LAYER_ETH */
+
+	ret = timestamping_start(&s->timestamping, s->sd, ifname);
+	if (ret)
+		throw SystemError("Failed to enable timestamping");
+
 	s->out.buflen = SOCKET_INITIAL_BUFFER_LEN;
 	s->out.buf = new char[s->out.buflen];
 	if (!s->out.buf)
@@ -309,6 +457,14 @@ int villas::node::socket_stop(NodeCompat *n)
 			throw SystemError("Failed to leave multicast group");
 	}
 
+	if (s->ring.map) {
+		ret = munmap(s->ring.map, (size_t) s->ring.block_size * s->ring.block_count);
+		if (ret)
+			return ret;
+
+		s->ring.map = nullptr;
+	}
+
 	if (s->sd >= 0) {
 		ret = close(s->sd);
 		if (ret)
@@ -321,11 +477,115 @@ int villas::node::socket_stop(NodeCompat *n)
 	return 0;
 }
 
+#ifdef WITH_SOCKET_LAYER_ETH
+/** Read samples from the memory-mapped receive ring.
+ *
+ * Packets of all blocks which have been retired by the kernel are
+ * processed without any further system call.
+ */
+static
+int socket_read_ring(NodeCompat *n, struct Sample * const smps[], unsigned cnt)
+{
+	int ret;
+	auto *s = n->getData<struct Socket>();
+
+	unsigned nread = 0, last = 0;
+
+	while (nread < cnt) {
+		auto *bd = (struct tpacket_block_desc *) (s->ring.map + (size_t) s->ring.block * s->ring.block_size);
+
+		if (!s->ring.packet) {
+			/* The ring is shared with the kernel, hence we can not use std::atomic here */
+			if (!(__atomic_load_n(&bd->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER)) {
+				if (nread > 0)
+					break;
+
+				/* Wait until the kernel retires the next block */
+				struct pollfd pfd = {
+					.fd = s->sd,
+					.events = POLLIN | POLLERR,
+					.revents = 0
+				};
+
+				ret = poll(&pfd, 1, -1);
+				if (ret < 0) {
+					if (errno == EINTR)
+						return -1;
+
+					throw SystemError("Failed poll()");
+				}
+
+				continue;
+			}
+
+			s->ring.remaining = bd->hdr.bh1.num_pkts;
+			s->ring.packet = (char *) bd + bd->hdr.bh1.offset_to_first_pkt;
+		}
+
+		while (s->ring.remaining > 0) {
+			/* Do not start a new packet if its samples might not fit anymore */
+			if (nread >= cnt || (nread > 0 && cnt - nread < last))
+				return nread;
+
+			auto *hdr = (struct tpacket3_hdr *) s->ring.packet;
+			auto *sll = (struct sockaddr_ll *) (s->ring.packet + TPACKET_ALIGN(sizeof(struct tpacket3_hdr)));
+
+			s->ring.packet += hdr->tp_next_offset;
+			s->ring.remaining--;
+
+			if (s->verify_source && socket_compare_addr((struct sockaddr *) sll, &s->out.saddr.sa) != 0) {
+				char *buf = socket_print_addr((struct sockaddr *) sll);
+				n->logger->warn("Received packet from unauthorized source: {}", buf);
+				free(buf);
+
+				continue;
+			}
+
+			size_t rbytes;
+			char *ptr = (char *) hdr + hdr->tp_net;
+
+			ret = s->formatter->sscan(ptr, hdr->tp_snaplen, &rbytes, &smps[nread], cnt - nread);
+			if (ret < 0 || hdr->tp_snaplen != rbytes) {
+				n->logger->warn("Received invalid packet: ret={}, bytes={}, rbytes={}", ret, hdr->tp_snaplen, rbytes);
+
+				if (ret < 0)
+					continue;
+			}
+
+			/* The ring provides the kernel receive timestamp for free.
+			 * In hardware mode, we skip software timestamps as they are taken by a different clock. */
+			bool has_ts = s->timestamping.mode != TimestampingMode::HARDWARE || (hdr->tp_status & TP_STATUS_TS_RAW_HARDWARE);
+			for (int i = 0; has_ts && i < ret; i++) {
+				smps[nread + i]->ts.received.tv_sec = hdr->tp_sec;
+				smps[nread + i]->ts.received.tv_nsec = hdr->tp_nsec;
+				smps[nread + i]->flags |= (int) SampleFlags::HAS_TS_RECEIVED;
+			}
+
+			nread += ret;
+			last = ret;
+		}
+
+		/* Hand the block back to the kernel */
+		__atomic_store_n(&bd->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+
+		s->ring.block = (s->ring.block + 1) % s->ring.block_count;
+		s->ring.packet = nullptr;
+	}
+
+	return nread;
+}
+#endif /* WITH_SOCKET_LAYER_ETH */
+
 int villas::node::socket_read(NodeCompat *n, struct Sample * const smps[], unsigned cnt)
 {
 	int ret;
 	auto *s = n->getData<struct Socket>();
 
+#ifdef WITH_SOCKET_LAYER_ETH
+	if (s->ring.enabled)
+		return socket_read_ring(n, smps, cnt);
+#endif /* WITH_SOCKET_LAYER_ETH */
+
 	char *ptr;
 	ssize_t bytes;
 	size_t rbytes;
@@ -333,8 +593,10 @@ int villas::node::socket_read(NodeCompat *n, struct Sample * const smps[], unsig
 	union sockaddr_union src;
 	socklen_t srclen = sizeof(src);
 
+	struct timespec ts_received;
+
 	/* Receive next sample */
-	bytes = recvfrom(s->sd, s->in.buf, s->in.buflen, 0, &src.sa, &srclen);
+	bytes = timestamping_recv(&s->timestamping, s->sd, s->in.buf, s->in.buflen, 0, &src.sa, &srclen, &ts_received);
 	if (bytes < 0) {
 		if (errno == EINTR)
 			return -1;
@@ -380,6 +642,14 @@ int villas::node::socket_read(NodeCompat *n, struct Sample * const smps[], unsig
 	if (ret < 0 || (size_t) bytes != rbytes)
 		n->logger->warn("Received invalid packet: ret={}, bytes={}, rbytes={}", ret, bytes, rbytes);
 
+	/* Use the kernel / hardware receive timestamp if available */
+	if (ts_received.tv_sec || ts_received.tv_nsec) {
+		for (int i = 0; i < ret; i++) {
+			smps[i]->ts.received = ts_received;
+			smps[i]->flags |= (int) SampleFlags::HAS_TS_RECEIVED;
+		}
+	}
+
 	return ret;
 }
 
@@ -437,7 +707,10 @@ retry:	ret = s->formatter->sprint(s->out.buf, s->out.buflen, &wbytes, smps, cnt)
 			addrlen = sizeof(s->in.saddr);
 	}
 
-retry2:	bytes = sendto(s->sd, s->out.buf, wbytes, 0, (struct sockaddr *) &s->out.saddr, addrlen);
+	struct timespec ts_sent;
+
+retry2:	ts_sent = clock_now();
+	bytes = sendto(s->sd, s->out.buf, wbytes, 0, (struct sockaddr *) &s->out.saddr, addrlen);
 	if (bytes < 0) {
 		if ((errno == EPERM) ||
 		    (errno == ENOENT && s->layer == SocketLayer::UNIX))
@@ -449,8 +722,21 @@ retry2:	bytes = sendto(s->sd, s->out.buf, wbytes, 0, (struct sockaddr *) &s->out
 		else
 			n->logger->warn("Failed sendto(): {}", strerror(errno));
 	}
-	else if ((size_t) bytes < wbytes)
-		n->logger->warn("Partial sendto()");
+	else {
+		if ((size_t) bytes < wbytes)
+			n->logger->warn("Partial sendto()");
+
+		timestamping_sent(&s->timestamping, &ts_sent);
+	}
+
+	/* Collect transmit timestamps of previously sent packets */
+	double delays[16];
+	int num = timestamping_tx_delays(&s->timestamping, s->sd, delays, ARRAY_LEN(delays));
+	auto stats = n->getStats();
+	if (stats) {
+		for (int i = 0; i < num; i++)
+			stats->update(Stats::Metric::TX_DELAY, delays[i]);
+	}
 
 	return cnt;
 }
@@ -466,20 +752,28 @@ int villas::node::socket_parse(NodeCompat *n, json_t *json)
 	json_error_t err;
 	json_t *json_multicast = nullptr;
 	json_t *json_format = nullptr;
+	json_t *json_timestamping = nullptr;
+	json_t *json_ring = nullptr;
+	json_t *json_reuseport = nullptr;
 
 	/* Default values */
 	s->layer = SocketLayer::UDP;
 	s->verify_source = 0;
+	s->timestamping.mode = TimestampingMode::NONE;
+	s->timestamping.tx = 0;
 
-	ret = json_unpack_ex(json, &err, 0, "{ s?: s, s?: o, s: { s: s }, s: { s: s, s?: b, s?: o } }",
+	ret = json_unpack_ex(json, &err, 0, "{ s?: s, s?: o, s?: o, s: { s: s }, s: { s: s, s?: b, s?: o, s?: o, s?: o } }",
 		"layer", &layer,
 		"format", &json_format,
+		"timestamping", &json_timestamping,
 		"out",
 			"address", &remote,
 		"in",
 			"address", &local,
 			"verify_source", &s->verify_source,
-			"multicast", &json_multicast
+			"multicast", &json_multicast,
+			"ring", &json_ring,
+			"reuseport", &json_reuseport
 	);
 	if (ret)
 		throw ConfigError(json, err, "node-config-node-socket");
@@ -493,6 +787,12 @@ int villas::node::socket_parse(NodeCompat *n, json_t *json)
 	if (!s->formatter)
 		throw ConfigError(json_format, "node-config-node-socket-format", "Invalid format configuration");
 
+	if (json_timestamping) {
+		ret = timestamping_parse(&s->timestamping, json_timestamping);
+		if (ret)
+			return ret;
+	}
+
 	/* IP layer */
 	if (layer) {
 		if (!strcmp(layer, "ip"))
@@ -517,6 +817,49 @@ int villas::node::socket_parse(NodeCompat *n, json_t *json)
 	if (ret)
 		throw SystemError("Failed to resolve local address '{}': {}", local, gai_strerror(ret));
 
+	if (json_reuseport) {
+		const char *steering = nullptr;
+
+		/* Default values */
+		s->reuseport.enabled = true;
+
+		ret = json_unpack_ex(json_reuseport, &err, 0, "{ s?: b, s?: i, s?: s }",
+			"enabled", &s->reuseport.enabled,
+			"shards", &s->reuseport.shards,
+			"steering", &steering
+		);
+		if (ret)
+			throw ConfigError(json_reuseport, err, "node-config-node-socket-reuseport", "Failed to parse reuseport settings");
+
+		if (steering) {
+			if (!strcmp(steering, "source"))
+				s->reuseport.steering = 1;
+			else if (!strcmp(steering, "none"))
+				s->reuseport.steering = 0;
+			else
+				throw ConfigError(json_reuseport, "node-config-node-socket-reuseport-steering", "Invalid steering mode: {}", steering);
+		}
+	}
+
+	if (json_ring) {
+		/* Default values */
+		s->ring.enabled = true;
+		s->ring.block_size = SOCKET_RING_BLOCK_SIZE;
+		s->ring.block_count = SOCKET_RING_BLOCK_COUNT;
+		s->ring.frame_size = SOCKET_RING_FRAME_SIZE;
+		s->ring.timeout = SOCKET_RING_TIMEOUT;
+
+		ret = json_unpack_ex(json_ring, &err, 0, "{ s?: b, s?: i, s?: i, s?: i, s?: i }",
+			"enabled", &s->ring.enabled,
+			"block_size", &s->ring.block_size,
+			"block_count", &s->ring.block_count,
+			"frame_size", &s->ring.frame_size,
+			"timeout", &s->ring.timeout
+		);
+		if (ret)
+			throw ConfigError(json_ring, err, "node-config-node-socket-ring", "Failed to parse receive ring settings");
+	}
+
 	if (json_multicast) {
 		const char *group, *interface = nullptr;
 
@@ -15,6 +15,7 @@
 #include <villas/node_compat.hpp>
 #include <villas/utils.hpp>
 #include <villas/timing.hpp>
+#include <villas/clock.hpp>
 #include <villas/exceptions.hpp>
 #include <villas/node_compat.hpp>
 #include <villas/nodes/test_rtt.hpp>
@@ -56,6 +57,9 @@ int test_rtt_case_stop(NodeCompat *n, int id)
 	/* Stop timer */
 	t->task.stop();
 
+	if (t->task.getSlack() > 0)
+		t->task.printStats(n->logger);
+
 	ret = fclose(t->stream);
 	if (ret)
 		throw SystemError("Failed to close file");
@@ -118,7 +122,7 @@ int villas::node::test_rtt_parse(NodeCompat *n, json_t *json)
 	std::vector<int> values;
 
 	size_t i;
-	json_t *json_cases, *json_case, *json_val, *json_format = nullptr;
+	json_t *json_cases, *json_case, *json_val, *json_format = nullptr, *json_timer = nullptr;
 	json_t *json_rates = nullptr, *json_values = nullptr;
 	json_error_t err;
 
@@ -129,16 +133,20 @@ int villas::node::test_rtt_parse(NodeCompat *n, json_t *json)
 	if (ret)
 		return ret;
 
-	ret = json_unpack_ex(json, &err, 0, "{ s?: s, s?: s, s?: o, s?: F, s: o }",
+	ret = json_unpack_ex(json, &err, 0, "{ s?: s, s?: s, s?: o, s?: F, s?: o, s: o }",
 		"prefix", &prefix,
 		"output", &output,
 		"format", &json_format,
 		"cooldown", &t->cooldown,
+		"timer", &json_timer,
 		"cases", &json_cases
 	);
 	if (ret)
 		throw ConfigError(json, err, "node-config-node-test-rtt");
 
+	if (json_timer)
+		t->task.parse(json_timer);
+
 	t->output = strdup(output);
 	t->prefix = strdup(prefix ? prefix : n->getNameShort().c_str());
 
@@ -235,7 +243,7 @@ int villas::node::test_rtt_init(NodeCompat *n)
 {
 	auto *t = n->getData<struct test_rtt>();
 
-	new (&t->task) Task(CLOCK_MONOTONIC);
+	new (&t->task) PrecisionTask(CLOCK_MONOTONIC);
 
 	t->formatter = nullptr;
 
@@ -251,7 +259,7 @@ int villas::node::test_rtt_destroy(NodeCompat *n)
 	if (ret)
 		return ret;
 
-	t->task.~Task();
+	t->task.~PrecisionTask();
 
 	if (t->output)
 		free(t->output);
@@ -368,7 +376,7 @@ int villas::node::test_rtt_read(NodeCompat *n, struct Sample * const smps[], uns
 		return 0;
 	}
 	else {
-		struct timespec now = time_now();
+		struct timespec now = clock_now();
 
 		/* Prepare samples */
 		for (i = 0; i < cnt; i++) {
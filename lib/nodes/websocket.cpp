@@ -14,8 +14,10 @@
 #include <libwebsockets.h>
 
 #include <villas/timing.hpp>
+#include <villas/clock.hpp>
 #include <villas/exceptions.hpp>
 #include <villas/utils.hpp>
+#include <villas/node/log.hpp>
 #include <villas/node_compat.hpp>
 #include <villas/nodes/websocket.hpp>
 #include <villas/super_node.hpp>
@@ -51,6 +53,7 @@ int websocket_connection_init(struct websocket_connection *c)
 {
 	int ret;
 
+	/* Several paths or writer threads may write to the same connection concurrently */
 	ret = queue_init(&c->queue, DEFAULT_QUEUE_LENGTH);
 	if (ret)
 		return ret;
@@ -110,7 +113,7 @@ int websocket_connection_write(struct websocket_connection *c, struct Sample * c
 
 	sample_incref_many(smps, pushed);
 
-	c->node->logger->debug("Enqueued {} samples to {}", pushed, c->toString());
+	VILLAS_LOG_DEBUG(c->node->logger, "Enqueued {} samples to {}", pushed, c->toString());
 
 	/* Client connections which are currently connecting don't have an associate c->wsi yet */
 	if (c->wsi)
@@ -260,7 +263,7 @@ int villas::node::websocket_protocol_cb(struct lws *wsi, enum lws_callback_reaso
 				if (ret < 0)
 					return ret;
 
-				c->node->logger->debug("Send {} samples to connection: {}, bytes={}", pulled, c->toString(), ret);
+				VILLAS_LOG_DEBUG(c->node->logger, "Send {} samples to connection: {}, bytes={}", pulled, c->toString(), ret);
 			}
 
 			if (queue_available(&c->queue) > 0)
@@ -282,7 +285,7 @@ int villas::node::websocket_protocol_cb(struct lws *wsi, enum lws_callback_reaso
 
 			/* We dont try to parse the frame yet, as we have to wait for the remaining fragments */
 			if (lws_is_final_fragment(wsi)) {
-				struct timespec ts_recv = time_now();
+				struct timespec ts_recv = clock_now();
 				auto *n = c->node;
 
 				int avail, enqueued;
@@ -299,7 +302,7 @@ int villas::node::websocket_protocol_cb(struct lws *wsi, enum lws_callback_reaso
 					break;
 				}
 
-				c->node->logger->debug("Received {} samples from connection: {}", recvd, c->toString());
+				VILLAS_LOG_DEBUG(c->node->logger, "Received {} samples from connection: {}", recvd, c->toString());
 
 				/* Set receive timestamp */
 				for (int i = 0; i < recvd; i++) {
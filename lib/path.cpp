@@ -17,14 +17,18 @@
 
 #include <unistd.h>
 #include <poll.h>
+#include <sched.h>
 
 #include <villas/node/config.hpp>
 #include <villas/utils.hpp>
+#include <villas/node/log.hpp>
 #include <villas/colors.hpp>
 #include <villas/uuid.hpp>
 #include <villas/timing.hpp>
+#include <villas/clock.hpp>
 #include <villas/pool.hpp>
 #include <villas/queue.h>
+#include <villas/queue_signalled.h>
 #include <villas/hook.hpp>
 #include <villas/hook_list.hpp>
 #include <villas/node/memory.hpp>
@@ -67,8 +71,11 @@ void * Path::runSingle()
 		if (ret <= 0)
 			continue;
 
-		for (auto pd : destinations)
-			pd->write();
+		/* Pipelined destinations are written by their own threads */
+		if (!pipelined) {
+			for (auto pd : destinations)
+				pd->write();
+		}
 	}
 
 	return nullptr;
@@ -87,7 +94,7 @@ void * Path::runPoll()
 		if (ret < 0)
 			throw SystemError("Failed to poll");
 
-		logger->debug("returned from poll(2): ret={}", ret);
+		VILLAS_LOG_DEBUG(logger, "returned from poll(2): ret={}", ret);
 
 		for (unsigned i = 0; i < pfds.size(); i++) {
 			auto &pfd = pfds[i];
@@ -99,7 +106,16 @@ void * Path::runPoll()
 
 					last_sample->sequence = last_sequence++;
 
-					PathDestination::enqueueAll(this, &last_sample, 1);
+					/* The path thread continues to modify the last sample */
+					if (pipelined) {
+						struct Sample *smp = sample_clone(last_sample);
+						if (smp) {
+							pipelinePush(&smp, 1, (int) PipelineFlags::FORWARD);
+							sample_decref(smp);
+						}
+					}
+					else
+						PathDestination::enqueueAll(this, &last_sample, 1);
 				}
 				/* A source is ready to receive samples */
 				else {
@@ -110,13 +126,125 @@ void * Path::runPoll()
 			}
 		}
 
-		for (auto pd : destinations)
-			pd->write();
+		/* Pipelined destinations are written by their own threads */
+		if (!pipelined) {
+			for (auto pd : destinations)
+				pd->write();
+		}
+	}
+
+	return nullptr;
+}
+
+void * Path::runHooksWrapper(void *arg)
+{
+	auto *p = (Path *) arg;
+
+	return p->runHooks();
+}
+
+/** Hook thread of a pipelined path:
+ *     run hooks on muxed samples -> enqueue samples to destinations
+ *
+ * The path thread only reads and muxes samples and each destination
+ * is written by its own thread.
+ *
+ * The thread is not cancelled but stopped by Path::stop() via hooks_stop
+ * after the path thread has been joined. All samples which are still in
+ * the pipeline are processed and forwarded before the thread exits.
+ */
+void * Path::runHooks()
+{
+	unsigned cnt = queuelen;
+
+	void *tagged[cnt];
+	struct Sample *smps[cnt];
+
+	int fd = queue_signalled_fd(&pipeline);
+
+	while (true) {
+		/* The flag must be read before the queue so that no sample is left behind */
+		bool stop = hooks_stop;
+
+		int pulled = queue_pull_many(&pipeline.queue, tagged, cnt);
+		if (pulled < 0)
+			break;
+		else if (pulled == 0) {
+			if (stop)
+				break;
+
+			/* Wait until the queue is signalled */
+			uint64_t cntr;
+
+			if (fd >= 0) {
+				if (::read(fd, &cntr, sizeof(cntr)) < 0 && errno != EINTR)
+					break;
+			}
+			else
+				sched_yield();
+
+			continue;
+		}
+
+		auto since = PathStage::clock::now();
+
+		/* Process consecutive samples with equal flags as a batch */
+		for (int i = 0, n; i < pulled; i += n) {
+			uintptr_t flags = (uintptr_t) tagged[i] & (uintptr_t) PipelineFlags::MASK;
+
+			for (n = 0; i + n < pulled && ((uintptr_t) tagged[i + n] & (uintptr_t) PipelineFlags::MASK) == flags; n++)
+				smps[n] = (struct Sample *) ((uintptr_t) tagged[i + n] & ~(uintptr_t) PipelineFlags::MASK);
+
+			int toenqueue = n;
+
+#ifdef WITH_HOOKS
+			if (flags & (uintptr_t) PipelineFlags::PROCESS) {
+				toenqueue = hooks.process(smps, n);
+				if (toenqueue == -1) {
+					logger->error("An error occured during hook processing. Skipping sample");
+					toenqueue = 0;
+				}
+			}
+#endif /* WITH_HOOKS */
+
+			if (flags & (uintptr_t) PipelineFlags::FORWARD && toenqueue > 0)
+				PathDestination::enqueueAll(this, smps, toenqueue);
+
+			sample_decref_many(smps, n);
+		}
+
+		hooks_stage.account(since, pulled);
 	}
 
 	return nullptr;
 }
 
+void Path::pipelinePush(struct Sample * const smps[], unsigned cnt, int flags)
+{
+	void *tagged[cnt];
+
+	for (unsigned i = 0; i < cnt; i++) {
+		assert(((uintptr_t) smps[i] & (uintptr_t) PipelineFlags::MASK) == 0);
+
+		tagged[i] = (void *) ((uintptr_t) smps[i] | flags);
+	}
+
+	/* The references are now owned by the pipeline */
+	sample_incref_many(smps, cnt);
+
+	int pushed = queue_signalled_push_many(&pipeline, tagged, cnt);
+	if (pushed < 0)
+		pushed = 0;
+
+	if ((unsigned) pushed < cnt) {
+		sample_decref_many(smps + pushed, cnt - pushed);
+
+		mux_stage.overruns += cnt - pushed;
+
+		VILLAS_LOG_DEBUG(logger, "Pipeline overrun for path {}: pushed={}, expected={}", this->toString(), pushed, cnt);
+	}
+}
+
 Path::Path() :
 	state(State::INITIALIZED),
 	mode(Mode::ANY),
@@ -129,11 +257,17 @@ Path::Path() :
 	builtin(true),
 	original_sequence_no(-1),
 	queuelen(DEFAULT_QUEUE_LENGTH),
+	spsc(true), /* The path thread is the only producer and consumer of its destination queues */
+	pool_size(0),
+	pool_max(0),
+	pipelined(false),
+	hooks_stop(false),
 	logger(logging.get(fmt::format("path:{}", id++)))
 {
 	uuid_clear(uuid);
 
 	pool.state = State::DESTROYED;
+	pipeline.queue.state = State::DESTROYED;
 }
 
 void Path::startPoll()
@@ -180,6 +314,8 @@ void Path::prepare(NodeList &nodes)
 
 	assert(state == State::CHECKED);
 
+	uuid_unparse_lower(uuid, uuid_string);
+
 	mask.reset();
 	signals = std::make_shared<SignalList>();
 
@@ -288,11 +424,23 @@ void Path::prepare(NodeList &nodes)
 			mt_cnt++;
 		}
 
-		ret = pd->prepare(queuelen);
+		ret = pd->prepare(queuelen, spsc, pipelined);
 		if (ret)
 			throw RuntimeError("Failed to prepare path destination {} of path {}", pd->node->getName(), this->toString());
 	}
 
+	/* The path thread is the only producer and the hook thread the only consumer of the pipeline */
+	if (pipelined) {
+		QueueSignalledMode mode = QueueSignalledMode::POLLING;
+#ifdef HAS_EVENTFD
+		mode = QueueSignalledMode::EVENTFD;
+#endif /* HAS_EVENTFD */
+
+		ret = queue_signalled_init(&pipeline, queuelen, memory::default_type, mode, (int) QueueFlags::SPSC);
+		if (ret)
+			throw RuntimeError("Failed to initialize pipeline of path {}", this->toString());
+	}
+
 	/* Autodetect whether to use original sequence numbers or not */
 	if (original_sequence_no == -1)
 		original_sequence_no = sources.size() == 1;
@@ -319,11 +467,32 @@ void Path::prepare(NodeList &nodes)
 	hooks.dump(logger, fmt::format("path {}", this->toString()));
 #endif /* WITH_HOOKS */
 
-	/* Prepare pool */
+	/* Prepare pool
+	 *
+	 * Each destination may hold as many samples as it has credits plus one
+	 * coalesced sample. The remainder is reserved for samples in flight,
+	 * so that a slow destination can not starve the others.
+	 * Unless configured otherwise, the pool may grow to four times its initial size.
+	 */
 	auto osigs = getOutputSignals();
-	unsigned pool_size = MAX(1UL, destinations.size()) * queuelen;
+	size_t auto_size = 0, vectorize = 1;
+
+	for (auto pd : destinations)
+		auto_size += pd->getCredits() + 1;
+
+	for (auto ps : sources)
+		vectorize = MAX(vectorize, (size_t) ps->getNode()->in.vectorize);
+
+	auto_size += MAX((size_t) queuelen, 2 * vectorize + 1);
 
-	ret = pool_init(&pool, pool_size, SAMPLE_LENGTH(osigs->size()), pool_mt);
+	/* Samples which are on their way to the hook thread */
+	if (pipelined)
+		auto_size += queuelen;
+
+	size_t size = pool_size ? pool_size : auto_size;
+	size_t max = pool_max ? pool_max : 4 * MAX(size, auto_size);
+
+	ret = pool_init_elastic(&pool, size, max, SAMPLE_LENGTH(osigs->size()), pool_mt);
 	if (ret)
 		throw RuntimeError("Failed to initialize pool of path: {}", this->toString());
 
@@ -338,18 +507,21 @@ void Path::prepare(NodeList &nodes)
 
 void Path::parse(json_t *json, NodeList &nodes, const uuid_t sn_uuid)
 {
-	int ret, en = -1, rev = -1;
+	int ret, en = -1, rev = -1, pl = -1;
 
 	json_error_t err;
 	json_t *json_in;
 	json_t *json_out = nullptr;
 	json_t *json_hooks = nullptr;
 	json_t *json_mask = nullptr;
+	json_t *json_timer = nullptr;
+	json_t *json_overflow = nullptr;
+	json_t *json_pool = nullptr;
 
 	const char *mode_str = nullptr;
 	const char *uuid_str = nullptr;
 
-	ret = json_unpack_ex(json, &err, 0, "{ s: o, s?: o, s?: o, s?: b, s?: b, s?: b, s?: i, s?: s, s?: b, s?: F, s?: o, s?: b, s?: s, s?: i }",
+	ret = json_unpack_ex(json, &err, 0, "{ s: o, s?: o, s?: o, s?: b, s?: b, s?: b, s?: i, s?: b, s?: s, s?: b, s?: F, s?: o, s?: o, s?: b, s?: s, s?: i, s?: o, s?: o, s?: b }",
 		"in", &json_in,
 		"out", &json_out,
 		"hooks", &json_hooks,
@@ -357,13 +529,18 @@ void Path::parse(json_t *json, NodeList &nodes, const uuid_t sn_uuid)
 		"enabled", &en,
 		"builtin", &builtin,
 		"queuelen", &queuelen,
+		"spsc", &spsc,
 		"mode", &mode_str,
 		"poll", &poll,
 		"rate", &rate,
+		"timer", &json_timer,
 		"mask", &json_mask,
 		"original_sequence_no", &original_sequence_no,
 		"uuid", &uuid_str,
-		"affinity", &affinity
+		"affinity", &affinity,
+		"overflow", &json_overflow,
+		"pool", &json_pool,
+		"pipeline", &pl
 	);
 	if (ret)
 		throw ConfigError(json, err, "node-config-path", "Failed to parse path configuration");
@@ -374,6 +551,15 @@ void Path::parse(json_t *json, NodeList &nodes, const uuid_t sn_uuid)
 	if (rev >= 0)
 		reversed = rev != 0;
 
+	if (pl >= 0)
+		pipelined = pl != 0;
+
+	if (json_timer)
+		timeout.parse(json_timer);
+
+	if (json_pool)
+		pool_parse(json_pool, &pool_size, &pool_max);
+
 	/* Optional settings */
 	if (mode_str) {
 		if      (!strcmp(mode_str, "any"))
@@ -417,6 +603,17 @@ void Path::parse(json_t *json, NodeList &nodes, const uuid_t sn_uuid)
 		if (!pd)
 			throw MemoryAllocationError();
 
+		/* Overflow settings of the path can be overwritten per destination node */
+		json_t *json_node_overflow = n->out.config
+			? json_object_get(n->out.config, "overflow")
+			: nullptr;
+
+		if (json_overflow)
+			pd->parse(json_overflow);
+
+		if (json_node_overflow)
+			pd->parse(json_node_overflow);
+
 		n->destinations.push_back(pd);
 		destinations.push_back(pd);
 	}
@@ -521,7 +718,7 @@ void Path::start()
 
 	logger->info("Starting path {}: #signals={}/{}, #hooks={}, #sources={}, "
 	                "#destinations={}, mode={}, poll={}, mask=0b{:b}, rate={}, "
-	                "enabled={}, reversed={}, queuelen={}, original_sequence_no={}",
+	                "enabled={}, reversed={}, queuelen={}, original_sequence_no={}, pipelined={}",
 		this->toString(),
 		signals->size(),
 		getOutputSignals()->size(),
@@ -535,7 +732,8 @@ void Path::start()
 		isEnabled() ? "yes" : "no",
 		isReversed() ? "yes" : "no",
 		queuelen,
-		original_sequence_no ? "yes" : "no"
+		original_sequence_no ? "yes" : "no",
+		pipelined ? "yes" : "no"
 	);
 
 #ifdef WITH_HOOKS
@@ -554,7 +752,7 @@ void Path::start()
 	last_sample->length = signals->size();
 	last_sample->signals = signals;
 
-	last_sample->ts.origin = time_now();
+	last_sample->ts.origin = clock_now();
 	last_sample->flags = (int) SampleFlags::HAS_TS_ORIGIN;
 
 	last_sample->sequence = 0;
@@ -574,6 +772,24 @@ void Path::start()
 
 	state = State::STARTED;
 
+	/* Start the hook thread and one writer thread per destination */
+	if (pipelined) {
+		mux_stage.start();
+		hooks_stage.start();
+
+		hooks_stop = false;
+
+		ret = pthread_create(&hooks_tid, nullptr, runHooksWrapper, this);
+		if (ret)
+			throw RuntimeError("Failed to create hook thread of path");
+
+		if (affinity)
+			kernel::rt::setThreadAffinity(hooks_tid, affinity);
+	}
+
+	for (auto pd : destinations)
+		pd->start();
+
 	/* Start one thread per path for sending to destinations
 	 *
 	 * Special case: If the path only has a single source and this source
@@ -602,6 +818,8 @@ void Path::stop()
 		state = State::STOPPING;
 
 	/* Cancel the thread in case is currently in a blocking syscall.
+	 * Only the path thread blocks in the read functions of the nodes
+	 * which can not be woken up otherwise.
 	 *
 	 * We dont care if the thread has already been terminated.
 	 */
@@ -613,21 +831,93 @@ void Path::stop()
 	if (ret)
 		throw RuntimeError("Failed to join path thread");
 
+	/* The path thread was the only producer of the pipeline. Now the hook thread
+	 * processes the remaining samples before it exits, followed by the writer
+	 * threads of the destinations further below. This way, no sample which
+	 * has been read is lost or reordered on its way to the destinations.
+	 */
+	if (pipelined) {
+		hooks_stop = true;
+
+		/* Wake up the hook thread if it is waiting for samples */
+		ret = queue_signalled_push_many(&pipeline, nullptr, 0);
+		if (ret < 0)
+			throw RuntimeError("Failed to wake up hook thread of path");
+
+		ret = pthread_join(hooks_tid, nullptr);
+		if (ret)
+			throw RuntimeError("Failed to join hook thread of path");
+
+		/* Release samples which have been left behind by a failing hook thread */
+		void *tagged[16];
+		int pulled;
+		while ((pulled = queue_pull_many(&pipeline.queue, tagged, ARRAY_LEN(tagged))) > 0) {
+			for (int i = 0; i < pulled; i++)
+				sample_decref((struct Sample *) ((uintptr_t) tagged[i] & ~(uintptr_t) PipelineFlags::MASK));
+		}
+
+		logger->info("Pipeline of path {}: utilisation mux={:.1f}%, hooks={:.1f}%, overruns={}",
+			this->toString(), 100 * mux_stage.getUtilisation(), 100 * hooks_stage.getUtilisation(), mux_stage.overruns.load());
+	}
+
 #ifdef WITH_HOOKS
 	hooks.stop();
 #endif /* WITH_HOOKS */
 
 	sample_decref(last_sample);
 
+	for (auto pd : destinations)
+		pd->stop();
+
+	/* Report high-water marks which help to size the pools statically */
+	logger->info("Pool of path {}: high-water mark {} of {} samples ({} grows, {} shrinks)",
+		this->toString(), pool.high_water.load(), pool_capacity(&pool), pool.grows.load(), pool.shrinks.load());
+
+	for (auto ps : sources)
+		logger->info("Pool of path source {}: high-water mark {} of {} samples ({} grows, {} shrinks)",
+			ps->node->getName(), ps->pool.high_water.load(), pool_capacity(&ps->pool), ps->pool.grows.load(), ps->pool.shrinks.load());
+
+	if (rate > 0) {
+		timeout.stop();
+		timeout.printStats(logger);
+	}
+
 	state = State::STOPPED;
 }
 
+void Path::replaceHooks(json_t *json)
+{
+#ifdef WITH_HOOKS
+	if (state != State::PREPARED &&
+	    state != State::STARTED &&
+	    state != State::PAUSED &&
+	    state != State::STOPPED)
+		throw RuntimeError("Path {} must be prepared before its hooks can be replaced", this->toString());
+
+	int m = builtin
+		? (int) Hook::Flags::PATH |
+		  (int) Hook::Flags::BUILTIN
+		: 0;
+
+	bool running = state == State::STARTED || state == State::PAUSED;
+
+	hooks.replace(json, (int) Hook::Flags::PATH, signals, m, this, nullptr, running);
+
+	logger->info("Replaced hooks of path {}", this->toString());
+#else
+	throw RuntimeError("Hooks are not supported");
+#endif /* WITH_HOOKS */
+}
+
 Path::~Path()
 {
 	int ret __attribute__((unused));
 
 	assert(state != State::DESTROYED);
 
+	if (pipeline.queue.state != State::DESTROYED)
+		ret = queue_signalled_destroy(&pipeline);
+
 	ret = pool_destroy(&pool);
 }
 
@@ -707,14 +997,29 @@ json_t * Path::toJson() const
 #endif /* WITH_HOOKS */
 	json_t *json_sources = json_array();
 	json_t *json_destinations = json_array();
+	json_t *json_destination_stats = json_array();
+	json_t *json_pools = json_object();
 
-	for (auto ps : sources)
+	if (pool.state != State::DESTROYED)
+		json_object_set_new(json_pools, "path", pool_to_json(&pool));
+
+	json_t *json_pipeline = pipelined
+		? json_pack("{ s: o, s: o }",
+			"mux", mux_stage.toJson(),
+			"hooks", hooks_stage.toJson())
+		: json_null();
+
+	for (auto ps : sources) {
 		json_array_append_new(json_sources, json_string(ps->node->getNameShort().c_str()));
+		json_object_set_new(json_pools, ps->node->getNameShort().c_str(), pool_to_json(&ps->pool));
+	}
 
-	for (auto pd : destinations)
+	for (auto pd : destinations) {
 		json_array_append_new(json_destinations, json_string(pd->node->getNameShort().c_str()));
+		json_array_append_new(json_destination_stats, pd->toJson());
+	}
 
-	json_t *json_path = json_pack("{ s: s, s: s, s: s, s: b, s: b s: b, s: b, s: b, s: b s: i, s: o, s: o, s: o, s: o }",
+	json_t *json_path = json_pack("{ s: s, s: s, s: s, s: b, s: b s: b, s: b, s: b, s: b s: i, s: o, s: o, s: o, s: o, s: o, s: o, s: o }",
 		"uuid", uuid_str,
 		"state", stateToString(state).c_str(),
 		"mode", mode == Mode::ANY ? "any" : "all",
@@ -728,7 +1033,10 @@ json_t * Path::toJson() const
 		"signals", json_signals,
 		"hooks", json_hooks,
 		"in", json_sources,
-		"out", json_destinations
+		"out", json_destinations,
+		"destinations", json_destination_stats,
+		"pools", json_pools,
+		"pipeline", json_pipeline
 	);
 
 	return json_path;
@@ -5,36 +5,138 @@
  * @license Apache 2.0
  *********************************************************************************/
 
+#include <chrono>
+#include <cstring>
+#include <cerrno>
+
+#include <sched.h>
+#include <unistd.h>
+
 #include <villas/utils.hpp>
+#include <villas/node/log.hpp>
+#include <villas/node/trace.hpp>
 #include <villas/node/memory.hpp>
 #include <villas/sample.hpp>
 #include <villas/node.hpp>
 #include <villas/path.hpp>
 #include <villas/exceptions.hpp>
+#include <villas/kernel/rt.hpp>
 #include <villas/path_destination.hpp>
 
 using namespace villas;
 using namespace villas::node;
 
+static
+const char * overflowPolicyToString(enum PathDestination::OverflowPolicy policy)
+{
+	switch (policy) {
+		case PathDestination::OverflowPolicy::DROP_NEWEST:
+			return "drop_newest";
+
+		case PathDestination::OverflowPolicy::DROP_OLDEST:
+			return "drop_oldest";
+
+		case PathDestination::OverflowPolicy::BLOCK:
+			return "block";
+
+		case PathDestination::OverflowPolicy::COALESCE:
+			return "coalesce";
+	}
+
+	return nullptr;
+}
+
 PathDestination::PathDestination(Path *p, Node *n) :
 	node(n),
-	path(p)
+	path(p),
+	policy(OverflowPolicy::DROP_NEWEST),
+	credits(0), /* Defaults to the queue length of the path */
+	used(0),
+	timeout(0.1),
+	pending(nullptr),
+	counters(),
+	pipelined(false),
+	writer_stop(false)
 {
-	queue.state = State::DESTROYED;
+	queue.queue.state = State::DESTROYED;
 }
 
 PathDestination::~PathDestination()
 {
 	int ret __attribute__((unused));
 
-	ret = queue_destroy(&queue);
+	if (queue.queue.state != State::DESTROYED)
+		ret = queue_signalled_destroy(&queue);
 }
 
-int PathDestination::prepare(int queuelen)
+void PathDestination::parse(json_t *json)
+{
+	int ret, cr = -1;
+	const char *policy_str = nullptr;
+	json_error_t err;
+
+	if (json_is_string(json))
+		policy_str = json_string_value(json);
+	else {
+		ret = json_unpack_ex(json, &err, 0, "{ s?: s, s?: i, s?: F }",
+			"policy", &policy_str,
+			"credits", &cr,
+			"timeout", &timeout
+		);
+		if (ret)
+			throw ConfigError(json, err, "node-config-path-overflow", "Failed to parse overflow settings");
+	}
+
+	if (policy_str) {
+		if      (!strcmp(policy_str, "drop_newest"))
+			policy = OverflowPolicy::DROP_NEWEST;
+		else if (!strcmp(policy_str, "drop_oldest"))
+			policy = OverflowPolicy::DROP_OLDEST;
+		else if (!strcmp(policy_str, "block"))
+			policy = OverflowPolicy::BLOCK;
+		else if (!strcmp(policy_str, "coalesce"))
+			policy = OverflowPolicy::COALESCE;
+		else
+			throw ConfigError(json, "node-config-path-overflow", "Invalid overflow policy '{}'", policy_str);
+	}
+
+	if (cr == 0 || cr < -1)
+		throw ConfigError(json, "node-config-path-overflow", "Setting 'credits' must be a positive number");
+	else if (cr > 0)
+		credits = cr;
+
+	if (timeout < 0)
+		throw ConfigError(json, "node-config-path-overflow", "Setting 'timeout' must not be negative");
+}
+
+int PathDestination::prepare(int queuelen, bool spsc, bool pipelined)
 {
 	int ret;
 
-	ret = queue_init(&queue, queuelen);
+	if (credits == 0)
+		credits = queuelen;
+	else if (credits > (unsigned) queuelen) {
+		path->logger->warn("Credits of destination {} exceed the queue length. Limiting to {}", node->getName(), queuelen);
+		credits = queuelen;
+	}
+
+	/* Only the writer thread of a pipelined destination waits for samples.
+	 * Otherwise we do not need to signal the queue at all.
+	 */
+	this->pipelined = pipelined;
+
+	/* A pipelined writer thread waits for the eventfd of the queue */
+	QueueSignalledMode mode = QueueSignalledMode::POLLING;
+#ifdef HAS_EVENTFD
+	if (pipelined)
+		mode = QueueSignalledMode::EVENTFD;
+#endif /* HAS_EVENTFD */
+
+	/* Dropping the oldest samples pulls from the queue concurrently to the writer thread */
+	if (pipelined && policy == OverflowPolicy::DROP_OLDEST)
+		spsc = false;
+
+	ret = queue_signalled_init(&queue, queuelen, memory::default_type, mode, spsc ? (int) QueueFlags::SPSC : 0);
 	if (ret)
 		return ret;
 
@@ -43,58 +145,341 @@ int PathDestination::prepare(int queuelen)
 
 void PathDestination::enqueueAll(Path *p, const struct Sample * const smps[], unsigned cnt)
 {
-	unsigned enqueued, cloned;
+	unsigned cloned;
 
 	struct Sample *clones[cnt];
 
+	VILLAS_TRACE(path_enqueue_start, p->uuid_string, cnt);
+
 	cloned = sample_clone_many(clones, smps, cnt);
 	if (cloned < cnt)
 		p->logger->warn("Pool underrun in path {}", p->toString());
 
-	for (auto pd : p->destinations) {
-		enqueued = queue_push_many(&pd->queue, (void **) clones, cloned);
-		if (enqueued != cnt)
-			p->logger->warn("Queue overrun for path {}", p->toString());
+	if (VILLAS_TRACE_ENABLED(path_enqueue_sample)) {
+		for (unsigned i = 0; i < cloned; i++)
+			VILLAS_TRACE(path_enqueue_sample, p->uuid_string, smps[i], clones[i], clones[i]->sequence);
+	}
+
+	for (auto pd : p->destinations)
+		pd->enqueue(clones, cloned);
+
+	sample_decref_many(clones, cloned);
+
+	VILLAS_TRACE(path_enqueue_done, p->uuid_string, cnt, cloned);
+}
+
+void PathDestination::enqueue(struct Sample * const smps[], unsigned cnt)
+{
+	unsigned avail, accepted, skipped, enqueued;
+
+	flushPending();
+
+	/* Newer samples must not overtake a pending coalesced sample */
+	avail = pending ? 0 : credits - used;
+
+	if (cnt > avail) {
+		switch (policy) {
+			case OverflowPolicy::DROP_NEWEST:
+				break;
+
+			case OverflowPolicy::DROP_OLDEST: {
+				/* Samples of this batch which would be overwritten right away are dropped as well */
+				unsigned room = MIN(cnt, credits);
+				unsigned dropped = dropOldest(room - avail);
+
+				avail += dropped;
+				counters.dropped_oldest += dropped;
+				break;
+			}
+
+			case OverflowPolicy::BLOCK: {
+				auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(timeout);
+				unsigned room = MIN(cnt, credits);
+
+				counters.blocked++;
+
+				/* The writer thread of a pipelined destination drains the queue for us */
+				if (pipelined) {
+					std::unique_lock<std::mutex> lock(credits_mutex);
 
-		/* Increase reference counter of these samples as they are now also owned by the queue. */
-		sample_incref_many(clones, cloned);
+					if (!credits_cv.wait_until(lock, deadline, [&] { return credits - used >= room; }))
+						counters.timeouts++;
+				}
+				else {
+					while (credits - used < room) {
+						if (std::chrono::steady_clock::now() >= deadline) {
+							counters.timeouts++;
+							break;
+						}
 
-		p->logger->debug("Enqueued {} samples to destination {} of path {}", enqueued, pd->node->getName(), p->toString());
+						write();
+					}
+				}
+
+				avail = credits - used;
+				break;
+			}
+
+			case OverflowPolicy::COALESCE:
+				break;
+		}
 	}
 
-	sample_decref_many(clones, cloned);
+	accepted = MIN(cnt, avail);
+	skipped = 0;
+
+	/* With ring semantics, the newest samples of the batch are kept */
+	if (policy == OverflowPolicy::DROP_OLDEST) {
+		skipped = cnt - accepted;
+		counters.dropped_oldest += skipped;
+
+		smps += skipped;
+	}
+
+	/* Increase reference counter of these samples as they are now also owned by the queue.
+	 * This must happen before a writer thread can pick them up.
+	 */
+	sample_incref_many(smps, accepted);
+
+	/* The writer thread returns the credits as soon as it has pulled the samples.
+	 * Hence, they are taken before the samples become visible in the queue. */
+	used += accepted;
+
+	enqueued = pipelined
+		? queue_signalled_push_many(&queue, (void **) smps, accepted)
+		: queue_push_many(&queue.queue, (void **) smps, accepted);
+	if ((int) enqueued < 0)
+		enqueued = 0;
+
+	if (enqueued < accepted) {
+		sample_decref_many(smps + enqueued, accepted - enqueued);
+
+		used -= accepted - enqueued;
+	}
+	counters.enqueued += enqueued;
+
+	if (policy == OverflowPolicy::COALESCE && cnt > enqueued) {
+		sample_incref(smps[cnt - 1]);
+
+		struct Sample *prev = pending.exchange(smps[cnt - 1]);
+		if (prev) {
+			sample_decref(prev);
+			counters.coalesced++;
+		}
+
+		counters.coalesced += cnt - enqueued - 1;
+
+		/* Wake up the writer thread which sends the pending sample */
+		if (pipelined)
+			queue_signalled_push_many(&queue, nullptr, 0);
+	}
+	else
+		counters.dropped_newest += cnt - skipped - enqueued;
+
+	if (enqueued < cnt)
+		VILLAS_LOG_DEBUG(path->logger, "Overflow of destination {}: policy={}, enqueued={}, expected={}", node->getName(), overflowPolicyToString(policy), enqueued, cnt);
+
+	VILLAS_LOG_DEBUG(path->logger, "Enqueued {} samples to destination {} of path {}", enqueued, node->getName(), path->toString());
 }
 
-void PathDestination::write()
+void PathDestination::flushPending()
+{
+	/* The writer thread of a pipelined destination sends the pending sample itself */
+	if (pipelined || !pending || used >= credits)
+		return;
+
+	if (queue_push(&queue.queue, pending) != 1)
+		return;
+
+	/* The reference of the pending sample is now owned by the queue */
+	pending = nullptr;
+
+	used++;
+	counters.enqueued++;
+}
+
+unsigned PathDestination::dropOldest(unsigned cnt)
+{
+	if (cnt == 0)
+		return 0;
+
+	struct Sample *smps[cnt];
+
+	int pulled = queue_pull_many(&queue.queue, (void **) smps, cnt);
+	if (pulled <= 0)
+		return 0;
+
+	sample_decref_many(smps, pulled);
+
+	used -= pulled;
+
+	return pulled;
+}
+
+int PathDestination::writeSamples(struct Sample *smps[], unsigned cnt)
 {
-	int cnt = node->out.vectorize;
 	int sent;
+
+	VILLAS_TRACE(path_destination_write_start, path->uuid_string, node->getName().c_str(), cnt);
+
+	sent = node->write(smps, cnt);
+
+	VILLAS_TRACE(path_destination_write_done, path->uuid_string, node->getName().c_str(), cnt, sent);
+
+	if (sent < 0)
+		path->logger->error("Failed to sent {} samples to node {}: reason={}", cnt, node->getName(), sent);
+	else if ((unsigned) sent < cnt)
+		VILLAS_LOG_DEBUG(path->logger, "Partial write to node {}: written={}, expected={}", node->getName(), sent, cnt);
+
+	int released = sample_decref_many(smps, cnt);
+
+	VILLAS_LOG_DEBUG(path->logger, "Released {} samples back to memory pool", released);
+
+	return sent;
+}
+
+int PathDestination::writeBatch(struct Sample *smps[], unsigned requested, unsigned cnt)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	int sent = writeSamples(smps, cnt);
+
+	if (node->out.adaptive.enabled) {
+		std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+
+		node->out.adapt(requested, cnt, duration.count());
+	}
+
+	return sent;
+}
+
+void PathDestination::write()
+{
+	int cnt;
 	int allocated;
 
-	struct Sample *smps[cnt];
+	struct Sample *smps[node->out.vectorize];
 
 	/* As long as there are still samples in the queue */
 	while (true) {
-		allocated = queue_pull_many(&queue, (void **) smps, cnt);
+		flushPending();
+
+		cnt = node->out.getBatchSize();
+
+		allocated = queue_pull_many(&queue.queue, (void **) smps, cnt);
 		if (allocated == 0)
 			break;
 		else if (allocated < cnt)
-			path->logger->debug("Queue underrun for path {}: allocated={} expected={}", path->toString(), allocated, cnt);
+			VILLAS_LOG_DEBUG(path->logger, "Queue underrun for path {}: allocated={} expected={}", path->toString(), allocated, cnt);
+
+		VILLAS_LOG_DEBUG(path->logger, "Dequeued {} samples from queue of node {} which is part of path {}", allocated, node->getName(), path->toString());
+
+		int sent = writeBatch(smps, cnt, allocated);
 
-		path->logger->debug("Dequeued {} samples from queue of node {} which is part of path {}", allocated, node->getName(), path->toString());
+		used -= allocated;
 
-		sent = node->write(smps, allocated);
-		if (sent < 0) {
-			path->logger->error("Failed to sent {} samples to node {}: reason={}", cnt, node->getName(), sent);
+		if (sent < 0)
 			return;
+	}
+}
+
+void PathDestination::returnCredits(unsigned cnt)
+{
+	used -= cnt;
+
+	/* Taking the lock ensures that a path which has just found too few credits is already waiting */
+	if (policy == OverflowPolicy::BLOCK) {
+		{
+			std::lock_guard<std::mutex> guard(credits_mutex);
 		}
-		else if (sent < allocated)
-			path->logger->debug("Partial write to node {}: written={}, expected={}", node->getName(), sent, allocated);
 
-		int released = sample_decref_many(smps, allocated);
+		credits_cv.notify_one();
+	}
+}
+
+void * PathDestination::runWriterWrapper(void *arg)
+{
+	auto *pd = (PathDestination *) arg;
+
+	return pd->runWriter();
+}
+
+void * PathDestination::runWriter()
+{
+	int cnt;
+	int allocated;
+
+	struct Sample *smps[node->out.vectorize];
 
-		path->logger->debug("Released {} samples back to memory pool", released);
+	int fd = queue_signalled_fd(&queue);
+
+	while (true) {
+		/* The flag must be read before the queue so that no sample is left behind */
+		bool stop = writer_stop;
+
+		cnt = node->out.getBatchSize();
+
+		allocated = queue_pull_many(&queue.queue, (void **) smps, cnt);
+		if (allocated < 0)
+			break;
+
+		auto since = PathStage::clock::now();
+
+		if (allocated > 0) {
+			writeBatch(smps, cnt, allocated);
+
+			returnCredits(allocated);
+		}
+		/* Send the pending coalesced sample after all older ones */
+		else if (pending) {
+			struct Sample *smp = pending.exchange(nullptr);
+			if (smp) {
+				writeSamples(&smp, 1);
+
+				counters.enqueued++;
+				allocated = 1;
+			}
+		}
+		/* All samples have been written */
+		else if (stop)
+			break;
+		/* Wait until the queue is signalled */
+		else {
+			uint64_t cntr;
+
+			if (fd >= 0) {
+				if (::read(fd, &cntr, sizeof(cntr)) < 0 && errno != EINTR)
+					break;
+			}
+			else
+				sched_yield();
+
+			continue;
+		}
+
+		stage.account(since, allocated);
 	}
+
+	return nullptr;
+}
+
+void PathDestination::start()
+{
+	int ret;
+
+	if (!pipelined)
+		return;
+
+	stage.start();
+
+	writer_stop = false;
+
+	ret = pthread_create(&tid, nullptr, runWriterWrapper, this);
+	if (ret)
+		throw RuntimeError("Failed to create writer thread for destination {}", node->getName());
+
+	if (path->affinity)
+		kernel::rt::setThreadAffinity(tid, path->affinity);
 }
 
 void PathDestination::check()
@@ -105,3 +490,66 @@ void PathDestination::check()
 	if (!(node->getFactory()->getFlags() & (int) NodeFactory::Flags::SUPPORTS_WRITE))
 		throw RuntimeError("Destination node {} is not supported as a sink for path ", node->getName());
 }
+
+void PathDestination::stop()
+{
+	int ret;
+
+	/* The path has stopped enqueuing samples. The writer thread
+	 * writes the remaining ones in order before it exits. */
+	if (pipelined) {
+		writer_stop = true;
+
+		/* Wake up the writer thread if it is waiting for samples */
+		ret = queue_signalled_push_many(&queue, nullptr, 0);
+		if (ret < 0)
+			throw RuntimeError("Failed to wake up writer thread of destination {}", node->getName());
+
+		ret = pthread_join(tid, nullptr);
+		if (ret)
+			throw RuntimeError("Failed to join writer thread of destination {}", node->getName());
+
+		/* Release samples which have been left behind by a failing writer thread */
+		struct Sample *smps[16];
+		int pulled;
+		while ((pulled = queue_pull_many(&queue.queue, (void **) smps, ARRAY_LEN(smps))) > 0) {
+			sample_decref_many(smps, pulled);
+
+			used -= pulled;
+		}
+	}
+
+	struct Sample *smp = pending.exchange(nullptr);
+	if (smp)
+		sample_decref(smp);
+
+	uint64_t overflows = counters.dropped_newest + counters.dropped_oldest + counters.timeouts + counters.coalesced;
+	if (overflows > 0)
+		path->logger->warn("Destination {} overflowed: policy={}, enqueued={}, dropped_newest={}, dropped_oldest={}, blocked={}, timeouts={}, coalesced={}",
+			node->getName(), overflowPolicyToString(policy),
+			counters.enqueued.load(), counters.dropped_newest.load(), counters.dropped_oldest.load(),
+			counters.blocked.load(), counters.timeouts.load(), counters.coalesced.load());
+}
+
+json_t * PathDestination::toJson() const
+{
+	json_t *json_pd = json_pack("{ s: s, s: s, s: i, s: i, s: f, s: { s: I, s: I, s: I, s: I, s: I, s: I } }",
+		"node", node->getNameShort().c_str(),
+		"policy", overflowPolicyToString(policy),
+		"credits", credits,
+		"used", used.load(),
+		"timeout", timeout,
+		"stats",
+			"enqueued", (json_int_t) counters.enqueued,
+			"dropped_newest", (json_int_t) counters.dropped_newest,
+			"dropped_oldest", (json_int_t) counters.dropped_oldest,
+			"blocked", (json_int_t) counters.blocked,
+			"timeouts", (json_int_t) counters.timeouts,
+			"coalesced", (json_int_t) counters.coalesced
+	);
+
+	if (pipelined)
+		json_object_set_new(json_pd, "stage", stage.toJson());
+
+	return json_pd;
+}
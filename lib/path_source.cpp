@@ -8,6 +8,8 @@
 #include <fmt/format.h>
 
 #include <villas/utils.hpp>
+#include <villas/node/log.hpp>
+#include <villas/node/trace.hpp>
 #include <villas/sample.hpp>
 #include <villas/node.hpp>
 #include <villas/path.hpp>
@@ -29,8 +31,21 @@ PathSource::PathSource(Path *p, Node *n) :
 {
 	int ret;
 
-	int pool_size = MAX(DEFAULT_QUEUE_LENGTH, 20 * node->in.vectorize);
-	ret = pool_init(&pool, pool_size, SAMPLE_LENGTH(node->getInputSignalsMaxCount()), node->getMemoryType());
+	/* The pool may grow to four times its initial size, unless configured otherwise by 'in.pool' */
+	size_t pool_size = MAX(DEFAULT_QUEUE_LENGTH, 20 * node->in.vectorize);
+	size_t pool_max = 0;
+
+	json_t *json_pool = node->in.config
+		? json_object_get(node->in.config, "pool")
+		: nullptr;
+
+	if (json_pool)
+		pool_parse(json_pool, &pool_size, &pool_max);
+
+	if (!pool_max)
+		pool_max = 4 * pool_size;
+
+	ret = pool_init_elastic(&pool, pool_size, pool_max, SAMPLE_LENGTH(node->getInputSignalsMaxCount()), node->getMemoryType());
 	if (ret)
 		throw RuntimeError("Failed to initialize pool");
 }
@@ -45,8 +60,12 @@ PathSource::~PathSource()
 int PathSource::read(int i)
 {
 	int ret, recv, tomux, allocated, cnt, toenqueue, enqueued = 0;
+	bool forward = false;
+	PathStage::clock::time_point since;
 
-	cnt = node->in.vectorize;
+	cnt = node->in.getBatchSize();
+
+	VILLAS_TRACE(path_source_read_start, path->uuid_string, node->getName().c_str());
 
 	struct Sample *read_smps[cnt];
 	struct Sample *muxed_smps[cnt];
@@ -79,6 +98,8 @@ int PathSource::read(int i)
 	else if (recv < allocated)
 		path->logger->warn("Partial read for path {}: read={}, expected={}", path->toString(), recv, allocated);
 
+	since = PathStage::clock::now();
+
 	/* Let the master path sources forward received samples to their secondaries */
 	writeToSecondaries(read_smps, recv);
 
@@ -124,20 +145,27 @@ int PathSource::read(int i)
 
 		if (muxed_smps[i]->length > 0)
 			muxed_smps[i]->flags |= (int) SampleFlags::HAS_DATA;
+
+		VILLAS_TRACE(path_mux_sample, path->uuid_string, node->getName().c_str(), tomux_smps[i], muxed_smps[i], muxed_smps[i]->sequence);
 	}
 
 	sample_copy(path->last_sample, muxed_smps[tomux-1]);
 
 #ifdef WITH_HOOKS
-	toenqueue = path->hooks.process(muxed_smps, tomux);
-	if (toenqueue == -1) {
-		path->logger->error("An error occured during hook processing. Skipping sample");
+	/* The hooks of a pipelined path run on the hook thread */
+	if (path->pipelined)
+		toenqueue = tomux;
+	else {
+		toenqueue = path->hooks.process(muxed_smps, tomux);
+		if (toenqueue == -1) {
+			path->logger->error("An error occured during hook processing. Skipping sample");
 
-	}
-	else if (toenqueue != tomux) {
-		int skipped = tomux - toenqueue;
+		}
+		else if (toenqueue != tomux) {
+			int skipped = tomux - toenqueue;
 
-		path->logger->debug("Hooks skipped {} out of {} samples for path {}", skipped, tomux, path->toString());
+			VILLAS_LOG_DEBUG(path->logger, "Hooks skipped {} out of {} samples for path {}", skipped, tomux, path->toString());
+		}
 	}
 #else
 	toenqueue = tomux;
@@ -145,22 +173,21 @@ int PathSource::read(int i)
 
 	path->received.set(i);
 
-	path->logger->debug("received=0b{:b}, mask=0b{:b}", path->received.to_ullong(), path->mask.to_ullong());
+	VILLAS_LOG_DEBUG(path->logger, "received=0b{:b}, mask=0b{:b}", path->received.to_ullong(), path->mask.to_ullong());
 
 	if (path->mask.test(i)) {
 		/* Enqueue always */
 		if (path->mode == Path::Mode::ANY) {
 			enqueued = toenqueue;
-			PathDestination::enqueueAll(path, muxed_smps, toenqueue);
+			forward = true;
 		}
 		/* Enqueue only if received == mask bitset */
 		else if (path->mode == Path::Mode::ALL) {
 			if (path->mask == path->received) {
-				PathDestination::enqueueAll(path, muxed_smps, toenqueue);
-
 				path->received.reset();
 
 				enqueued = toenqueue;
+				forward = true;
 			}
 			else
 				enqueued = 0;
@@ -169,9 +196,23 @@ int PathSource::read(int i)
 	else
 		enqueued = 0;
 
+	/* Samples which are not forwarded still pass the hooks of a pipelined path */
+	if (path->pipelined) {
+		int flags = (int) Path::PipelineFlags::PROCESS;
+		if (forward)
+			flags |= (int) Path::PipelineFlags::FORWARD;
+
+		path->pipelinePush(muxed_smps, tomux, flags);
+		path->mux_stage.account(since, tomux);
+	}
+	else if (forward)
+		PathDestination::enqueueAll(path, muxed_smps, toenqueue);
+
 	sample_decref_many(muxed_smps, tomux);
 out2:	sample_decref_many(read_smps, recv);
 
+	VILLAS_TRACE(path_source_read_done, path->uuid_string, node->getName().c_str(), enqueued);
+
 	return enqueued;
 }
 
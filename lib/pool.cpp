@@ -5,6 +5,16 @@
  * @license Apache 2.0
  *********************************************************************************/
 
+#include <chrono>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <sched.h>
+#include <time.h>
+
+#include <villas/clock.hpp>
 #include <villas/utils.hpp>
 #include <villas/exceptions.hpp>
 #include <villas/pool.hpp>
@@ -13,26 +23,119 @@
 #include <villas/log.hpp>
 
 using namespace villas;
+using namespace villas::node;
+
+/** Elastic pools which are resized by the housekeeping thread. */
+struct PoolRegistry {
+	std::mutex mutex;
+	std::list<struct Pool *> pools;
+	bool running = false;
+};
+
+static
+struct PoolRegistry * pool_registry()
+{
+	/* Never destroyed as the housekeeping thread might still be running during exit */
+	static auto *r = new PoolRegistry();
+
+	return r;
+}
+
+static
+void pool_housekeeping()
+{
+	auto *r = pool_registry();
+
+	while (true) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(POOL_MAINTAIN_INTERVAL));
+
+		std::lock_guard<std::mutex> guard(r->mutex);
+
+		for (auto *p : r->pools)
+			pool_maintain(p);
+	}
+}
+
+static
+void pool_register(struct Pool *p)
+{
+	auto *r = pool_registry();
+
+	std::lock_guard<std::mutex> guard(r->mutex);
+
+	r->pools.push_back(p);
+
+	if (!r->running) {
+		std::thread(pool_housekeeping).detach();
+		r->running = true;
+	}
+}
+
+static
+void pool_unregister(struct Pool *p)
+{
+	auto *r = pool_registry();
+
+	std::lock_guard<std::mutex> guard(r->mutex);
+
+	r->pools.remove(p);
+}
 
 int villas::node::pool_init(struct Pool *p, size_t cnt, size_t blocksz, struct memory::Type *m)
+{
+	return pool_init_elastic(p, cnt, cnt, blocksz, m);
+}
+
+int villas::node::pool_init_elastic(struct Pool *p, size_t cnt, size_t max, size_t blocksz, struct memory::Type *m)
 {
 	int ret;
 
+	auto logger = logging.get("pool");
+
 	/* Make sure that we use a block size that is aligned to the size of a cache line */
 	p->alignment = kernel::getCachelineSize();
 	p->blocksz = p->alignment * CEIL(blocksz, p->alignment);
 	p->len = cnt * p->blocksz;
 
+	/* Additional chunks must be allocated independently of the initial memory area */
+	if (max > cnt && !(m->flags & ((int) memory::Flags::HEAP | (int) memory::Flags::MMAP))) {
+		logger->debug("Memory type {} does not support elastic pools. Using a static pool of {} blocks", m->name, cnt);
+		max = cnt;
+	}
+
+	p->mem = m;
+	p->blocks = cnt;
+
+	if (max > cnt) {
+		p->chunk_blocks = MAX(cnt, CEIL(max - cnt, POOL_MAX_CHUNKS));
+		p->max_chunks = CEIL(max - cnt, p->chunk_blocks);
+	}
+	else {
+		p->chunk_blocks = 0;
+		p->max_chunks = 0;
+	}
+
+	p->chunks = 0;
+	p->resizing = false;
+	p->starved = false;
+	p->low_since = 0;
+
+	p->used = 0;
+	p->high_water = 0;
+	p->underruns = 0;
+	p->grows = 0;
+	p->shrinks = 0;
+
 	void *buffer = memory::alloc_aligned(p->len, p->alignment, m);
 	if (!buffer)
 		throw MemoryAllocationError();
 
-	auto logger = logging.get("pool");
 	logger->debug("Allocated {:#x} bytes for memory pool", p->len);
 
 	p->buffer_off = (char*) buffer - (char*) p;
 
-	ret = queue_init(&p->queue, LOG2_CEIL(cnt), m);
+	/* The queue must be able to hold the free blocks of all chunks */
+	ret = queue_init(&p->queue, LOG2_CEIL(cnt + p->max_chunks * p->chunk_blocks), m);
 	if (ret)
 		return ret;
 
@@ -41,6 +144,9 @@ int villas::node::pool_init(struct Pool *p, size_t cnt, size_t blocksz, struct m
 
 	p->state = State::INITIALIZED;
 
+	if (p->max_chunks > 0)
+		pool_register(p);
+
 	return 0;
 }
 
@@ -51,10 +157,22 @@ int villas::node::pool_destroy(struct Pool *p)
 	if (p->state == State::DESTROYED)
 		return 0;
 
+	/* Wait until the housekeeping thread is done with this pool */
+	if (p->max_chunks > 0)
+		pool_unregister(p);
+
 	ret = queue_destroy(&p->queue);
 	if (ret)
 		return ret;
 
+	for (size_t i = 0; i < p->chunks; i++) {
+		ret = memory::free((char *) p + p->chunk_off[i]);
+		if (ret)
+			return ret;
+	}
+
+	p->chunks = 0;
+
 	void *buffer = (char *) p + p->buffer_off;
 	ret = memory::free(buffer);
 	if (ret == 0)
@@ -63,23 +181,305 @@ int villas::node::pool_destroy(struct Pool *p)
 	return ret;
 }
 
+/** Pull up to \p cnt free blocks from the queue.
+ *
+ * Batched pulls stop early at cells which are still in use by concurrent
+ * threads. Hence we continue until the queue is empty.
+ */
+static
+ssize_t pool_pull(struct Pool *p, void *blocks[], size_t cnt)
+{
+	ssize_t got = 0;
+
+	while ((size_t) got < cnt) {
+		int ret = queue_pull_many(&p->queue, blocks + got, cnt - got);
+		if (ret < 0)
+			return got > 0 ? got : ret;
+		else if (ret == 0)
+			break;
+
+		got += ret;
+	}
+
+	return got;
+}
+
+/** Push \p cnt free blocks to the queue.
+ *
+ * The queue can hold all blocks of the pool. So it only appears to be full
+ * while a concurrent thread is still pulling from the cells in front of us.
+ * Hence we retry until all blocks have been returned as dropping them would leak memory.
+ */
+static
+ssize_t pool_push(struct Pool *p, void *blocks[], size_t cnt)
+{
+	size_t put = 0;
+
+	while (put < cnt) {
+		int ret = queue_push_many(&p->queue, blocks + put, cnt - put);
+		if (ret < 0) {
+			auto logger = logging.get("pool");
+			logger->error("Failed to return {} blocks to a closed pool", cnt - put);
+
+			return put > 0 ? (ssize_t) put : ret;
+		}
+		else if (ret == 0)
+			sched_yield();
+
+		put += ret;
+	}
+
+	return put;
+}
+
+/** Add a new chunk of free blocks to the pool.
+ *
+ * @retval 0 A chunk has been added.
+ * @retval 1 Another thread is currently resizing the pool.
+ * @retval <0 The pool has reached its maximum size or the allocation failed.
+ */
+static
+int pool_grow(struct Pool *p)
+{
+	if (p->chunks.load(std::memory_order_relaxed) >= p->max_chunks)
+		return -1;
+
+	if (p->resizing.exchange(true, std::memory_order_acquire))
+		return 1;
+
+	size_t n = p->chunks.load(std::memory_order_relaxed);
+	if (n >= p->max_chunks) {
+		p->resizing.store(false, std::memory_order_release);
+		return -1;
+	}
+
+	char *chunk = (char *) memory::alloc_aligned(p->chunk_blocks * p->blocksz, p->alignment, p->mem);
+	if (!chunk) {
+		p->resizing.store(false, std::memory_order_release);
+		return -1;
+	}
+
+	p->chunk_off[n] = chunk - (char *) p;
+
+	std::vector<void *> blocks(p->chunk_blocks);
+	for (size_t i = 0; i < p->chunk_blocks; i++)
+		blocks[i] = chunk + i * p->blocksz;
+
+	pool_push(p, blocks.data(), blocks.size());
+
+	p->chunks.store(n + 1, std::memory_order_relaxed);
+	p->grows++;
+
+	p->resizing.store(false, std::memory_order_release);
+
+	auto logger = logging.get("pool");
+	logger->info("Pool grew to {} of max. {} blocks", pool_capacity(p), p->blocks + p->max_chunks * p->chunk_blocks);
+
+	return 0;
+}
+
+/** Release the most recently added chunk if none of its blocks is in use.
+ *
+ * Free blocks of the chunk are collected while all others are returned right away,
+ * so that the pool does not run empty for concurrent threads in the meantime.
+ */
+static
+void pool_shrink(struct Pool *p)
+{
+	if (p->resizing.exchange(true, std::memory_order_acquire))
+		return;
+
+	size_t n = p->chunks.load(std::memory_order_relaxed);
+	if (n == 0) {
+		p->resizing.store(false, std::memory_order_release);
+		return;
+	}
+
+	char *chunk = (char *) p + p->chunk_off[n - 1];
+	char *chunk_end = chunk + p->chunk_blocks * p->blocksz;
+
+	std::vector<void *> collected;
+	collected.reserve(p->chunk_blocks);
+
+	/* The queue is FIFO, so every block which is currently free is visited at most once */
+	size_t used = p->used.load(std::memory_order_relaxed);
+	size_t remaining = pool_capacity(p) - MIN(used, pool_capacity(p));
+
+	void *blocks[64];
+	while (remaining > 0 && collected.size() < p->chunk_blocks) {
+		ssize_t pulled = pool_pull(p, blocks, MIN(remaining, ARRAY_LEN(blocks)));
+		if (pulled <= 0)
+			break;
+
+		remaining -= MIN(remaining, (size_t) pulled);
+
+		size_t keep = 0;
+		for (ssize_t i = 0; i < pulled; i++) {
+			if ((char *) blocks[i] >= chunk && (char *) blocks[i] < chunk_end)
+				collected.push_back(blocks[i]);
+			else
+				blocks[keep++] = blocks[i];
+		}
+
+		pool_push(p, blocks, keep);
+	}
+
+	bool release = collected.size() == p->chunk_blocks;
+	if (release) {
+		p->chunks.store(n - 1, std::memory_order_relaxed);
+		p->shrinks++;
+
+		memory::free(chunk);
+	}
+	else
+		pool_push(p, collected.data(), collected.size());
+
+	p->resizing.store(false, std::memory_order_release);
+
+	if (release) {
+		auto logger = logging.get("pool");
+		logger->info("Pool shrunk to {} blocks", pool_capacity(p));
+	}
+}
+
+/** Update the usage statistics. */
+static
+void pool_account(struct Pool *p, size_t cnt)
+{
+	size_t used = p->used.fetch_add(cnt, std::memory_order_relaxed) + cnt;
+	size_t hw = p->high_water.load(std::memory_order_relaxed);
+
+	while (used > hw && !p->high_water.compare_exchange_weak(hw, used, std::memory_order_relaxed));
+}
+
+void villas::node::pool_maintain(struct Pool *p)
+{
+	if (p->max_chunks == 0)
+		return;
+
+	bool starved = p->starved.exchange(false, std::memory_order_relaxed);
+
+	/* Grow before the pool runs empty */
+	for (;;) {
+		size_t used = p->used.load(std::memory_order_relaxed);
+		size_t capacity = pool_capacity(p);
+
+		if (!starved && used <= capacity - capacity / 4)
+			break;
+
+		if (pool_grow(p))
+			break;
+
+		starved = false;
+		p->low_since.store(0, std::memory_order_relaxed);
+	}
+
+	size_t n = p->chunks.load(std::memory_order_relaxed);
+	if (n == 0)
+		return;
+
+	/* Usage is low, if the pool would still be at most half full without its last chunk */
+	if (p->used.load(std::memory_order_relaxed) > (p->blocks + (n - 1) * p->chunk_blocks) / 2) {
+		p->low_since.store(0, std::memory_order_relaxed);
+		return;
+	}
+
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	uint64_t now = time_to_ns(&ts);
+	uint64_t since = p->low_since.load(std::memory_order_relaxed);
+
+	if (since == 0)
+		p->low_since.store(now, std::memory_order_relaxed);
+	else if (now - since > POOL_SHRINK_DELAY * 1000000000ULL) {
+		p->low_since.store(0, std::memory_order_relaxed);
+		pool_shrink(p);
+	}
+}
+
 ssize_t villas::node::pool_get_many(struct Pool *p, void *blocks[], size_t cnt)
 {
-	return queue_pull_many(&p->queue, blocks, cnt);
+	ssize_t got = pool_pull(p, blocks, cnt);
+
+	/* Elastic pools are grown by the housekeeping thread */
+	if (got >= 0 && (size_t) got < cnt) {
+		p->underruns.fetch_add(1, std::memory_order_relaxed);
+		p->starved.store(true, std::memory_order_relaxed);
+	}
+
+	if (got > 0)
+		pool_account(p, got);
+
+	return got;
 }
 
 ssize_t villas::node::pool_put_many(struct Pool *p, void *blocks[], size_t cnt)
 {
-	return queue_push_many(&p->queue, blocks, cnt);
+	ssize_t put = pool_push(p, blocks, cnt);
+	if (put > 0)
+		p->used.fetch_sub(put, std::memory_order_relaxed);
+
+	return put;
 }
 
 void * villas::node::pool_get(struct Pool *p)
 {
 	void *ptr;
-	return queue_pull(&p->queue, &ptr) == 1 ? ptr : nullptr;
+	return pool_get_many(p, &ptr, 1) == 1 ? ptr : nullptr;
 }
 
 int villas::node::pool_put(struct Pool *p, void *buf)
 {
-	return queue_push(&p->queue, buf);
+	return pool_put_many(p, &buf, 1);
+}
+
+size_t villas::node::pool_capacity(const struct Pool *p)
+{
+	return p->blocks + p->chunks.load(std::memory_order_relaxed) * p->chunk_blocks;
+}
+
+void villas::node::pool_parse(json_t *json, size_t *cnt, size_t *max)
+{
+	int ret;
+	json_error_t err;
+	json_int_t size = -1, limit = -1;
+
+	if (json_is_integer(json))
+		size = json_integer_value(json);
+	else {
+		ret = json_unpack_ex(json, &err, 0, "{ s?: I, s?: I }",
+			"size", &size,
+			"max", &limit
+		);
+		if (ret)
+			throw ConfigError(json, err, "node-config-pool", "Failed to parse pool settings");
+	}
+
+	if (size == 0 || size < -1)
+		throw ConfigError(json, "node-config-pool", "Setting 'size' must be a positive number");
+
+	if (limit == 0 || limit < -1)
+		throw ConfigError(json, "node-config-pool", "Setting 'max' must be a positive number");
+
+	if (size > 0)
+		*cnt = size;
+
+	if (limit > 0)
+		*max = limit;
+}
+
+json_t * villas::node::pool_to_json(const struct Pool *p)
+{
+	return json_pack("{ s: I, s: I, s: I, s: I, s: I, s: I, s: I, s: I, s: I }",
+		"size", (json_int_t) p->blocks,
+		"capacity", (json_int_t) pool_capacity(p),
+		"max", (json_int_t) (p->blocks + p->max_chunks * p->chunk_blocks),
+		"blocksz", (json_int_t) p->blocksz,
+		"used", (json_int_t) p->used.load(std::memory_order_relaxed),
+		"high_water", (json_int_t) p->high_water.load(std::memory_order_relaxed),
+		"underruns", (json_int_t) p->underruns.load(std::memory_order_relaxed),
+		"grows", (json_int_t) p->grows.load(),
+		"shrinks", (json_int_t) p->shrinks.load()
+	);
 }
@@ -0,0 +1,173 @@
+/** High-precision periodic task with hybrid sleep/spin waiting
+ *
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+#include <cerrno>
+#include <unistd.h>
+#include <sys/timerfd.h>
+
+#include <villas/precision_task.hpp>
+#include <villas/clock.hpp>
+#include <villas/exceptions.hpp>
+#include <villas/timing.hpp>
+
+using namespace villas;
+using namespace villas::node;
+
+PrecisionTask::PrecisionTask(int c) :
+	clock(c),
+	slack(0),
+	period({ 0, 0 }),
+	next({ 0, 0 }),
+	overruns(0),
+	jitter(PRECISION_TASK_JITTER_BUCKETS, PRECISION_TASK_JITTER_WARMUP)
+{
+	fd = timerfd_create(clock, 0);
+	if (fd < 0)
+		throw SystemError("Failed to create timerfd");
+}
+
+PrecisionTask::~PrecisionTask()
+{
+	close(fd);
+}
+
+void PrecisionTask::parse(json_t *json)
+{
+	int ret;
+	json_error_t err;
+
+	ret = json_unpack_ex(json, &err, 0, "{ s?: F }",
+		"slack", &slack
+	);
+	if (ret)
+		throw ConfigError(json, err, "node-config-timer");
+
+	if (slack < 0)
+		throw ConfigError(json, "node-config-timer-slack", "Setting 'slack' must not be negative");
+}
+
+struct timespec PrecisionTask::now() const
+{
+	struct timespec ts;
+
+	clock_gettime(clock, &ts);
+
+	return ts;
+}
+
+void PrecisionTask::arm()
+{
+	int ret;
+	int64_t s = slack * 1e9;
+	int64_t p = time_to_ns(&period);
+
+	/* A slack of more than one period would only move the wakeup into a past period */
+	if (p > 0 && s > p)
+		s = p;
+
+	int64_t wakeup = time_to_ns(&next) - s;
+
+	struct itimerspec its = {
+		.it_interval = period,
+		/* A zero value would disarm the timer */
+		.it_value = time_from_ns(wakeup > 0 ? wakeup : 1)
+	};
+
+	ret = timerfd_settime(fd, TFD_TIMER_ABSTIME, &its, nullptr);
+	if (ret)
+		throw SystemError("Failed to arm timerfd");
+}
+
+void PrecisionTask::setRate(double rate)
+{
+	period = time_from_double(1.0 / rate);
+
+	struct timespec start = now();
+	next = time_add(&start, &period);
+
+	arm();
+}
+
+void PrecisionTask::setNext(const struct timespec *n)
+{
+	next = *n;
+
+	arm();
+}
+
+void PrecisionTask::setTimeout(double to)
+{
+	struct timespec timeout = time_from_double(to);
+	struct timespec start = now();
+
+	period = { 0, 0 };
+	next = time_add(&start, &timeout);
+
+	arm();
+}
+
+void PrecisionTask::stop()
+{
+	int ret;
+	struct itimerspec its = {
+		.it_interval = { 0, 0 },
+		.it_value = { 0, 0 }
+	};
+
+	ret = timerfd_settime(fd, 0, &its, nullptr);
+	if (ret)
+		throw SystemError("Failed to disarm timerfd");
+}
+
+uint64_t PrecisionTask::wait()
+{
+	ssize_t ret;
+	uint64_t steps, expirations;
+	struct timespec ts;
+
+	/* Sleep until shortly before the deadline */
+	ret = read(fd, &expirations, sizeof(expirations));
+	if (ret < 0) {
+		if (errno == EINTR)
+			return 0;
+
+		throw SystemError("Failed to wait for timer");
+	}
+
+	/* Spin for the remaining time */
+	int64_t deadline = time_to_ns(&next);
+	int64_t late;
+	do {
+		ts = now();
+		late = time_to_ns(&ts) - deadline;
+	} while (late < 0);
+
+	jitter.put(late * 1e-9);
+
+	int64_t p = time_to_ns(&period);
+	if (p > 0) {
+		/* Stay on the grid of deadlines, even if we missed some periods */
+		steps = 1 + late / p;
+		next = time_from_ns(deadline + steps * p);
+	}
+	else
+		steps = 1;
+
+	overruns += steps - 1;
+
+	return steps;
+}
+
+void PrecisionTask::printStats(Logger logger) const
+{
+	logger->info("Timer: slack={}, overruns={}", slack, overruns);
+
+	if (jitter.getTotal() > 0) {
+		logger->info("Timer jitter:");
+		jitter.print(logger, false);
+	}
+}
@@ -37,9 +37,10 @@
 #include <villas/log.hpp>
 
 using namespace villas;
+using namespace villas::node;
 
 /** Initialize MPMC queue */
-int villas::node::queue_init(struct CQueue *q, size_t size, struct memory::Type *m)
+int villas::node::queue_init(struct CQueue *q, size_t size, struct memory::Type *m, int flags)
 {
 	/* Queue size must be 2 exponent */
 	if (!IS_POW2(size)) {
@@ -50,7 +51,10 @@ int villas::node::queue_init(struct CQueue *q, size_t size, struct memory::Type
 		logger->warn("A queue size was changed from {} to {}", old_size, size);
 	}
 
+	q->flags = flags;
 	q->buffer_mask = size - 1;
+	q->head_cache = 0;
+	q->tail_cache = 0;
 	struct CQueue_cell *buffer = (struct CQueue_cell *) memory::alloc(sizeof(struct CQueue_cell) * size, m);
 	if (!buffer)
 		return -2;
@@ -94,6 +98,65 @@ size_t villas::node::queue_available(struct CQueue *q)
 		std::atomic_load_explicit(&q->head, std::memory_order_relaxed);
 }
 
+/** Enqueue up to \p cnt pointers into a single-producer single-consumer queue.
+ *
+ * All cells are published to the consumer with a single release store.
+ */
+static
+int queue_spsc_push_many(struct CQueue *q, void *ptr[], size_t cnt)
+{
+	struct CQueue_cell *buffer;
+	size_t tail, avail;
+
+	buffer = (struct CQueue_cell *) ((char *) q + q->buffer_off);
+	tail = std::atomic_load_explicit(&q->tail, std::memory_order_relaxed);
+
+	/* Only reload the head pointer if the cached one indicates a full queue */
+	avail = q->buffer_mask + 1 - (tail - q->head_cache);
+	if (avail < cnt) {
+		q->head_cache = std::atomic_load_explicit(&q->head, std::memory_order_acquire);
+		avail = q->buffer_mask + 1 - (tail - q->head_cache);
+	}
+
+	if (cnt > avail)
+		cnt = avail;
+
+	for (size_t i = 0; i < cnt; i++)
+		buffer[(tail + i) & q->buffer_mask].data_off = (char *) ptr[i] - (char *) q;
+
+	std::atomic_store_explicit(&q->tail, tail + cnt, std::memory_order_release);
+
+	return cnt;
+}
+
+/** Dequeue up to \p cnt pointers from a single-producer single-consumer queue. */
+static
+int queue_spsc_pull_many(struct CQueue *q, void *ptr[], size_t cnt)
+{
+	struct CQueue_cell *buffer;
+	size_t head, avail;
+
+	buffer = (struct CQueue_cell *) ((char *) q + q->buffer_off);
+	head = std::atomic_load_explicit(&q->head, std::memory_order_relaxed);
+
+	/* Only reload the tail pointer if the cached one indicates an empty queue */
+	avail = q->tail_cache - head;
+	if (avail < cnt) {
+		q->tail_cache = std::atomic_load_explicit(&q->tail, std::memory_order_acquire);
+		avail = q->tail_cache - head;
+	}
+
+	if (cnt > avail)
+		cnt = avail;
+
+	for (size_t i = 0; i < cnt; i++)
+		ptr[i] = (char *) q + buffer[(head + i) & q->buffer_mask].data_off;
+
+	std::atomic_store_explicit(&q->head, head + cnt, std::memory_order_release);
+
+	return cnt;
+}
+
 int villas::node::queue_push(struct CQueue *q, void *ptr)
 {
 	struct CQueue_cell *cell, *buffer;
@@ -103,6 +166,9 @@ int villas::node::queue_push(struct CQueue *q, void *ptr)
 	if (std::atomic_load_explicit(&q->state, std::memory_order_relaxed) == State::STOPPED)
 		return -1;
 
+	if (q->flags & (int) QueueFlags::SPSC)
+		return queue_spsc_push_many(q, &ptr, 1);
+
 	buffer = (struct CQueue_cell *) ((char *) q + q->buffer_off);
 	pos = std::atomic_load_explicit(&q->tail, std::memory_order_relaxed);
 	while (true) {
@@ -135,6 +201,9 @@ int villas::node::queue_pull(struct CQueue *q, void **ptr)
 	if (std::atomic_load_explicit(&q->state, std::memory_order_relaxed) == State::STOPPED)
 		return -1;
 
+	if (q->flags & (int) QueueFlags::SPSC)
+		return queue_spsc_pull_many(q, ptr, 1);
+
 	buffer = (struct CQueue_cell *) ((char *) q + q->buffer_off);
 	pos = std::atomic_load_explicit(&q->head, std::memory_order_relaxed);
 	while (true) {
@@ -160,36 +229,102 @@ int villas::node::queue_pull(struct CQueue *q, void **ptr)
 
 int villas::node::queue_push_many(struct CQueue *q, void *ptr[], size_t cnt)
 {
-	int ret;
-	size_t i;
+	struct CQueue_cell *buffer;
+	size_t pos, seq, i;
+	intptr_t diff = 0;
 
-	for (ret = 0, i = 0; i < cnt; i++) {
-		ret = queue_push(q, ptr[i]);
-		if (ret <= 0)
-			break;
+	if (std::atomic_load_explicit(&q->state, std::memory_order_relaxed) == State::STOPPED)
+		return -1;
+
+	if (q->flags & (int) QueueFlags::SPSC)
+		return queue_spsc_push_many(q, ptr, cnt);
+
+	if (cnt == 0)
+		return 0;
+
+	buffer = (struct CQueue_cell *) ((char *) q + q->buffer_off);
+	pos = std::atomic_load_explicit(&q->tail, std::memory_order_relaxed);
+	while (true) {
+		/* Find the number of consecutive free cells starting at pos */
+		for (i = 0; i < cnt; i++) {
+			seq = std::atomic_load_explicit(&buffer[(pos + i) & q->buffer_mask].sequence, std::memory_order_acquire);
+			diff = (intptr_t) seq - (intptr_t) (pos + i);
+			if (diff != 0)
+				break;
+		}
+
+		if (i > 0) {
+			/* Reserve the whole range with a single CAS */
+			if (std::atomic_compare_exchange_weak_explicit(&q->tail, &pos, pos + i, std::memory_order_relaxed, std::memory_order_relaxed))
+				break;
+		}
+		else if (diff < 0)
+			return 0;
+		else
+			pos = std::atomic_load_explicit(&q->tail, std::memory_order_relaxed);
 	}
 
-	if (ret == -1 && i == 0)
-		return -1;
+	cnt = i;
 
-	return i;
+	/* Fill the reserved cells and hand them over to the consumers */
+	for (i = 0; i < cnt; i++) {
+		struct CQueue_cell *cell = &buffer[(pos + i) & q->buffer_mask];
+
+		cell->data_off = (char *) ptr[i] - (char *) q;
+		std::atomic_store_explicit(&cell->sequence, pos + i + 1, std::memory_order_release);
+	}
+
+	return cnt;
 }
 
 int villas::node::queue_pull_many(struct CQueue *q, void *ptr[], size_t cnt)
 {
-	int ret;
-	size_t i;
+	struct CQueue_cell *buffer;
+	size_t pos, seq, i;
+	intptr_t diff = 0;
+
+	if (std::atomic_load_explicit(&q->state, std::memory_order_relaxed) == State::STOPPED)
+		return -1;
+
+	if (q->flags & (int) QueueFlags::SPSC)
+		return queue_spsc_pull_many(q, ptr, cnt);
+
+	if (cnt == 0)
+		return 0;
 
-	for (ret = 0, i = 0; i < cnt; i++) {
-		ret = queue_pull(q, &ptr[i]);
-		if (ret <= 0)
-			break;
+	buffer = (struct CQueue_cell *) ((char *) q + q->buffer_off);
+	pos = std::atomic_load_explicit(&q->head, std::memory_order_relaxed);
+	while (true) {
+		/* Find the number of consecutive published cells starting at pos */
+		for (i = 0; i < cnt; i++) {
+			seq = std::atomic_load_explicit(&buffer[(pos + i) & q->buffer_mask].sequence, std::memory_order_acquire);
+			diff = (intptr_t) seq - (intptr_t) (pos + i + 1);
+			if (diff != 0)
+				break;
+		}
+
+		if (i > 0) {
+			/* Reserve the whole range with a single CAS */
+			if (std::atomic_compare_exchange_weak_explicit(&q->head, &pos, pos + i, std::memory_order_relaxed, std::memory_order_relaxed))
+				break;
+		}
+		else if (diff < 0)
+			return 0;
+		else
+			pos = std::atomic_load_explicit(&q->head, std::memory_order_relaxed);
 	}
 
-	if (ret == -1 && i == 0)
-		return -1;
+	cnt = i;
+
+	/* Drain the reserved cells and release them to the producers of the next lap */
+	for (i = 0; i < cnt; i++) {
+		struct CQueue_cell *cell = &buffer[(pos + i) & q->buffer_mask];
+
+		ptr[i] = (char *) q + cell->data_off;
+		std::atomic_store_explicit(&cell->sequence, pos + i + q->buffer_mask + 1, std::memory_order_release);
+	}
 
-	return i;
+	return cnt;
 }
 
 int villas::node::queue_close(struct CQueue *q)
@@ -46,7 +46,7 @@ int villas::node::queue_signalled_init(struct CQueueSignalled *qs, size_t size,
 #endif
 	}
 
-	ret = queue_init(&qs->queue, size, mem);
+	ret = queue_init(&qs->queue, size, mem, flags & (int) QueueFlags::SPSC);
 	if (ret < 0)
 		return ret;
 
@@ -315,7 +315,7 @@ void villas::node::sample_data_insert(struct Sample *smp, const union SignalData
 
 void villas::node::sample_data_remove(struct Sample *smp, size_t offset, size_t len)
 {
-	size_t sz = sizeof(smp->data[0]) * len;
+	size_t sz = sizeof(smp->data[0]) * (smp->length - offset - len);
 
 	memmove(&smp->data[offset], &smp->data[offset + len], sz);
 
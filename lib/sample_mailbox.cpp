@@ -0,0 +1,192 @@
+/** A latest-value mailbox for signals.
+ *
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+#include <cstring>
+
+#include <villas/exceptions.hpp>
+#include <villas/sample.hpp>
+#include <villas/sample_mailbox.hpp>
+#include <villas/utils.hpp>
+
+using namespace villas;
+using namespace villas::node;
+
+SampleMailbox::SampleMailbox(SignalList::Ptr sigs, unsigned capacity) :
+	signals(sigs),
+	data(MAX(capacity, sigs ? (unsigned) sigs->size() : 0U)),
+	versions(data.size(), 0),
+	ts(),
+	length(0),
+	sequence(0),
+	waiters(0)
+{
+	int ret;
+
+	ret = pthread_mutex_init(&mutex, nullptr);
+	if (ret)
+		throw RuntimeError("Failed to initialize mutex");
+
+	ret = pthread_cond_init(&cv, nullptr);
+	if (ret)
+		throw RuntimeError("Failed to initialize condition variable");
+
+	if (signals) {
+		for (unsigned i = 0; i < signals->size(); i++)
+			data[i] = signals->getByIndex(i)->init;
+
+		length = signals->size();
+	}
+}
+
+SampleMailbox::~SampleMailbox()
+{
+	pthread_cond_destroy(&cv);
+	pthread_mutex_destroy(&mutex);
+}
+
+uint64_t SampleMailbox::begin()
+{
+	uint64_t seq = sequence.load(std::memory_order_relaxed);
+
+	sequence.store(seq + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	return seq + 2;
+}
+
+void SampleMailbox::commit(uint64_t seq)
+{
+	sequence.store(seq);
+
+	/* Avoid the mutex if nobody is blocked in wait() */
+	if (waiters.load() > 0) {
+		pthread_mutex_lock(&mutex);
+		pthread_cond_broadcast(&cv);
+		pthread_mutex_unlock(&mutex);
+	}
+}
+
+void SampleMailbox::put(const struct Sample *smp)
+{
+	std::lock_guard<std::mutex> guard(writer);
+
+	unsigned len = MIN(smp->length, (unsigned) data.size());
+	uint64_t seq = begin();
+
+	for (unsigned i = 0; i < len; i++) {
+		if (memcmp(&data[i], &smp->data[i], sizeof(data[i])) || i >= length) {
+			data[i] = smp->data[i];
+			versions[i] = seq;
+		}
+	}
+
+	if (smp->flags & (int) SampleFlags::HAS_TS_ORIGIN)
+		ts = smp->ts.origin;
+
+	length = len;
+
+	commit(seq);
+}
+
+void SampleMailbox::put(const std::vector<Value> &values, const struct timespec *t)
+{
+	std::lock_guard<std::mutex> guard(writer);
+
+	uint64_t seq = begin();
+
+	for (auto &v : values) {
+		if (v.index >= data.size())
+			continue;
+
+		data[v.index] = v.data;
+		versions[v.index] = seq;
+
+		if (v.index >= length)
+			length = v.index + 1;
+	}
+
+	if (t)
+		ts = *t;
+
+	commit(seq);
+}
+
+uint64_t SampleMailbox::get(struct Sample *smp) const
+{
+	return read([&]() {
+		unsigned len = MIN(length, smp->capacity);
+
+		memcpy(smp->data, data.data(), len * sizeof(data[0]));
+
+		smp->length = len;
+		smp->ts.origin = ts;
+		smp->flags = (int) SampleFlags::HAS_DATA | (int) SampleFlags::HAS_TS_ORIGIN;
+		smp->signals = signals;
+	});
+}
+
+uint64_t SampleMailbox::get(unsigned index, union SignalData *d, struct timespec *t) const
+{
+	if (index >= data.size())
+		throw RuntimeError("Index out of range");
+
+	return read([&]() {
+		*d = data[index];
+
+		if (t)
+			*t = ts;
+	});
+}
+
+uint64_t SampleMailbox::getAll(std::vector<Value> &values, struct timespec *t) const
+{
+	return read([&]() {
+		values.clear();
+
+		for (unsigned i = 0; i < length; i++)
+			values.push_back({ i, data[i] });
+
+		if (t)
+			*t = ts;
+	});
+}
+
+uint64_t SampleMailbox::getChanged(uint64_t since, std::vector<Value> &values, struct timespec *t) const
+{
+	return read([&]() {
+		values.clear();
+
+		for (unsigned i = 0; i < length; i++) {
+			if (versions[i] > since)
+				values.push_back({ i, data[i] });
+		}
+
+		if (t)
+			*t = ts;
+	});
+}
+
+void SampleMailbox::waitCleanup(void *arg)
+{
+	auto *mb = static_cast<SampleMailbox *>(arg);
+
+	pthread_mutex_unlock(&mb->mutex);
+	mb->waiters--;
+}
+
+void SampleMailbox::wait(uint64_t since)
+{
+	waiters++;
+
+	pthread_mutex_lock(&mutex);
+	pthread_cleanup_push(waitCleanup, this);
+
+	while (sequence.load() <= since)
+		pthread_cond_wait(&cv, &mutex);
+
+	pthread_cleanup_pop(1);
+}
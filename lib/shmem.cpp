@@ -8,9 +8,13 @@
 
 #include <cerrno>
 #include <fcntl.h>
+#include <climits>
 #include <semaphore.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <unistd.h>
 
 #include <villas/kernel/kernel.hpp>
 #include <villas/node/memory.hpp>
@@ -201,3 +205,334 @@ int villas::node::shmem_int_alloc(struct ShmemInterface *shm, struct Sample *smp
 {
 	return sample_alloc_many(&shm->write.shared->pool, smps, cnt);
 }
+
+/** Get a slot of a broadcast ring. Slot 0 is the latest-value slot, the ring starts at slot 1. */
+static struct ShmemBroadcastSlot * shmem_bcast_slot(struct ShmemBroadcastShared *shared, size_t idx)
+{
+	char *slots = (char *) shared + CEIL(sizeof(struct ShmemBroadcastShared), CACHELINE_SIZE) * CACHELINE_SIZE;
+
+	return (struct ShmemBroadcastSlot *) (slots + idx * shared->slotsz);
+}
+
+static void shmem_bcast_store(struct ShmemBroadcastSlot *slot, const struct Sample *smp, unsigned samplelen)
+{
+	slot->sequence = smp->sequence;
+	slot->ts_origin = smp->ts.origin;
+	slot->ts_received = smp->ts.received;
+	slot->flags = smp->flags;
+	slot->length = MIN(smp->length, samplelen);
+
+	memcpy(slot->data, smp->data, SAMPLE_DATA_LENGTH(slot->length));
+}
+
+/* The slot might be overwritten concurrently, so the length is clamped
+ * before copying. The caller validates the copy afterwards. */
+static void shmem_bcast_load(const struct ShmemBroadcastSlot *slot, struct Sample *smp, unsigned samplelen)
+{
+	smp->sequence = slot->sequence;
+	smp->ts.origin = slot->ts_origin;
+	smp->ts.received = slot->ts_received;
+	smp->flags = slot->flags;
+	smp->length = MIN(MIN(slot->length, samplelen), smp->capacity);
+
+	memcpy(smp->data, slot->data, SAMPLE_DATA_LENGTH(smp->length));
+}
+
+/* The futex is not process-private as readers live in other processes.
+ * FUTEX_WAIT also works on the read-only mappings of the readers. */
+static void shmem_bcast_notify(struct ShmemBroadcastShared *shared)
+{
+	if (shared->polling)
+		return;
+
+	shared->notify.fetch_add(1, std::memory_order_release);
+
+	syscall(SYS_futex, &shared->notify, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+size_t villas::node::shmem_bcast_total_size(unsigned slots, unsigned samplelen)
+{
+	size_t slotsz = CEIL(sizeof(struct ShmemBroadcastSlot) + SAMPLE_DATA_LENGTH(samplelen), CACHELINE_SIZE) * CACHELINE_SIZE;
+
+	/* The header, the latest-value slot and the ring */
+	return CEIL(sizeof(struct ShmemBroadcastShared), CACHELINE_SIZE) * CACHELINE_SIZE
+		+ (slots + 1) * slotsz;
+}
+
+int villas::node::shmem_bcast_create(const char *name, struct ShmemBroadcast *b, unsigned slots, unsigned samplelen, bool polling)
+{
+	int fd, ret;
+	size_t len;
+	void *base;
+	struct ShmemBroadcastShared *shared;
+
+	if (!IS_POW2(slots))
+		slots = LOG2_CEIL(slots);
+
+	len = shmem_bcast_total_size(slots, samplelen);
+
+retry:	fd = shm_open(name, O_RDWR|O_CREAT|O_EXCL, 0600);
+	if (fd < 0) {
+		if (errno == EEXIST) {
+			ret = shm_unlink(name);
+			if (ret)
+				return -1;
+
+			goto retry;
+		}
+
+		return -1;
+	}
+
+	if (ftruncate(fd, len) < 0) {
+		close(fd);
+		return -1;
+	}
+
+	base = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if (base == MAP_FAILED)
+		return -1;
+
+	/* The region is zero-filled by ftruncate() */
+	shared = (struct ShmemBroadcastShared *) base;
+	shared->slots = slots;
+	shared->samplelen = samplelen;
+	shared->slotsz = CEIL(sizeof(struct ShmemBroadcastSlot) + SAMPLE_DATA_LENGTH(samplelen), CACHELINE_SIZE) * CACHELINE_SIZE;
+	shared->polling = polling;
+	shared->closed = 0;
+	shared->head = 0;
+	shared->notify = 0;
+	shared->latest = 0;
+
+	/* Readers only accept the ring once the magic is visible */
+	std::atomic_thread_fence(std::memory_order_release);
+	shared->magic = SHMEM_BROADCAST_MAGIC;
+
+	b->name = name;
+	b->base = base;
+	b->len = len;
+	b->writer = true;
+	b->shared = shared;
+	b->cursor = 0;
+	b->latest = 0;
+	b->overruns = 0;
+	b->notified = 0;
+
+	return 0;
+}
+
+int villas::node::shmem_bcast_attach(const char *name, struct ShmemBroadcast *b, bool oldest)
+{
+	int fd;
+	uint64_t head;
+	void *base;
+	struct stat stat_buf;
+	struct ShmemBroadcastShared *shared;
+
+	fd = shm_open(name, O_RDONLY, 0);
+	if (fd < 0)
+		return -1;
+
+	if (fstat(fd, &stat_buf) < 0) {
+		close(fd);
+		return -1;
+	}
+
+	if ((size_t) stat_buf.st_size < sizeof(struct ShmemBroadcastShared)) {
+		close(fd);
+		errno = EINVAL;
+		return -1;
+	}
+
+	base = mmap(nullptr, stat_buf.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if (base == MAP_FAILED)
+		return -1;
+
+	shared = (struct ShmemBroadcastShared *) base;
+
+	if (shared->magic != SHMEM_BROADCAST_MAGIC ||
+	    (size_t) stat_buf.st_size < shmem_bcast_total_size(shared->slots, shared->samplelen)) {
+		munmap(base, stat_buf.st_size);
+		errno = EINVAL;
+		return -1;
+	}
+
+	std::atomic_thread_fence(std::memory_order_acquire);
+
+	head = shared->head.load(std::memory_order_acquire);
+
+	b->name = name;
+	b->base = base;
+	b->len = stat_buf.st_size;
+	b->writer = false;
+	b->shared = shared;
+	b->cursor = oldest && head > shared->slots
+			? head - shared->slots
+			: oldest ? 0 : head;
+	b->latest = 0;
+	b->overruns = 0;
+	b->notified = 0;
+
+	return 0;
+}
+
+int villas::node::shmem_bcast_close(struct ShmemBroadcast *b)
+{
+	if (b->writer) {
+		b->shared->closed.store(1, std::memory_order_release);
+
+		/* Wake up blocked readers so that they notice the closed ring */
+		shmem_bcast_notify(b->shared);
+
+		/* Attached readers keep their mapping */
+		shm_unlink(b->name);
+	}
+
+	return munmap(b->base, b->len);
+}
+
+int villas::node::shmem_bcast_write(struct ShmemBroadcast *b, const struct Sample * const smps[], unsigned cnt)
+{
+	struct ShmemBroadcastShared *shared = b->shared;
+	struct ShmemBroadcastSlot *slot;
+	uint64_t head, latest;
+
+	if (!b->writer) {
+		errno = EPERM;
+		return -1;
+	}
+
+	head = shared->head.load(std::memory_order_relaxed);
+
+	for (unsigned i = 0; i < cnt; i++, head++) {
+		slot = shmem_bcast_slot(shared, 1 + (head & (shared->slots - 1)));
+
+		slot->stamp.store(2 * head + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		shmem_bcast_store(slot, smps[i], shared->samplelen);
+
+		slot->stamp.store(2 * head + 2, std::memory_order_release);
+		shared->head.store(head + 1, std::memory_order_release);
+	}
+
+	if (cnt > 0) {
+		slot = shmem_bcast_slot(shared, 0);
+
+		latest = shared->latest.load(std::memory_order_relaxed);
+		shared->latest.store(latest + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		shmem_bcast_store(slot, smps[cnt - 1], shared->samplelen);
+
+		shared->latest.store(latest + 2, std::memory_order_release);
+
+		shmem_bcast_notify(shared);
+	}
+
+	return cnt;
+}
+
+int villas::node::shmem_bcast_read(struct ShmemBroadcast *b, struct Sample * const smps[], unsigned cnt)
+{
+	struct ShmemBroadcastShared *shared = b->shared;
+	struct ShmemBroadcastSlot *slot;
+	uint64_t head, stamp, expected, pos;
+	unsigned i = 0;
+
+	/* Any write after this point will be noticed by shmem_bcast_wait() */
+	b->notified = shared->notify.load(std::memory_order_acquire);
+
+	head = shared->head.load(std::memory_order_acquire);
+
+	while (i < cnt && b->cursor < head) {
+		/* The writer has lapped us already */
+		if (head - b->cursor > shared->slots) {
+			b->overruns += head - shared->slots - b->cursor;
+			b->cursor = head - shared->slots;
+		}
+
+		slot = shmem_bcast_slot(shared, 1 + (b->cursor & (shared->slots - 1)));
+		expected = 2 * b->cursor + 2;
+
+		stamp = slot->stamp.load(std::memory_order_acquire);
+		if (stamp == expected) {
+			shmem_bcast_load(slot, smps[i], shared->samplelen);
+
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+			stamp = slot->stamp.load(std::memory_order_relaxed);
+			if (stamp == expected) {
+				b->cursor++;
+				i++;
+				continue;
+			}
+		}
+
+		/* The slot has been overwritten while we were reading it.
+		 * Skip to the oldest position which has not been overwritten yet. */
+		pos = (stamp - 1) / 2;
+		if (pos + 1 > b->cursor + shared->slots) {
+			b->overruns += pos + 1 - shared->slots - b->cursor;
+			b->cursor = pos + 1 - shared->slots;
+		}
+
+		head = shared->head.load(std::memory_order_acquire);
+	}
+
+	if (i == 0 && shared->closed.load(std::memory_order_acquire) &&
+	    b->cursor >= shared->head.load(std::memory_order_acquire))
+		return -1;
+
+	return i;
+}
+
+int villas::node::shmem_bcast_latest(struct ShmemBroadcast *b, struct Sample *smp)
+{
+	struct ShmemBroadcastShared *shared = b->shared;
+	uint64_t before, after;
+
+	b->notified = shared->notify.load(std::memory_order_acquire);
+
+	do {
+		before = shared->latest.load(std::memory_order_acquire);
+		if (before == b->latest)
+			return shared->closed.load(std::memory_order_acquire) ? -1 : 0;
+
+		/* The writer is updating the slot right now */
+		if (before & 1) {
+			after = before + 1;
+			continue;
+		}
+
+		shmem_bcast_load(shmem_bcast_slot(shared, 0), smp, shared->samplelen);
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		after = shared->latest.load(std::memory_order_relaxed);
+	} while (before != after);
+
+	b->latest = before;
+
+	return 1;
+}
+
+int villas::node::shmem_bcast_wait(struct ShmemBroadcast *b, const struct timespec *timeout)
+{
+	struct ShmemBroadcastShared *shared = b->shared;
+	int ret;
+
+	if (shared->polling)
+		return 0;
+
+	/* Fails with EAGAIN if the writer has notified us since the last read */
+	ret = syscall(SYS_futex, &shared->notify, FUTEX_WAIT, b->notified, timeout, nullptr, 0);
+	if (ret && errno != EAGAIN && errno != EINTR && errno != ETIMEDOUT)
+		return -1;
+
+	return 0;
+}
@@ -128,27 +128,59 @@ Signal::Ptr SignalList::getByIndex(unsigned idx)
 	return this->at(idx);
 }
 
-int SignalList::getIndexByName(const std::string &name)
+std::shared_ptr<const SignalList::NameIndex> SignalList::getIndex(bool rebuild) const
 {
+	auto idx = std::atomic_load(&index);
+	if (idx && idx->length == size() && !rebuild)
+		return idx;
+
+	auto nidx = std::make_shared<NameIndex>();
+
+	nidx->length = size();
+	nidx->indices.reserve(size());
+
+	/* Keep the first occurrence of duplicate names like the linear search did */
 	unsigned i = 0;
-	for (auto s : *this) {
-		if (name == s->name)
-			return i;
+	for (auto s : *this)
+		nidx->indices.emplace(s->name, i++);
 
-		i++;
+	std::atomic_store(&index, std::shared_ptr<const NameIndex>(nidx));
+
+	return nidx;
+}
+
+void SignalList::invalidateIndex()
+{
+	std::atomic_store(&index, std::shared_ptr<const NameIndex>());
+}
+
+int SignalList::getIndexByName(const std::string &name) const
+{
+	auto idx = getIndex();
+
+	/* Guard against modifications which did not invalidate the index */
+	auto it = idx->indices.find(name);
+	if (it != idx->indices.end() && it->second < size() && (*this)[it->second]->name == name)
+		return it->second;
+
+	/* Signals are shared between lists. Hence, renaming a signal in place
+	 * can not invalidate the indices of all lists which contain it. */
+	for (unsigned i = 0; i < size(); i++) {
+		if ((*this)[i]->name == name) {
+			getIndex(true);
+
+			return i;
+		}
 	}
 
 	return -1;
 }
 
-Signal::Ptr SignalList::getByName(const std::string &name)
+Signal::Ptr SignalList::getByName(const std::string &name) const
 {
-	for (auto s : *this) {
-		if (name == s->name)
-			return s;
-	}
+	int idx = getIndexByName(name);
 
-	return Signal::Ptr();
+	return idx < 0 ? Signal::Ptr() : (*this)[idx];
 }
 
 SignalList::Ptr SignalList::clone()
@@ -158,5 +190,8 @@ SignalList::Ptr SignalList::clone()
 	for (auto s : *this)
 		l->push_back(s);
 
+	/* Both lists contain the same signals so far */
+	l->index = std::atomic_load(&index);
+
 	return l;
 }
@@ -26,6 +26,9 @@ std::unordered_map<Stats::Metric, Stats::MetricDescription> Stats::metrics = {
 	{ Stats::Metric::OWD, 			{ "owd",		"seconds", "One-way-delay (OWD) of received messages" 			}},
 	{ Stats::Metric::AGE, 			{ "age",		"seconds", "Processing time of packets within the from receive to sent" }},
 	{ Stats::Metric::SIGNAL_COUNT,          { "signal_cnt",         "signals", "Number of signals per sample"                               }},
+	{ Stats::Metric::TX_DELAY, 		{ "tx_delay",		"seconds", "Delay between sending and the transmit timestamp of the kernel/NIC" }},
+	{ Stats::Metric::BATCH_IN, 		{ "batch_in",		"samples", "Number of samples per read (vectorization)" 		}},
+	{ Stats::Metric::BATCH_OUT, 		{ "batch_out",		"samples", "Number of samples per write (vectorization)" 		}},
 	{ Stats::Metric::RTP_LOSS_FRACTION, 	{ "rtp.loss_fraction",	"percent", "Fraction lost since last RTP SR/RR."			}},
 	{ Stats::Metric::RTP_PKTS_LOST, 	{ "rtp.pkts_lost",	"packets", "Cumulative number of packets lost" 				}},
 	{ Stats::Metric::RTP_JITTER, 		{ "rtp.jitter",		"seconds", "Interarrival jitter" 					}},
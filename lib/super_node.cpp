@@ -8,10 +8,14 @@
 #include <algorithm>
 #include <cstdlib>
 #include <cstring>
+#include <set>
 
 #include <villas/super_node.hpp>
+#include <villas/config_diff.hpp>
 #include <villas/node.hpp>
 #include <villas/path.hpp>
+#include <villas/path_source.hpp>
+#include <villas/path_destination.hpp>
 #include <villas/uuid.hpp>
 #include <villas/hook_list.hpp>
 #include <villas/node/memory.hpp>
@@ -48,8 +52,12 @@ SuperNode::SuperNode() :
 	affinity(0),
 	hugepages(DEFAULT_NR_HUGEPAGES),
 	statsRate(1.0),
+	clockSource(ClockSource::SYSTEM),
 	task(CLOCK_REALTIME),
-	started(time_now())
+	started(time_now()),
+	reloadPending(false),
+	generation(0),
+	pristine(nullptr)
 {
 	int ret;
 
@@ -89,12 +97,17 @@ void SuperNode::parse(json_t *root)
 	json_t *json_paths = nullptr;
 	json_t *json_logging = nullptr;
 	json_t *json_http = nullptr;
+	json_t *json_clock = nullptr;
 
 	json_error_t err;
 
 	idleStop = 1;
 
-	ret = json_unpack_ex(root, &err, 0, "{ s?: F, s?: o, s?: o, s?: o, s?: o, s?: i, s?: i, s?: i, s?: b, s?: s }",
+	/* Keep an unparsed copy for comparison with later configurations */
+	json_decref(pristine);
+	pristine = json_deep_copy(root);
+
+	ret = json_unpack_ex(root, &err, 0, "{ s?: F, s?: o, s?: o, s?: o, s?: o, s?: i, s?: i, s?: i, s?: b, s?: s, s?: o }",
 		"stats", &statsRate,
 		"http", &json_http,
 		"logging", &json_logging,
@@ -104,7 +117,8 @@ void SuperNode::parse(json_t *root)
 		"affinity", &affinity,
 		"priority", &priority,
 		"idle_stop", &idleStop,
-		"uuid", &uuid_str
+		"uuid", &uuid_str,
+		"clock", &json_clock
 	);
 	if (ret)
 		throw ConfigError(root, err, "node-config", "Unpacking top-level config failed");
@@ -123,6 +137,9 @@ void SuperNode::parse(json_t *root)
 	if (json_logging)
 		logging.parse(json_logging);
 
+	if (json_clock)
+		clock_parse(&clockSource, json_clock);
+
 	/* Parse nodes */
 	if (json_nodes) {
 		if (!json_is_object(json_nodes))
@@ -130,77 +147,144 @@ void SuperNode::parse(json_t *root)
 
 		const char *name;
 		json_t *json_node;
-		json_object_foreach(json_nodes, name, json_node) {
-			const char *type;
+		json_object_foreach(json_nodes, name, json_node)
+			nodes.push_back(parseNode(name, json_node));
+	}
 
-			ret = Node::isValidName(name);
-			if (!ret)
-				throw RuntimeError("Invalid name for node: {}", name);
+	/* Parse paths */
+	if (json_paths) {
+		if (!json_is_array(json_paths))
+			logger->warn("Setting 'paths' must be a list of objects");
 
-			ret = json_unpack_ex(json_node, &err, 0, "{ s: s }", "type", &type);
-			if (ret)
-				throw ConfigError(root, err, "node-config-node-type", "Failed to parse type of node '{}'", name);
+		size_t i;
+		json_t *json_path;
+		json_array_foreach(json_paths, i, json_path) {
+			for (auto *p : parsePath(json_path, nodes)) {
+				paths.push_back(p);
+				pathIndices[p] = i;
+			}
+		}
+	}
+
+	state = State::PARSED;
+}
+
+Node * SuperNode::parseNode(const std::string &name, json_t *json_node)
+{
+	int ret;
+	const char *type;
 
-			json_object_set_new(json_node, "name", json_string(name));
+	json_error_t err;
 
-			auto *n = NodeFactory::make(type);
-			if (!n)
-				throw MemoryAllocationError();
+	ret = Node::isValidName(name);
+	if (!ret)
+		throw RuntimeError("Invalid name for node: {}", name);
 
-			ret = n->parse(json_node, uuid);
-			if (ret) {
-				auto config_id = fmt::format("node-config-node-{}", type);
+	ret = json_unpack_ex(json_node, &err, 0, "{ s: s }", "type", &type);
+	if (ret)
+		throw ConfigError(json_node, err, "node-config-node-type", "Failed to parse type of node '{}'", name);
 
-				throw ConfigError(json_node, config_id, "Failed to parse configuration of node '{}'", name);
-			}
+	json_object_set_new(json_node, "name", json_string(name.c_str()));
 
-			json_object_del(json_node, "name");
+	auto *n = NodeFactory::make(type);
+	if (!n)
+		throw MemoryAllocationError();
 
-			nodes.push_back(n);
-		}
+	ret = n->parse(json_node, uuid);
+	if (ret) {
+		auto config_id = fmt::format("node-config-node-{}", type);
+
+		delete n;
+
+		throw ConfigError(json_node, config_id, "Failed to parse configuration of node '{}'", name);
 	}
 
-	/* Parse paths */
-	if (json_paths) {
-		if (!json_is_array(json_paths))
-			logger->warn("Setting 'paths' must be a list of objects");
+	json_object_del(json_node, "name");
 
-		size_t i;
-		json_t *json_path;
-		json_array_foreach(json_paths, i, json_path) {
-parse:			auto *p = new Path();
-			if (!p)
-				throw MemoryAllocationError();
+	return n;
+}
 
-			p->parse(json_path, nodes, uuid);
+std::list<Path *> SuperNode::parsePath(json_t *json_path, NodeList &ns)
+{
+	int ret;
+	std::list<Path *> parsed;
 
-			paths.push_back(p);
+parse:	auto *p = new Path();
+	if (!p)
+		throw MemoryAllocationError();
 
-			if (p->isReversed()) {
-				/* Only simple paths can be reversed */
-				ret = p->isSimple();
-				if (!ret)
-					throw RuntimeError("Complex paths can not be reversed!");
+	p->parse(json_path, ns, uuid);
 
-				/* Parse a second time with in/out reversed */
-				json_path = json_copy(json_path);
+	parsed.push_back(p);
 
-				json_t *json_in = json_object_get(json_path, "in");
-				json_t *json_out = json_object_get(json_path, "out");
+	if (p->isReversed()) {
+		/* Only simple paths can be reversed */
+		ret = p->isSimple();
+		if (!ret)
+			throw RuntimeError("Complex paths can not be reversed!");
 
-				if (json_equal(json_in, json_out))
-					throw RuntimeError("Can not reverse path with identical in/out nodes!");
+		/* Parse a second time with in/out reversed */
+		json_path = json_copy(json_path);
 
-				json_object_set(json_path, "reverse", json_false());
-				json_object_set(json_path, "in", json_out);
-				json_object_set(json_path, "out", json_in);
+		json_t *json_in = json_object_get(json_path, "in");
+		json_t *json_out = json_object_get(json_path, "out");
 
-				goto parse;
-			}
+		if (json_equal(json_in, json_out))
+			throw RuntimeError("Can not reverse path with identical in/out nodes!");
+
+		json_object_set(json_path, "reverse", json_false());
+		json_object_set(json_path, "in", json_out);
+		json_object_set(json_path, "out", json_in);
+
+		goto parse;
+	}
+
+	return parsed;
+}
+
+void SuperNode::validate(json_t *root)
+{
+	int ret;
+	NodeList ns;
+	std::list<Path *> ps;
+
+	json_t *json_nodes = json_object_get(root, "nodes");
+	json_t *json_paths = json_object_get(root, "paths");
+
+	auto cleanup = [&]() {
+		for (auto *p : ps)
+			delete p;
+
+		for (auto *n : ns)
+			delete n;
+	};
+
+	try {
+		const char *name;
+		json_t *json_node;
+		json_object_foreach(json_nodes, name, json_node) {
+			auto *n = parseNode(name, json_node);
+
+			ns.push_back(n);
+
+			ret = n->check();
+			if (ret)
+				throw RuntimeError("Invalid configuration for node {}", n->getName());
 		}
+
+		size_t i;
+		json_t *json_path;
+		json_array_foreach(json_paths, i, json_path)
+			ps.splice(ps.end(), parsePath(json_path, ns));
+
+		for (auto *p : ps)
+			p->check();
+	} catch (...) {
+		cleanup();
+		throw;
 	}
 
-	state = State::PARSED;
+	cleanup();
 }
 
 void SuperNode::check()
@@ -308,6 +392,10 @@ void SuperNode::prepare()
 
 	kernel::rt::init(priority, affinity);
 
+	ret = clock_init(clockSource);
+	if (!ret && clockSource == ClockSource::TSC)
+		logger->info("Using calibrated TSC as clock source: frequency={:.6f} GHz", clock_tsc_frequency() * 1e-9);
+
 	prepareNodeTypes();
 	prepareNodes();
 	preparePaths();
@@ -402,10 +490,14 @@ void SuperNode::stopInterfaces()
 
 void SuperNode::stop()
 {
-	stopNodes();
-	stopPaths();
-	stopNodeTypes();
-	stopInterfaces();
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+
+		stopNodes();
+		stopPaths();
+		stopNodeTypes();
+		stopInterfaces();
+	}
 
 #ifdef WITH_API
 	api.stop();
@@ -425,12 +517,277 @@ void SuperNode::run()
 	while (state == State::STARTED) {
 		task.wait();
 
+		if (reloadPending.exchange(false)) {
+			if (uri.empty())
+				logger->warn("Cannot reload configuration: instance has been started without a configuration file");
+			else {
+				try {
+					json_decref(reload(uri));
+				} catch (std::exception &e) {
+					logger->error("Failed to reload configuration: {}", e.what());
+				}
+			}
+		}
+
+		std::lock_guard<std::mutex> guard(mutex);
+
 		ret = periodic();
 		if (ret)
 			state = State::STOPPING;
 	}
 }
 
+json_t * SuperNode::reload(const std::string &u, bool dryRun)
+{
+	json_t *root = config.load(u);
+
+	json_t *json_diff = reload(root, dryRun);
+
+	if (!dryRun && json_is_true(json_object_get(json_diff, "applied")))
+		uri = u;
+
+	json_decref(root);
+
+	return json_diff;
+}
+
+json_t * SuperNode::reload(json_t *root, bool dryRun)
+{
+	int ret;
+
+	std::lock_guard<std::mutex> guard(mutex);
+
+	ConfigDiff diff(pristine, root);
+
+	json_t *json_diff = diff.toJson();
+	bool apply = !dryRun && !diff.global && !diff.isEmpty();
+
+	json_object_set_new(json_diff, "dry_run", json_boolean(dryRun));
+	json_object_set_new(json_diff, "applied", json_boolean(apply));
+
+	if (dryRun)
+		return json_diff;
+	else if (diff.global) {
+		logger->warn("Global settings have changed. A full restart is required to apply the new configuration");
+		return json_diff;
+	}
+	else if (diff.isEmpty()) {
+		logger->info("Configuration has not changed");
+		return json_diff;
+	}
+
+	if (state != State::STARTED)
+		throw RuntimeError("Configuration can only be reloaded while the super node is running");
+
+	logger->info("Reloading configuration");
+
+	json_t *next = json_deep_copy(root);
+	json_t *json_nodes = json_object_get(root, "nodes");
+	json_t *json_paths = json_object_get(root, "paths");
+
+	/* Validate the new configuration and create new nodes first
+	 * so that an invalid configuration leaves the running instance untouched */
+	NodeList fresh;
+	try {
+		validate(root);
+
+		const char *name;
+		json_t *json_node;
+		json_object_foreach(json_nodes, name, json_node) {
+			if (!diff.isNodeFresh(name))
+				continue;
+
+			auto *n = parseNode(name, json_node);
+
+			fresh.push_back(n);
+
+			ret = n->check();
+			if (ret)
+				throw RuntimeError("Invalid configuration for node {}", n->getName());
+		}
+
+		/* Replace hooks of nodes which keep their connection.
+		 * The new hooks are prepared before they are swapped in. */
+		for (auto *n : nodes) {
+			auto it = diff.nodes.find(n->getNameShort());
+			if (it == diff.nodes.end() || it->second != ConfigDiff::Change::HOOKS)
+				continue;
+
+			if (n->getState() == State::STARTED) {
+				ret = n->reloadHooks(json_object_get(json_nodes, it->first.c_str()));
+				if (ret)
+					throw RuntimeError("Failed to reload hooks of node: {}", n->getName());
+			}
+		}
+	} catch (...) {
+		for (auto *n : fresh)
+			delete n;
+
+		json_decref(next);
+		json_decref(json_diff);
+
+		throw;
+	}
+
+	/* The new configuration becomes the running one. This also happens
+	 * if it has been applied only partially as the stale nodes and paths
+	 * are gone already and must not be compared against anymore. */
+	auto commit = [&]() {
+		/* Nodes and paths which keep running still refer to the old configuration */
+		retired.push_back(config.root);
+		config.root = json_incref(root);
+
+		json_decref(pristine);
+		pristine = next;
+
+		generation++;
+	};
+
+	std::list<Path *> created;
+	try {
+		/* Stop paths which are removed or rebuilt */
+		std::set<Path *> stalePaths;
+		std::set<Node *> staleNodes;
+		for (auto *p : paths) {
+			auto it = pathIndices.find(p);
+			if (it == pathIndices.end() || diff.oldPaths[it->second] == ConfigDiff::Change::NONE)
+				continue;
+
+			if (p->getState() == State::STARTED ||
+			    p->getState() == State::PAUSED)
+				p->stop();
+
+			/* Internal loopback nodes of secondary path sources belong to the path */
+			for (auto ps : p->sources) {
+				if (std::dynamic_pointer_cast<SecondaryPathSource>(ps))
+					staleNodes.insert(ps->getNode());
+			}
+
+			stalePaths.insert(p);
+		}
+
+		/* Detach stale paths from the nodes which keep running */
+		auto isStale = [&stalePaths](Path *p) {
+			return stalePaths.find(p) != stalePaths.end();
+		};
+
+		for (auto *n : nodes) {
+			n->sources.erase(std::remove_if(n->sources.begin(), n->sources.end(),
+				[&](PathSource::Ptr ps) { return isStale(ps->getPath()); }), n->sources.end());
+
+			n->destinations.erase(std::remove_if(n->destinations.begin(), n->destinations.end(),
+				[&](PathDestination::Ptr pd) { return isStale(pd->getPath()); }), n->destinations.end());
+
+			if (isStale(n->out.path))
+				n->out.path = nullptr;
+
+			if (diff.isNodeStale(n->getNameShort()))
+				staleNodes.insert(n);
+		}
+
+		/* Stop nodes which are removed or rebuilt */
+		for (auto *n : staleNodes) {
+			if (n->getState() == State::STARTED ||
+			    n->getState() == State::PAUSED ||
+			    n->getState() == State::STOPPING) {
+				ret = n->stop();
+				if (ret)
+					throw RuntimeError("Failed to stop node: {}", n->getName());
+			}
+
+			nodes.remove(n);
+		}
+
+		for (auto *p : stalePaths) {
+			paths.remove(p);
+			pathIndices.erase(p);
+
+			delete p;
+		}
+
+		for (auto *n : staleNodes)
+			delete n;
+
+		/* Remaining paths are now found at their new index */
+		for (auto &pi : pathIndices)
+			pi.second = diff.pathMatches[pi.second];
+
+		for (auto *n : fresh)
+			nodes.push_back(n);
+
+		/* Create new and rebuilt paths */
+		size_t i;
+		json_t *json_path;
+		json_array_foreach(json_paths, i, json_path) {
+			if (diff.newPaths[i] == ConfigDiff::Change::NONE)
+				continue;
+
+			for (auto *p : parsePath(json_path, nodes)) {
+				paths.push_back(p);
+				pathIndices[p] = i;
+
+				created.push_back(p);
+			}
+		}
+
+		for (auto *p : created)
+			p->check();
+
+		prepareNodeTypes();
+
+		for (auto *n : fresh) {
+			if (!n->isEnabled())
+				continue;
+
+			ret = n->prepare();
+			if (ret)
+				throw RuntimeError("Failed to prepare node: {}", n->getName());
+		}
+
+		for (auto *p : created) {
+			if (p->isEnabled())
+				p->prepare(nodes);
+		}
+
+		for (auto *n : nodes) {
+			bool used = n->sources.size() > 0 || n->destinations.size() > 0;
+
+			/* Nodes which have been disabled because they were not used before */
+			if (n->getState() == State::PREPARED && used)
+				n->setEnabled(true);
+			else if (n->getState() == State::PREPARED && n->isEnabled() && !used) {
+				logger->info("Node {} is not used by any path. Disabling...", n->getName());
+				n->setEnabled(false);
+			}
+
+			if (n->getState() == State::PREPARED && n->isEnabled()) {
+				ret = n->start();
+				if (ret)
+					throw RuntimeError("Failed to start node: {}", n->getName());
+			}
+		}
+
+		for (auto *p : created) {
+			if (p->isEnabled())
+				p->start();
+		}
+	} catch (...) {
+		logger->error("The new configuration has only been applied partially");
+
+		commit();
+
+		json_decref(json_diff);
+
+		throw;
+	}
+
+	commit();
+
+	logger->info("Reloaded configuration: {} paths rebuilt, {} nodes rebuilt", created.size(), fresh.size());
+
+	return json_diff;
+}
+
 SuperNode::~SuperNode()
 {
 	assert(state == State::INITIALIZED ||
@@ -444,6 +801,11 @@ SuperNode::~SuperNode()
 
 	for (auto *n : nodes)
 		delete n;
+
+	for (auto *json : retired)
+		json_decref(json);
+
+	json_decref(pristine);
 }
 
 int SuperNode::periodic()
@@ -0,0 +1,257 @@
+/** Kernel and hardware packet timestamping (SO_TIMESTAMPING)
+ *
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+#include <cstring>
+#include <cerrno>
+#include <sys/ioctl.h>
+
+#ifdef __linux__
+  #include <net/if.h>
+  #include <linux/errqueue.h>
+  #include <linux/net_tstamp.h>
+  #include <linux/sockios.h>
+#endif /* __linux__ */
+
+#include <villas/timestamping.hpp>
+#include <villas/exceptions.hpp>
+#include <villas/timing.hpp>
+#include <villas/log.hpp>
+
+using namespace villas;
+using namespace villas::node;
+
+int villas::node::timestamping_parse(struct Timestamping *t, json_t *json)
+{
+	int ret;
+	json_error_t err;
+	const char *mode = nullptr;
+
+	t->mode = TimestampingMode::NONE;
+	t->tx = 0;
+
+	if (json_is_string(json))
+		mode = json_string_value(json);
+	else if (json_is_object(json)) {
+		ret = json_unpack_ex(json, &err, 0, "{ s?: s, s?: b }",
+			"mode", &mode,
+			"tx", &t->tx
+		);
+		if (ret)
+			throw ConfigError(json, err, "node-config-timestamping");
+	}
+	else
+		throw ConfigError(json, "node-config-timestamping", "Timestamping settings must be a string or an object");
+
+	if (mode) {
+		if (!strcmp(mode, "none"))
+			t->mode = TimestampingMode::NONE;
+		else if (!strcmp(mode, "software"))
+			t->mode = TimestampingMode::SOFTWARE;
+		else if (!strcmp(mode, "hardware"))
+			t->mode = TimestampingMode::HARDWARE;
+		else
+			throw ConfigError(json, "node-config-timestamping-mode", "Invalid timestamping mode: {}", mode);
+	}
+
+	/* Transmit delays are measured against the user space send time in CLOCK_REALTIME.
+	 * Hardware timestamps are taken in the time domain of the PHC and can not be compared to it. */
+	if (t->mode == TimestampingMode::HARDWARE && t->tx)
+		throw ConfigError(json, "node-config-timestamping-tx", "Transmit timestamps are not supported in hardware timestamping mode");
+
+#ifndef __linux__
+	if (t->mode != TimestampingMode::NONE)
+		throw ConfigError(json, "node-config-timestamping-mode", "Kernel timestamping is only supported on Linux");
+#endif /* __linux__ */
+
+	return 0;
+}
+
+const char * villas::node::timestamping_mode_str(enum TimestampingMode mode)
+{
+	switch (mode) {
+		case TimestampingMode::NONE:
+			return "none";
+
+		case TimestampingMode::SOFTWARE:
+			return "software";
+
+		case TimestampingMode::HARDWARE:
+			return "hardware";
+	}
+
+	return nullptr;
+}
+
+int villas::node::timestamping_start(struct Timestamping *t, int sd, const char *ifname)
+{
+	t->tx_id = 0;
+	memset(t->tx_sent, 0, sizeof(t->tx_sent));
+
+	if (t->mode == TimestampingMode::NONE)
+		return 0;
+
+#ifdef __linux__
+	int ret, flags = 0;
+
+	if (t->mode == TimestampingMode::HARDWARE) {
+		/* Hardware timestamping can also be enabled externally (e.g. with hwstamp_ctl) */
+		if (ifname) {
+			struct ifreq ifr;
+			struct hwtstamp_config cfg;
+
+			memset(&cfg, 0, sizeof(cfg));
+			cfg.tx_type = HWTSTAMP_TX_OFF;
+			cfg.rx_filter = HWTSTAMP_FILTER_ALL;
+
+			memset(&ifr, 0, sizeof(ifr));
+			strncpy(ifr.ifr_name, ifname, sizeof(ifr.ifr_name) - 1);
+			ifr.ifr_data = (char *) &cfg;
+
+			ret = ioctl(sd, SIOCSHWTSTAMP, &ifr);
+			if (ret) {
+				auto logger = logging.get("timestamping");
+				logger->error("Failed to enable hardware timestamping for interface {}: {}", ifname, strerror(errno));
+				return ret;
+			}
+		}
+
+		/* We do not request software timestamps as a fallback.
+		 * Otherwise, samples would carry timestamps of two different clocks. */
+		flags |= SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE;
+	}
+	else {
+		flags |= SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+		if (t->tx)
+			flags |= SOF_TIMESTAMPING_TX_SOFTWARE | SOF_TIMESTAMPING_OPT_ID | SOF_TIMESTAMPING_OPT_TSONLY;
+	}
+
+	ret = setsockopt(sd, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags));
+	if (ret)
+		return ret;
+
+	return 0;
+#else
+	return -1;
+#endif /* __linux__ */
+}
+
+#ifdef __linux__
+/** Select the timestamp of the configured clock from a SCM_TIMESTAMPING control message. */
+static
+void timestamping_select(struct Timestamping *t, const struct scm_timestamping *tss, struct timespec *ts)
+{
+	/* ts[1] is deprecated and always zero, ts[2] holds the raw hardware timestamp.
+	 * Packets without a hardware timestamp are left without one rather than mixing in a software timestamp. */
+	*ts = t->mode == TimestampingMode::HARDWARE
+		? tss->ts[2]
+		: tss->ts[0];
+}
+#endif /* __linux__ */
+
+ssize_t villas::node::timestamping_recv(struct Timestamping *t, int sd, void *buf, size_t len, int flags, struct sockaddr *src, socklen_t *srclen, struct timespec *ts)
+{
+	ts->tv_sec = 0;
+	ts->tv_nsec = 0;
+
+	if (t->mode == TimestampingMode::NONE)
+		return recvfrom(sd, buf, len, flags, src, srclen);
+
+#ifdef __linux__
+	ssize_t bytes;
+	char control[CMSG_SPACE(sizeof(struct scm_timestamping))];
+
+	struct iovec iov = {
+		.iov_base = buf,
+		.iov_len = len
+	};
+
+	struct msghdr msg;
+	memset(&msg, 0, sizeof(msg));
+
+	msg.msg_name = src;
+	msg.msg_namelen = srclen ? *srclen : 0;
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = control;
+	msg.msg_controllen = sizeof(control);
+
+	bytes = recvmsg(sd, &msg, flags);
+	if (bytes < 0)
+		return bytes;
+
+	if (srclen)
+		*srclen = msg.msg_namelen;
+
+	for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+		if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPING)
+			timestamping_select(t, (struct scm_timestamping *) CMSG_DATA(cmsg), ts);
+	}
+
+	return bytes;
+#else
+	return recvfrom(sd, buf, len, flags, src, srclen);
+#endif /* __linux__ */
+}
+
+void villas::node::timestamping_sent(struct Timestamping *t, const struct timespec *ts)
+{
+	if (t->mode == TimestampingMode::NONE || !t->tx)
+		return;
+
+	t->tx_sent[t->tx_id++ % TIMESTAMPING_TX_SLOTS] = *ts;
+}
+
+int villas::node::timestamping_tx_delays(struct Timestamping *t, int sd, double delays[], unsigned cnt)
+{
+	unsigned num = 0;
+
+	if (t->mode == TimestampingMode::NONE || !t->tx)
+		return 0;
+
+#ifdef __linux__
+	while (num < cnt) {
+		char control[CMSG_SPACE(sizeof(struct scm_timestamping)) + CMSG_SPACE(sizeof(struct sock_extended_err) + sizeof(struct sockaddr_storage))];
+
+		struct msghdr msg;
+		memset(&msg, 0, sizeof(msg));
+
+		msg.msg_control = control;
+		msg.msg_controllen = sizeof(control);
+
+		/* Transmit timestamps are reported asynchronously via the error queue */
+		ssize_t ret = recvmsg(sd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT);
+		if (ret < 0)
+			break;
+
+		struct timespec ts = { 0, 0 };
+		bool has_id = false;
+		uint32_t id = 0;
+
+		for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+			if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPING)
+				timestamping_select(t, (struct scm_timestamping *) CMSG_DATA(cmsg), &ts);
+			else if (cmsg->cmsg_len >= CMSG_LEN(sizeof(struct sock_extended_err))) {
+				/* The level and type depend on the protocol (IP_RECVERR, PACKET_TX_TIMESTAMP, ...) */
+				auto *serr = (struct sock_extended_err *) CMSG_DATA(cmsg);
+
+				if (serr->ee_errno == ENOMSG && serr->ee_origin == SO_EE_ORIGIN_TIMESTAMPING) {
+					id = serr->ee_data;
+					has_id = true;
+				}
+			}
+		}
+
+		/* Ignore timestamps of packets which are not tracked anymore */
+		if (!has_id || (ts.tv_sec == 0 && ts.tv_nsec == 0) || t->tx_id - id > TIMESTAMPING_TX_SLOTS)
+			continue;
+
+		delays[num++] = time_delta(&t->tx_sent[id % TIMESTAMPING_TX_SLOTS], &ts);
+	}
+#endif /* __linux__ */
+
+	return num;
+}
@@ -0,0 +1,16 @@
+/** Semaphores of the static tracepoints.
+ *
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+#include <villas/node/trace.hpp>
+
+/* The notes of the probes refer to the semaphores which by convention live in the .probes section */
+#define VILLAS_TRACE_DEFINE(probe) \
+	__extension__ unsigned short VILLAS_TRACE_SEMAPHORE(probe) __attribute__ ((section (".probes")));
+
+extern "C" {
+	VILLAS_TRACE_PROBES(VILLAS_TRACE_DEFINE)
+}
@@ -0,0 +1,107 @@
+"""
+Benchmark the NumPy binding against the text-based exchange of communicate.py
+
+A loopback node is fed with batches of samples from a NumPy matrix which are
+read back as NumPy arrays. The text baseline formats and parses the same
+samples like villas-pipe and communicate.py do.
+
+@author Steffen Vogel <post@steffenvogel.de>
+@copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+@license Apache 2.0
+"""
+
+import argparse
+import time
+
+import numpy as np
+
+from villas.node.sample import Sample, Timestamp
+
+
+def bench_binding(signals, vectorize, count):
+    from villas.node import binding
+
+    binding.memory_init(0)
+
+    node = binding.Node({
+        'type': 'loopback',
+        'name': 'bench',
+        'queuelen': 4 * vectorize,
+        'in': {
+            'signals': {
+                'count': signals,
+                'type': 'float'
+            }
+        }
+    }, pool_size=2 * vectorize, sample_length=signals)
+
+    node.check()
+    node.prepare()
+    node.start()
+
+    values = np.random.rand(vectorize, signals)
+    total = 0
+    checksum = 0.0
+
+    start = time.perf_counter()
+
+    while total < count:
+        written = node.write(values)
+
+        batch = node.read(written)
+        checksum += batch.values.sum()
+        total += len(batch)
+
+        del batch
+
+    elapsed = time.perf_counter() - start
+
+    node.stop()
+    node.close()
+
+    return total, elapsed
+
+
+def bench_text(signals, vectorize, count):
+    values = np.random.rand(vectorize, signals)
+    total = 0
+
+    start = time.perf_counter()
+
+    while total < count:
+        for row in values:
+            line = str(Sample(Timestamp.now(None, total), list(row)))
+            Sample.parse(line)
+
+            total += 1
+
+    elapsed = time.perf_counter() - start
+
+    return total, elapsed
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[1])
+    parser.add_argument('-s', '--signals', type=int, default=16,
+                        help='number of signals per sample')
+    parser.add_argument('-v', '--vectorize', type=int, default=256,
+                        help='number of samples per batch')
+    parser.add_argument('-c', '--count', type=int, default=1000000,
+                        help='number of samples to exchange')
+    parser.add_argument('--text', action='store_true',
+                        help='also run the text-based baseline')
+    args = parser.parse_args()
+
+    benchmarks = [('binding', bench_binding)]
+    if args.text:
+        benchmarks.append(('text', bench_text))
+
+    for name, bench in benchmarks:
+        total, elapsed = bench(args.signals, args.vectorize, args.count)
+
+        print(f'{name:>8}: {total} samples in {elapsed:.3f} s '
+              f'= {total / elapsed:,.0f} samples/s')
+
+
+if __name__ == '__main__':
+    main()
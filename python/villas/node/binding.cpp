@@ -0,0 +1,945 @@
+/** NumPy binding for the VILLASnode C-API and shared memory interface
+ *
+ * Samples are exchanged in batches. The values, sequence numbers and
+ * timestamps of a batch are exposed as NumPy arrays which directly view
+ * the sample pool or shared memory region whenever the samples of the
+ * batch are evenly spaced in memory. Otherwise they are copied once.
+ *
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#define NPY_NO_DEPRECATED_API NPY_1_7_API_VERSION
+#include <numpy/arrayobject.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <exception>
+#include <string>
+
+#include <uuid/uuid.h>
+
+#include <villas/node/config.hpp>
+#include <villas/sample.hpp>
+#include <villas/shmem.hpp>
+
+extern "C" {
+	#include <villas/node.h>
+}
+
+using villas::node::Sample;
+
+static_assert(sizeof(struct timespec) == 2 * sizeof(npy_int64), "Timestamps can not be viewed as int64 pairs");
+
+/** Counter for batches which still reference samples of a Node or Shmem. */
+typedef Py_ssize_t batch_count_t;
+
+struct BatchObject {
+	PyObject_HEAD
+	PyObject *owner;		/**< The Node or Shmem object which owns the samples. */
+	batch_count_t *outstanding;	/**< The batch counter of the owner. */
+	Sample **smps;
+	unsigned cnt;
+	unsigned len;			/**< The maximum number of values per sample. */
+};
+
+struct NodeObject {
+	PyObject_HEAD
+	vnode *node;
+	vpool *pool;
+	unsigned pool_size;
+	unsigned sample_length;
+	uint64_t sequence;
+	batch_count_t batches;
+};
+
+struct ShmemObject {
+	PyObject_HEAD
+	struct villas::node::ShmemInterface shm;
+	bool opened;
+	unsigned queuelen;
+	unsigned samplelen;
+	uint64_t sequence;
+	batch_count_t batches;
+};
+
+static PyTypeObject BatchType = { PyVarObject_HEAD_INIT(nullptr, 0) };
+static PyTypeObject NodeType = { PyVarObject_HEAD_INIT(nullptr, 0) };
+static PyTypeObject ShmemType = { PyVarObject_HEAD_INIT(nullptr, 0) };
+
+/* Batch */
+
+static PyObject * batch_new(PyObject *owner, batch_count_t *outstanding, Sample **smps, unsigned cnt)
+{
+	auto *b = PyObject_New(BatchObject, &BatchType);
+	if (!b)
+		return nullptr;
+
+	Py_INCREF(owner);
+
+	b->owner = owner;
+	b->outstanding = outstanding;
+	b->smps = smps;
+	b->cnt = cnt;
+	b->len = 0;
+
+	for (unsigned i = 0; i < cnt; i++)
+		b->len = std::max(b->len, smps[i]->length);
+
+	(*outstanding)++;
+
+	return (PyObject *) b;
+}
+
+static void batch_dealloc(BatchObject *b)
+{
+	villas::node::sample_decref_many(b->smps, b->cnt);
+	delete[] b->smps;
+
+	(*b->outstanding)--;
+	Py_DECREF(b->owner);
+
+	PyObject_Del(b);
+}
+
+/** Get the distance between consecutive samples if all samples of the batch are evenly spaced. */
+static bool batch_stride(BatchObject *b, npy_intp *stride)
+{
+	if (b->cnt < 2) {
+		*stride = 0;
+		return true;
+	}
+
+	*stride = (char *) b->smps[1] - (char *) b->smps[0];
+
+	for (unsigned i = 2; i < b->cnt; i++) {
+		if ((char *) b->smps[i] - (char *) b->smps[0] != *stride * (npy_intp) i)
+			return false;
+	}
+
+	return true;
+}
+
+/** Offset of a sample member in bytes. */
+#define SAMPLE_OFFSET(smp, member) ((char *) &(smp)->member - (char *) (smp))
+
+/** Return a (cnt, inner) array of a sample member which starts \p off bytes into each sample.
+ *
+ * The array is a read-only view into the samples if they are evenly spaced.
+ * Otherwise the member is copied into a new array.
+ */
+static PyObject * batch_member(BatchObject *b, size_t off, npy_intp inner, int typenum, size_t itemsize)
+{
+	npy_intp stride;
+	npy_intp dims[] = { b->cnt, inner };
+	int nd = inner > 0 ? 2 : 1;
+	PyObject *arr;
+
+	if (b->cnt > 0 && batch_stride(b, &stride)) {
+		npy_intp strides[] = { stride, (npy_intp) itemsize };
+
+		arr = PyArray_New(&PyArray_Type, nd, dims, typenum, strides,
+			(char *) b->smps[0] + off, itemsize, NPY_ARRAY_ALIGNED, nullptr);
+		if (!arr)
+			return nullptr;
+
+		Py_INCREF(b);
+		if (PyArray_SetBaseObject((PyArrayObject *) arr, (PyObject *) b)) {
+			Py_DECREF(arr);
+			return nullptr;
+		}
+
+		return arr;
+	}
+
+	arr = PyArray_SimpleNew(nd, dims, typenum);
+	if (!arr)
+		return nullptr;
+
+	size_t rowsz = itemsize * (inner > 0 ? inner : 1);
+	auto *dst = (char *) PyArray_DATA((PyArrayObject *) arr);
+
+	for (unsigned i = 0; i < b->cnt; i++)
+		memcpy(dst + i * rowsz, (char *) b->smps[i] + off, rowsz);
+
+	return arr;
+}
+
+static PyObject * batch_get_values(BatchObject *b, void *)
+{
+	npy_intp dims[] = { b->cnt, b->len };
+
+	if (b->cnt == 0)
+		return PyArray_SimpleNew(2, dims, NPY_DOUBLE);
+
+	bool uniform = true;
+	for (unsigned i = 0; i < b->cnt; i++) {
+		if (b->smps[i]->length != b->len) {
+			uniform = false;
+			break;
+		}
+	}
+
+	if (uniform)
+		return batch_member(b, SAMPLE_OFFSET(b->smps[0], data), b->len, NPY_DOUBLE, sizeof(double));
+
+	/* Shorter samples are padded with NaN */
+	PyObject *arr = PyArray_SimpleNew(2, dims, NPY_DOUBLE);
+	if (!arr)
+		return nullptr;
+
+	sample_unpack_many((vsample **) b->smps, b->cnt, nullptr, nullptr, nullptr, nullptr, nullptr, b->len,
+		(double *) PyArray_DATA((PyArrayObject *) arr));
+
+	return arr;
+}
+
+static PyObject * batch_get_sequence(BatchObject *b, void *)
+{
+	npy_intp dims[] = { 0 };
+
+	if (b->cnt == 0)
+		return PyArray_SimpleNew(1, dims, NPY_UINT64);
+
+	return batch_member(b, SAMPLE_OFFSET(b->smps[0], sequence), 0, NPY_UINT64, sizeof(uint64_t));
+}
+
+static PyObject * batch_get_ts(BatchObject *b, void *closure)
+{
+	npy_intp dims[] = { 0, 2 };
+
+	if (b->cnt == 0)
+		return PyArray_SimpleNew(2, dims, NPY_INT64);
+
+	size_t off = closure
+		? SAMPLE_OFFSET(b->smps[0], ts.received)
+		: SAMPLE_OFFSET(b->smps[0], ts.origin);
+
+	return batch_member(b, off, 2, NPY_INT64, sizeof(npy_int64));
+}
+
+static PyObject * batch_get_flags(BatchObject *b, void *)
+{
+	npy_intp dims[] = { 0 };
+
+	if (b->cnt == 0)
+		return PyArray_SimpleNew(1, dims, NPY_INT);
+
+	return batch_member(b, SAMPLE_OFFSET(b->smps[0], flags), 0, NPY_INT, sizeof(int));
+}
+
+static PyObject * batch_get_length(BatchObject *b, void *)
+{
+	npy_intp dims[] = { 0 };
+
+	if (b->cnt == 0)
+		return PyArray_SimpleNew(1, dims, NPY_UINT);
+
+	return batch_member(b, SAMPLE_OFFSET(b->smps[0], length), 0, NPY_UINT, sizeof(unsigned));
+}
+
+static Py_ssize_t batch_len(BatchObject *b)
+{
+	return b->cnt;
+}
+
+static PyGetSetDef batch_getset[] = {
+	{ "values", (getter) batch_get_values, nullptr, "Sample values as a (n, len) float64 matrix", nullptr },
+	{ "sequence", (getter) batch_get_sequence, nullptr, "Sequence numbers as a (n,) uint64 array", nullptr },
+	{ "ts_origin", (getter) batch_get_ts, nullptr, "Origin timestamps as a (n, 2) int64 array of seconds and nanoseconds", nullptr },
+	{ "ts_received", (getter) batch_get_ts, nullptr, "Receive timestamps as a (n, 2) int64 array of seconds and nanoseconds", (void *) 1 },
+	{ "flags", (getter) batch_get_flags, nullptr, "Sample flags as a (n,) int array", nullptr },
+	{ "length", (getter) batch_get_length, nullptr, "Number of valid values per sample as a (n,) array", nullptr },
+	{ nullptr }
+};
+
+static PySequenceMethods batch_as_sequence = {
+	(lenfunc) batch_len
+};
+
+/* Packing of NumPy arrays into samples */
+
+/** The converted arguments of a write() call. */
+struct WriteArgs {
+	PyArrayObject *values;
+	PyArrayObject *sequence;
+	PyArrayObject *ts_origin;
+};
+
+static void write_args_release(struct WriteArgs *wa)
+{
+	Py_XDECREF(wa->ts_origin);
+	Py_XDECREF(wa->sequence);
+	Py_XDECREF(wa->values);
+}
+
+/** Convert and validate the arguments of a write() call.
+ *
+ * @param capacity The maximum number of values per sample.
+ */
+static int write_args_parse(struct WriteArgs *wa, PyObject *args, PyObject *kwds, unsigned capacity)
+{
+	static const char *kwlist[] = { "values", "sequence", "ts_origin", nullptr };
+
+	PyObject *values, *seq = Py_None, *ts = Py_None;
+
+	*wa = { nullptr, nullptr, nullptr };
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|OO", (char **) kwlist, &values, &seq, &ts))
+		return -1;
+
+	wa->values = (PyArrayObject *) PyArray_FROMANY(values, NPY_DOUBLE, 2, 2, NPY_ARRAY_IN_ARRAY);
+	if (!wa->values)
+		goto err;
+
+	/* sample_pack_many() would silently truncate longer rows */
+	if (PyArray_DIM(wa->values, 1) > (npy_intp) capacity) {
+		PyErr_Format(PyExc_ValueError, "values must have at most %u columns", capacity);
+		goto err;
+	}
+
+	if (seq != Py_None) {
+		wa->sequence = (PyArrayObject *) PyArray_FROMANY(seq, NPY_UINT64, 1, 1, NPY_ARRAY_IN_ARRAY);
+		if (!wa->sequence)
+			goto err;
+
+		if (PyArray_DIM(wa->sequence, 0) != PyArray_DIM(wa->values, 0)) {
+			PyErr_SetString(PyExc_ValueError, "sequence must have one entry per row of values");
+			goto err;
+		}
+	}
+
+	if (ts != Py_None) {
+		wa->ts_origin = (PyArrayObject *) PyArray_FROMANY(ts, NPY_INT64, 2, 2, NPY_ARRAY_IN_ARRAY);
+		if (!wa->ts_origin)
+			goto err;
+
+		if (PyArray_DIM(wa->ts_origin, 0) != PyArray_DIM(wa->values, 0) || PyArray_DIM(wa->ts_origin, 1) != 2) {
+			PyErr_SetString(PyExc_ValueError, "ts_origin must be a (n, 2) array of seconds and nanoseconds");
+			goto err;
+		}
+	}
+
+	return 0;
+
+err:	write_args_release(wa);
+
+	return -1;
+}
+
+static unsigned write_args_rows(const struct WriteArgs *wa)
+{
+	return PyArray_DIM(wa->values, 0);
+}
+
+/** Fill the samples with the first \p cnt rows of the write() arguments.
+ *
+ * Without explicit sequence numbers and timestamps, samples are numbered
+ * consecutively and stamped with the current time.
+ */
+static int write_args_pack(const struct WriteArgs *wa, uint64_t *sequence, Sample **smps, unsigned cnt)
+{
+	uint64_t seqs[cnt];
+	struct timespec now[cnt];
+	auto *seq = wa->sequence ? (uint64_t *) PyArray_DATA(wa->sequence) : seqs;
+	auto *ts = wa->ts_origin ? (struct timespec *) PyArray_DATA(wa->ts_origin) : now;
+
+	if (cnt == 0)
+		return 0;
+
+	if (wa->sequence)
+		*sequence = seq[cnt - 1] + 1;
+	else {
+		for (unsigned i = 0; i < cnt; i++)
+			seqs[i] = (*sequence)++;
+	}
+
+	if (!wa->ts_origin) {
+		clock_gettime(CLOCK_REALTIME, &now[0]);
+		for (unsigned i = 1; i < cnt; i++)
+			now[i] = now[0];
+	}
+
+	return sample_pack_many((vsample **) smps, cnt, seq, ts, nullptr, nullptr,
+		PyArray_DIM(wa->values, 1), (double *) PyArray_DATA(wa->values));
+}
+
+static int parse_count(PyObject *args, unsigned *cnt)
+{
+	if (!PyArg_ParseTuple(args, "I", cnt))
+		return -1;
+
+	if (*cnt == 0) {
+		PyErr_SetString(PyExc_ValueError, "Count must be positive");
+		return -1;
+	}
+
+	return 0;
+}
+
+static int check_status(int ret, const char *what)
+{
+	if (ret) {
+		PyErr_Format(PyExc_RuntimeError, "Failed to %s node: %d", what, ret);
+		return -1;
+	}
+
+	return 0;
+}
+
+/* Node */
+
+static int node_init(NodeObject *self, PyObject *args, PyObject *kwds)
+{
+	static const char *kwlist[] = { "config", "uuid", "pool_size", "sample_length", nullptr };
+
+	PyObject *config, *json_str = nullptr;
+	const char *uuid_str = nullptr;
+	char uuid_buf[37];
+
+	self->pool_size = 1024;
+	self->sample_length = DEFAULT_SAMPLE_LENGTH;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|zII", (char **) kwlist,
+		&config, &uuid_str, &self->pool_size, &self->sample_length))
+		return -1;
+
+	if (PyUnicode_Check(config)) {
+		Py_INCREF(config);
+		json_str = config;
+	}
+	else {
+		PyObject *json = PyImport_ImportModule("json");
+		if (!json)
+			return -1;
+
+		json_str = PyObject_CallMethod(json, "dumps", "O", config);
+		Py_DECREF(json);
+		if (!json_str)
+			return -1;
+	}
+
+	if (!uuid_str) {
+		uuid_t uuid;
+
+		uuid_generate(uuid);
+		uuid_unparse(uuid, uuid_buf);
+		uuid_str = uuid_buf;
+	}
+
+	try {
+		self->node = node_new(PyUnicode_AsUTF8(json_str), uuid_str);
+	} catch (std::exception &e) {
+		PyErr_SetString(PyExc_RuntimeError, e.what());
+		self->node = nullptr;
+	}
+
+	Py_DECREF(json_str);
+
+	if (!self->node) {
+		if (!PyErr_Occurred())
+			PyErr_SetString(PyExc_RuntimeError, "Failed to create node");
+		return -1;
+	}
+
+	self->pool = pool_new(self->pool_size, self->sample_length);
+	if (!self->pool) {
+		PyErr_NoMemory();
+		return -1;
+	}
+
+	return 0;
+}
+
+static void node_dealloc(NodeObject *self)
+{
+	/* Batches keep a reference to us, so all samples have been returned by now.
+	 * The node itself might still hold references to samples until it is destroyed. */
+	if (self->node)
+		node_destroy(self->node);
+
+	if (self->pool)
+		pool_delete(self->pool);
+
+	Py_TYPE(self)->tp_free((PyObject *) self);
+}
+
+static bool node_valid(NodeObject *self)
+{
+	if (!self->node) {
+		PyErr_SetString(PyExc_ValueError, "Node is not initialized");
+		return false;
+	}
+
+	return true;
+}
+
+#define NODE_METHOD(verb) \
+static PyObject * node_py_##verb(NodeObject *self, PyObject *) \
+{ \
+	int ret; \
+	\
+	if (!node_valid(self)) \
+		return nullptr; \
+	\
+	try { \
+		ret = node_##verb(self->node); \
+	} catch (std::exception &e) { \
+		PyErr_SetString(PyExc_RuntimeError, e.what()); \
+		return nullptr; \
+	} \
+	\
+	if (check_status(ret, #verb)) \
+		return nullptr; \
+	\
+	Py_RETURN_NONE; \
+}
+
+NODE_METHOD(check)
+NODE_METHOD(prepare)
+NODE_METHOD(start)
+NODE_METHOD(stop)
+NODE_METHOD(pause)
+NODE_METHOD(resume)
+NODE_METHOD(restart)
+NODE_METHOD(reverse)
+
+/** Call into the node while the GIL is released.
+ *
+ * Exceptions must not propagate into the interpreter. Their message is stored
+ * in \p error and \p ret is set to -1 so that it can be raised once the GIL
+ * has been acquired again.
+ */
+#define NODE_CALL_NOGIL(ret, call, error) \
+	try { \
+		ret = call; \
+	} catch (std::exception &e) { \
+		error = e.what(); \
+		if (error.empty()) \
+			error = "Unknown error"; \
+		ret = -1; \
+	}
+
+static PyObject * node_py_read(NodeObject *self, PyObject *args)
+{
+	int allocated, ret;
+	unsigned cnt;
+
+	if (!node_valid(self) || parse_count(args, &cnt))
+		return nullptr;
+
+	auto **smps = new Sample*[cnt];
+
+	allocated = sample_alloc_many(self->pool, (vsample **) smps, cnt);
+	if (allocated <= 0) {
+		delete[] smps;
+		PyErr_SetString(PyExc_MemoryError, "Sample pool is depleted");
+		return nullptr;
+	}
+
+	std::string error;
+
+	Py_BEGIN_ALLOW_THREADS
+	NODE_CALL_NOGIL(ret, node_read(self->node, (vsample **) smps, allocated), error);
+	Py_END_ALLOW_THREADS
+
+	if (ret < 0) {
+		sample_decref_many((vsample **) smps, allocated);
+		delete[] smps;
+
+		if (!error.empty())
+			PyErr_SetString(PyExc_RuntimeError, error.c_str());
+		else
+			PyErr_Format(PyExc_RuntimeError, "Failed to read from node: %d", ret);
+
+		return nullptr;
+	}
+
+	/* Return unused samples to the pool right away */
+	sample_decref_many((vsample **) smps + ret, allocated - ret);
+
+	PyObject *b = batch_new((PyObject *) self, &self->batches, smps, ret);
+	if (!b) {
+		sample_decref_many((vsample **) smps, ret);
+		delete[] smps;
+	}
+
+	return b;
+}
+
+static PyObject * node_py_write(NodeObject *self, PyObject *args, PyObject *kwds)
+{
+	struct WriteArgs wa;
+	int allocated, packed, ret;
+
+	if (!node_valid(self) || write_args_parse(&wa, args, kwds, self->sample_length))
+		return nullptr;
+
+	unsigned cnt = std::min(write_args_rows(&wa), self->pool_size);
+	if (cnt == 0) {
+		write_args_release(&wa);
+		return PyLong_FromLong(0);
+	}
+
+	Sample *smps[cnt];
+
+	allocated = sample_alloc_many(self->pool, (vsample **) smps, cnt);
+	if (allocated <= 0) {
+		write_args_release(&wa);
+		PyErr_SetString(PyExc_MemoryError, "Sample pool is depleted");
+		return nullptr;
+	}
+
+	packed = write_args_pack(&wa, &self->sequence, smps, allocated);
+
+	std::string error;
+
+	Py_BEGIN_ALLOW_THREADS
+	NODE_CALL_NOGIL(ret, node_write(self->node, (vsample **) smps, packed), error);
+	Py_END_ALLOW_THREADS
+
+	sample_decref_many((vsample **) smps, allocated);
+	write_args_release(&wa);
+
+	if (ret < 0) {
+		if (!error.empty())
+			PyErr_SetString(PyExc_RuntimeError, error.c_str());
+		else
+			PyErr_Format(PyExc_RuntimeError, "Failed to write to node: %d", ret);
+
+		return nullptr;
+	}
+
+	return PyLong_FromLong(ret);
+}
+
+static PyObject * node_py_close(NodeObject *self, PyObject *)
+{
+	if (self->batches > 0) {
+		PyErr_SetString(PyExc_RuntimeError, "Can not close node while batches are still referenced");
+		return nullptr;
+	}
+
+	if (self->node) {
+		node_destroy(self->node);
+		self->node = nullptr;
+	}
+
+	if (self->pool) {
+		pool_delete(self->pool);
+		self->pool = nullptr;
+	}
+
+	Py_RETURN_NONE;
+}
+
+static PyObject * node_get_name(NodeObject *self, void *)
+{
+	if (!node_valid(self))
+		return nullptr;
+
+	return PyUnicode_FromString(node_name(self->node));
+}
+
+static PyObject * node_get_input_signals(NodeObject *self, void *)
+{
+	if (!node_valid(self))
+		return nullptr;
+
+	return PyLong_FromUnsignedLong(node_input_signals_max_cnt(self->node));
+}
+
+static PyObject * node_get_output_signals(NodeObject *self, void *)
+{
+	if (!node_valid(self))
+		return nullptr;
+
+	return PyLong_FromUnsignedLong(node_output_signals_max_cnt(self->node));
+}
+
+static PyMethodDef node_methods[] = {
+	{ "check", (PyCFunction) node_py_check, METH_NOARGS, "Check the node configuration" },
+	{ "prepare", (PyCFunction) node_py_prepare, METH_NOARGS, "Prepare the node" },
+	{ "start", (PyCFunction) node_py_start, METH_NOARGS, "Start the node" },
+	{ "stop", (PyCFunction) node_py_stop, METH_NOARGS, "Stop the node" },
+	{ "pause", (PyCFunction) node_py_pause, METH_NOARGS, "Pause the node" },
+	{ "resume", (PyCFunction) node_py_resume, METH_NOARGS, "Resume the node" },
+	{ "restart", (PyCFunction) node_py_restart, METH_NOARGS, "Restart the node" },
+	{ "reverse", (PyCFunction) node_py_reverse, METH_NOARGS, "Swap the input and output direction of the node" },
+	{ "read", (PyCFunction) node_py_read, METH_VARARGS, "read(cnt) -> Batch\n\nRead up to cnt samples from the node" },
+	{ "write", (PyCFunction)(void(*)(void)) node_py_write, METH_VARARGS | METH_KEYWORDS,
+		"write(values, sequence=None, ts_origin=None) -> int\n\nWrite the rows of a (n, len) matrix as samples to the node" },
+	{ "close", (PyCFunction) node_py_close, METH_NOARGS, "Destroy the node and release its sample pool" },
+	{ nullptr }
+};
+
+static PyGetSetDef node_getset[] = {
+	{ "name", (getter) node_get_name, nullptr, "Name of the node", nullptr },
+	{ "input_signals", (getter) node_get_input_signals, nullptr, "Maximum number of input signals", nullptr },
+	{ "output_signals", (getter) node_get_output_signals, nullptr, "Maximum number of output signals", nullptr },
+	{ nullptr }
+};
+
+/* Shmem */
+
+static int shmem_init(ShmemObject *self, PyObject *args, PyObject *kwds)
+{
+	static const char *kwlist[] = { "wname", "rname", "queuelen", "samplelen", "polling", nullptr };
+
+	const char *wname, *rname;
+	int ret, polling = 0;
+	struct villas::node::ShmemConfig conf = {
+		.polling = 0,
+		.queuelen = DEFAULT_SHMEM_QUEUELEN,
+		.samplelen = DEFAULT_SHMEM_SAMPLELEN
+	};
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "ss|iip", (char **) kwlist,
+		&wname, &rname, &conf.queuelen, &conf.samplelen, &polling))
+		return -1;
+
+	conf.polling = polling;
+	self->queuelen = conf.queuelen;
+	self->samplelen = conf.samplelen;
+
+	/* The names must outlive the interface */
+	wname = strdup(wname);
+	rname = strdup(rname);
+
+	/* Blocks until the other process has opened the interface as well */
+	Py_BEGIN_ALLOW_THREADS
+	errno = 0;
+	ret = villas::node::shmem_int_open(wname, rname, &self->shm, &conf);
+	Py_END_ALLOW_THREADS
+
+	if (ret < 0) {
+		free((void *) wname);
+		free((void *) rname);
+
+		if (errno)
+			PyErr_SetFromErrno(PyExc_OSError);
+		else
+			PyErr_Format(PyExc_RuntimeError, "Failed to open shared memory interface: %d", ret);
+
+		return -1;
+	}
+
+	self->opened = true;
+
+	return 0;
+}
+
+static int shmem_close(ShmemObject *self)
+{
+	int ret;
+
+	if (!self->opened)
+		return 0;
+
+	ret = villas::node::shmem_int_close(&self->shm);
+
+	free((void *) self->shm.read.name);
+	free((void *) self->shm.write.name);
+
+	self->opened = false;
+
+	return ret;
+}
+
+static void shmem_dealloc(ShmemObject *self)
+{
+	shmem_close(self);
+
+	Py_TYPE(self)->tp_free((PyObject *) self);
+}
+
+static bool shmem_valid(ShmemObject *self)
+{
+	if (!self->opened) {
+		PyErr_SetString(PyExc_ValueError, "Shared memory interface is closed");
+		return false;
+	}
+
+	return true;
+}
+
+static PyObject * shmem_py_read(ShmemObject *self, PyObject *args)
+{
+	int ret;
+	unsigned cnt;
+
+	if (!shmem_valid(self) || parse_count(args, &cnt))
+		return nullptr;
+
+	auto **smps = new Sample*[cnt];
+
+	Py_BEGIN_ALLOW_THREADS
+	ret = villas::node::shmem_int_read(&self->shm, smps, cnt);
+	Py_END_ALLOW_THREADS
+
+	if (ret < 0) {
+		delete[] smps;
+		Py_RETURN_NONE;
+	}
+
+	PyObject *b = batch_new((PyObject *) self, &self->batches, smps, ret);
+	if (!b) {
+		villas::node::sample_decref_many(smps, ret);
+		delete[] smps;
+	}
+
+	return b;
+}
+
+static PyObject * shmem_py_write(ShmemObject *self, PyObject *args, PyObject *kwds)
+{
+	struct WriteArgs wa;
+	int allocated, packed, ret;
+
+	if (!shmem_valid(self) || write_args_parse(&wa, args, kwds, self->samplelen))
+		return nullptr;
+
+	unsigned cnt = std::min(write_args_rows(&wa), self->queuelen);
+	if (cnt == 0) {
+		write_args_release(&wa);
+		return PyLong_FromLong(0);
+	}
+
+	Sample *smps[cnt];
+
+	allocated = villas::node::shmem_int_alloc(&self->shm, smps, cnt);
+	if (allocated <= 0) {
+		write_args_release(&wa);
+		PyErr_SetString(PyExc_MemoryError, "Shared memory pool is depleted");
+		return nullptr;
+	}
+
+	packed = write_args_pack(&wa, &self->sequence, smps, allocated);
+	write_args_release(&wa);
+
+	/* Ownership of written samples passes to the reading process */
+	Py_BEGIN_ALLOW_THREADS
+	ret = villas::node::shmem_int_write(&self->shm, smps, packed);
+	Py_END_ALLOW_THREADS
+
+	if (ret < 0) {
+		villas::node::sample_decref_many(smps, allocated);
+		PyErr_SetString(PyExc_BrokenPipeError, "Shared memory interface has been closed");
+		return nullptr;
+	}
+
+	villas::node::sample_decref_many(smps + ret, allocated - ret);
+
+	return PyLong_FromLong(ret);
+}
+
+static PyObject * shmem_py_close(ShmemObject *self, PyObject *)
+{
+	if (self->batches > 0) {
+		PyErr_SetString(PyExc_RuntimeError, "Can not close shared memory interface while batches are still referenced");
+		return nullptr;
+	}
+
+	if (shmem_close(self)) {
+		PyErr_SetString(PyExc_RuntimeError, "Failed to close shared memory interface");
+		return nullptr;
+	}
+
+	Py_RETURN_NONE;
+}
+
+static PyMethodDef shmem_methods[] = {
+	{ "read", (PyCFunction) shmem_py_read, METH_VARARGS,
+		"read(cnt) -> Batch\n\nRead up to cnt samples. Returns None once the other process has closed the interface" },
+	{ "write", (PyCFunction)(void(*)(void)) shmem_py_write, METH_VARARGS | METH_KEYWORDS,
+		"write(values, sequence=None, ts_origin=None) -> int\n\nWrite the rows of a (n, len) matrix as samples to the interface" },
+	{ "close", (PyCFunction) shmem_py_close, METH_NOARGS, "Close the shared memory interface" },
+	{ nullptr }
+};
+
+/* Module */
+
+static PyObject * py_memory_init(PyObject *, PyObject *args)
+{
+	int hugepages = 0;
+
+	if (!PyArg_ParseTuple(args, "|i", &hugepages))
+		return nullptr;
+
+	if (memory_init(hugepages)) {
+		PyErr_SetString(PyExc_RuntimeError, "Failed to initialize memory");
+		return nullptr;
+	}
+
+	Py_RETURN_NONE;
+}
+
+static PyMethodDef module_methods[] = {
+	{ "memory_init", py_memory_init, METH_VARARGS, "memory_init(hugepages=0)\n\nInitialize the memory subsystem of libvillas" },
+	{ nullptr }
+};
+
+static struct PyModuleDef module = {
+	PyModuleDef_HEAD_INIT,
+	"villas.node.binding",
+	"NumPy binding for the VILLASnode C-API and shared memory interface",
+	-1,
+	module_methods
+};
+
+PyMODINIT_FUNC PyInit_binding()
+{
+	import_array();
+
+	BatchType.tp_name = "villas.node.binding.Batch";
+	BatchType.tp_doc = "A batch of samples which are exposed as NumPy arrays";
+	BatchType.tp_basicsize = sizeof(BatchObject);
+	BatchType.tp_flags = Py_TPFLAGS_DEFAULT;
+	BatchType.tp_dealloc = (destructor) batch_dealloc;
+	BatchType.tp_getset = batch_getset;
+	BatchType.tp_as_sequence = &batch_as_sequence;
+
+	NodeType.tp_name = "villas.node.binding.Node";
+	NodeType.tp_doc = "A VILLASnode node instance";
+	NodeType.tp_basicsize = sizeof(NodeObject);
+	NodeType.tp_flags = Py_TPFLAGS_DEFAULT;
+	NodeType.tp_new = PyType_GenericNew;
+	NodeType.tp_init = (initproc) node_init;
+	NodeType.tp_dealloc = (destructor) node_dealloc;
+	NodeType.tp_methods = node_methods;
+	NodeType.tp_getset = node_getset;
+
+	ShmemType.tp_name = "villas.node.binding.Shmem";
+	ShmemType.tp_doc = "A connection to a VILLASnode shmem node";
+	ShmemType.tp_basicsize = sizeof(ShmemObject);
+	ShmemType.tp_flags = Py_TPFLAGS_DEFAULT;
+	ShmemType.tp_new = PyType_GenericNew;
+	ShmemType.tp_init = (initproc) shmem_init;
+	ShmemType.tp_dealloc = (destructor) shmem_dealloc;
+	ShmemType.tp_methods = shmem_methods;
+
+	if (PyType_Ready(&BatchType) < 0 ||
+	    PyType_Ready(&NodeType) < 0 ||
+	    PyType_Ready(&ShmemType) < 0)
+		return nullptr;
+
+	PyObject *m = PyModule_Create(&module);
+	if (!m)
+		return nullptr;
+
+	Py_INCREF(&BatchType);
+	Py_INCREF(&NodeType);
+	Py_INCREF(&ShmemType);
+
+	PyModule_AddObject(m, "Batch", (PyObject *) &BatchType);
+	PyModule_AddObject(m, "Node", (PyObject *) &NodeType);
+	PyModule_AddObject(m, "Shmem", (PyObject *) &ShmemType);
+
+	return m;
+}
@@ -6,6 +6,7 @@
  *********************************************************************************/
 
 #include <cstdlib>
+#include <csignal>
 #include <unistd.h>
 
 #include <iomanip>
@@ -59,6 +60,15 @@ protected:
 	std::string uri;
 	bool showCapabilities = false;
 
+	static SuperNode *reloadTarget;
+
+	static
+	void reloadHandler(int)
+	{
+		if (reloadTarget)
+			reloadTarget->requestReload();
+	}
+
 	void handler(int signal, siginfo_t *sinfo, void *ctx)
 	{
 		switch (signal)  {
@@ -197,6 +207,18 @@ protected:
 		sn.check();
 		sn.prepare();
 		sn.start();
+
+		/* SIGHUP reloads the configuration file and only restarts what has changed */
+		struct sigaction sa_hup;
+		sa_hup.sa_handler = reloadHandler;
+		sa_hup.sa_flags = SA_RESTART;
+		sigemptyset(&sa_hup.sa_mask);
+
+		reloadTarget = &sn;
+
+		if (sigaction(SIGHUP, &sa_hup, nullptr))
+			logger->warn("Failed to install handler for SIGHUP. Reloading the configuration is only possible via the API");
+
 		sn.run();
 		sn.stop();
 
@@ -204,6 +226,8 @@ protected:
 	}
 };
 
+SuperNode * Node::reloadTarget = nullptr;
+
 } /* namespace tools */
 } /* namespace node */
 } /* namespace villas */
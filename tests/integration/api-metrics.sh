@@ -0,0 +1,68 @@
+#!/bin/bash
+#
+# Integration test for remote API
+#
+# @author Steffen Vogel <post@steffenvogel.de>
+# @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+# @license Apache 2.0
+##################################################################################
+
+set -e
+
+DIR=$(mktemp -d)
+pushd ${DIR}
+
+function finish {
+	popd
+	rm -rf ${DIR}
+}
+trap finish EXIT
+
+cat > config.json <<EOF
+{
+	"http": {
+		"port": 8080
+	},
+	"nodes": {
+		"testnode1": {
+			"type": "loopback"
+		},
+		"testnode2": {
+			"type": "signal",
+			"signal": "sine",
+			"values": 2,
+			"rate": 100
+		}
+	},
+	"paths": [
+		{
+			"in": "testnode2",
+			"out": "testnode1",
+			"hooks": [
+				{ "type": "print", "output": "/dev/null" }
+			]
+		}
+	]
+}
+EOF
+
+# Start VILLASnode instance with local config
+villas node config.json &
+
+# Wait for node to complete init
+sleep 1
+
+# Fetch metrics via API
+curl -s http://localhost:8080/api/v2/metrics > metrics.txt
+
+# Shutdown VILLASnode
+kill $!
+
+# Check that the exposition is complete and contains all families
+tail -n1 metrics.txt | grep -qx "# EOF"
+
+for FAMILY in villas_node_stats villas_pool_used villas_path_destination_queued villas_path_cpu_seconds villas_hook_busy_seconds; do
+	grep -q "^# TYPE ${FAMILY} " metrics.txt
+done
+
+grep -q '^villas_path_destination_queued{path="[^"]*",node="testnode1"} ' metrics.txt
@@ -0,0 +1,174 @@
+#!/bin/bash
+#
+# Integration test for the NumPy binding of the C-API
+#
+# @author Steffen Vogel <post@steffenvogel.de>
+# @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+# @license Apache 2.0
+##################################################################################
+
+set -e
+
+DIR=$(mktemp -d)
+pushd ${DIR}
+
+function finish {
+	popd
+	rm -rf ${DIR}
+}
+trap finish EXIT
+
+export PYTHONPATH=${BUILDDIR}/python:${SRCDIR}/python
+
+# The binding is only built if NumPy has been found
+if ! python3 -c "import villas.node.binding" 2> /dev/null; then
+	echo "NumPy binding is not available"
+	exit 99
+fi
+
+cat > test_binding.py << EOF
+import gc
+import sys
+import unittest
+
+import numpy as np
+
+from villas.node import binding
+
+SAMPLE_LENGTH = 8
+
+CONFIG = {
+	'name': 'lo',
+	'type': 'loopback',
+	'in': {
+		'signals': {
+			'count': SAMPLE_LENGTH,
+			'type': 'float'
+		}
+	}
+}
+
+
+class BindingTest(unittest.TestCase):
+
+	@classmethod
+	def setUpClass(cls):
+		binding.memory_init(0)
+
+	def setUp(self):
+		self.node = binding.Node(CONFIG, pool_size=64, sample_length=SAMPLE_LENGTH)
+		self.node.check()
+		self.node.prepare()
+		self.node.start()
+
+	def tearDown(self):
+		gc.collect()
+
+		self.node.stop()
+		self.node.close()
+
+	def test_round_trip(self):
+		values = np.arange(4 * 3, dtype=np.float64).reshape(4, 3)
+		sequence = np.array([10, 11, 12, 13], dtype=np.uint64)
+		ts_origin = np.array([[1, 2], [3, 4], [5, 6], [7, 8]], dtype=np.int64)
+
+		self.assertEqual(self.node.write(values, sequence, ts_origin), 4)
+
+		b = self.node.read(4)
+		self.assertEqual(len(b), 4)
+
+		np.testing.assert_array_equal(b.values, values)
+		np.testing.assert_array_equal(b.sequence, sequence)
+		np.testing.assert_array_equal(b.ts_origin, ts_origin)
+		np.testing.assert_array_equal(b.length, [3] * 4)
+
+	def test_sequence_default(self):
+		values = np.zeros((3, 2))
+
+		self.node.write(values)
+		self.node.write(values)
+
+		b = self.node.read(6)
+		np.testing.assert_array_equal(b.sequence, np.arange(6))
+
+	def test_dtype(self):
+		# Integers are converted to float64
+		self.node.write(np.array([[1, 2, 3]], dtype=np.int32))
+
+		b = self.node.read(1)
+		self.assertEqual(b.values.dtype, np.float64)
+		np.testing.assert_array_equal(b.values, [[1.0, 2.0, 3.0]])
+
+		with self.assertRaises((ValueError, TypeError)):
+			self.node.write(np.array([['a', 'b']]))
+
+	def test_shape(self):
+		# values must be a (n, len) matrix
+		with self.assertRaises(ValueError):
+			self.node.write(np.zeros(3))
+
+		with self.assertRaises(ValueError):
+			self.node.write(np.zeros((2, 2, 2)))
+
+		# Rows must fit into the samples of the pool
+		with self.assertRaises(ValueError):
+			self.node.write(np.zeros((1, SAMPLE_LENGTH + 1)))
+
+		with self.assertRaises(ValueError):
+			self.node.write(np.zeros((2, 2)), sequence=np.arange(3, dtype=np.uint64))
+
+		with self.assertRaises(ValueError):
+			self.node.write(np.zeros((2, 2)), ts_origin=np.zeros((2, 3), dtype=np.int64))
+
+		# Nothing has been written by the failed calls
+		self.node.write(np.zeros((1, SAMPLE_LENGTH)))
+		self.assertEqual(len(self.node.read(8)), 1)
+
+	def test_refcounts(self):
+		values = np.ones((2, 2))
+
+		refs_node = sys.getrefcount(self.node)
+		refs_values = sys.getrefcount(values)
+
+		self.node.write(values)
+
+		# write() does not keep references to its arguments
+		self.assertEqual(sys.getrefcount(values), refs_values)
+
+		b = self.node.read(2)
+
+		# A batch keeps its node alive
+		self.assertEqual(sys.getrefcount(self.node), refs_node + 1)
+
+		with self.assertRaises(RuntimeError):
+			self.node.close()
+
+		# Arrays which view the samples keep their batch alive
+		v = b.values
+		del b
+
+		if v.base is not None:
+			self.assertEqual(sys.getrefcount(self.node), refs_node + 1)
+
+		np.testing.assert_array_equal(v, values)
+
+		del v
+		gc.collect()
+
+		self.assertEqual(sys.getrefcount(self.node), refs_node)
+
+	def test_pool_reuse(self):
+		# Samples are returned to the pool once their batch is released
+		for _ in range(16):
+			self.node.write(np.zeros((32, 2)))
+
+			b = self.node.read(32)
+			self.assertEqual(len(b), 32)
+			del b
+
+
+if __name__ == '__main__':
+	unittest.main()
+EOF
+
+python3 test_binding.py -v
@@ -0,0 +1,131 @@
+/** Unit tests for the routing of API requests.
+ *
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include <criterion/criterion.h>
+
+#include <villas/plugin.hpp>
+#include <villas/api/request.hpp>
+#include <villas/api/router.hpp>
+
+using namespace villas;
+using namespace villas::node::api;
+
+#define UUID "0b3c4d5e-1234-5678-9abc-def012345678"
+
+/** URIs which are resolved by the route table and by the regular expressions of all request plugins. */
+static const char *uris[] = {
+	"/capabilities",
+	"/config",
+	"/graph.svg",
+	"/graph.",
+	"/metrics",
+	"/node/test_node",
+	"/node/" UUID,
+	"/node/test_node/file",
+	"/node/test_node/file/out.csv",
+	"/node/test_node/file/",
+	"/node/test_node/hooks",
+	"/node/" UUID "/hooks",
+	"/node/test_node/stats",
+	"/node/" UUID "/stats/reset",
+	"/node/test_node/start",
+	"/node/test_node/stop",
+	"/node/" UUID "/pause",
+	"/node/" UUID "/resume",
+	"/node/test_node/restart",
+	"/nodes",
+	"/path/" UUID,
+	"/path/" UUID "/hooks",
+	"/path/" UUID "/start",
+	"/path/" UUID "/stop",
+	"/path/test_node",
+	"/paths",
+	"/reload",
+	"/restart",
+	"/shutdown",
+	"/status",
+	"/universal/test_node/channel/ch_1/sample",
+	"/universal/test_node/channel/ch_1/event",
+	"/universal/test_node/channel/CH/sample",
+	"/universal/test_node/channels",
+	"/universal/test_node/channels/sample",
+	"/universal/test_node/channels/event/subscribe",
+	"/universal/test_node/info",
+	"/universal/test_node/status",
+	/* Not matched by any request */
+	"",
+	"/",
+	"//status",
+	"/unknown",
+	"/nodes/",
+	"/status/extra",
+	"/node/a",
+	"/node/Test",
+	"/node/test_node/unknown",
+	"/node/test_node/stats/reset/"
+};
+
+/** Resolve an URI like RequestFactory::create() did before the route table was introduced. */
+static RequestFactory * lookup_sequential(const std::string &uri, std::vector<std::string> &matches)
+{
+	for (auto *rf : plugin::registry->lookup<RequestFactory>()) {
+		std::smatch mr;
+		if (not rf->match(uri, mr))
+			continue;
+
+		matches.clear();
+		for (auto m : mr)
+			matches.push_back(m.str());
+
+		return rf;
+	}
+
+	return nullptr;
+}
+
+// cppcheck-suppress unknownMacro
+Test(api_router, sequential)
+{
+	Router router;
+
+	auto factories = plugin::registry->lookup<RequestFactory>();
+	cr_assert_gt(factories.size(), 0);
+
+	for (auto *rf : factories)
+		router.add(rf->getPattern(), rf);
+
+	std::set<RequestFactory *> resolved;
+
+	for (auto *uri : uris) {
+		std::vector<std::string> expected, matches;
+
+		auto *rf_expected = lookup_sequential(uri, expected);
+		auto *rf = router.lookup(uri, matches);
+
+		cr_assert_eq(rf, rf_expected, "Request plugins differ for URI '%s': %s != %s", uri,
+			rf ? rf->getName().c_str() : "none",
+			rf_expected ? rf_expected->getName().c_str() : "none");
+
+		if (!rf)
+			continue;
+
+		cr_assert_eq(matches.size(), expected.size(), "Number of matches differs for URI '%s': %zu != %zu", uri, matches.size(), expected.size());
+
+		for (size_t i = 0; i < matches.size(); i++)
+			cr_assert_eq(matches[i], expected[i], "Match %zu differs for URI '%s': '%s' != '%s'", i, uri, matches[i].c_str(), expected[i].c_str());
+
+		resolved.insert(rf);
+	}
+
+	/* New request plugins must be added to the list of URIs above */
+	for (auto *rf : factories)
+		cr_assert(resolved.find(rf) != resolved.end(), "No URI is resolved to request plugin '%s' with pattern '%s'", rf->getName().c_str(), rf->getPattern().c_str());
+}
@@ -0,0 +1,90 @@
+/** Unit tests and benchmark for the calibrated TSC clock.
+ *
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+#include <cmath>
+
+#include <criterion/criterion.h>
+
+#include <villas/clock.hpp>
+#include <villas/log.hpp>
+#include <villas/timing.hpp>
+#include <villas/tsc.hpp>
+
+using namespace villas;
+using namespace villas::node;
+
+#define ITERATIONS	(1 << 20)
+
+// cppcheck-suppress unknownMacro
+Test(clock, system)
+{
+	int ret = clock_init(ClockSource::SYSTEM);
+	cr_assert_eq(ret, 0);
+	cr_assert_eq(clock_source(), ClockSource::SYSTEM);
+	cr_assert_eq(clock_tsc_frequency(), 0);
+
+	struct timespec before = time_now();
+	struct timespec now = clock_now();
+	struct timespec after = time_now();
+
+	cr_assert_geq(time_delta(&before, &now), 0);
+	cr_assert_geq(time_delta(&now, &after), 0);
+}
+
+Test(clock, tsc_accuracy)
+{
+	int ret = clock_init(ClockSource::TSC);
+	if (ret)
+		cr_skip_test("TSC is not invariant on this machine");
+
+	cr_assert_eq(clock_source(), ClockSource::TSC);
+	cr_assert_gt(clock_tsc_frequency(), 1e8);
+
+	/* Cross the recalibration interval a few times */
+	for (int i = 0; i < 30; i++) {
+		struct timespec ts = { 0, 100000000 };
+		nanosleep(&ts, nullptr);
+
+		struct timespec sys = time_now();
+		struct timespec tsc = clock_now();
+
+		double error = time_delta(&sys, &tsc);
+
+		cr_assert_lt(fabs(error), 50e-6, "Calibrated TSC deviates by %g s from CLOCK_REALTIME", error);
+	}
+}
+
+Test(clock, benchmark)
+{
+	struct Tsc tsc;
+	uint64_t start, sys, fast;
+
+	Logger logger = logging.get("test:clock");
+
+	int ret = tsc_init(&tsc);
+	cr_assert(!ret);
+
+	ret = clock_init(ClockSource::TSC);
+	if (ret)
+		cr_skip_test("TSC is not invariant on this machine");
+
+	start = tsc_now(&tsc);
+	for (int i = 0; i < ITERATIONS; i++) {
+		volatile struct timespec ts = time_now();
+		(void) ts;
+	}
+	sys = tsc_now(&tsc) - start;
+
+	start = tsc_now(&tsc);
+	for (int i = 0; i < ITERATIONS; i++) {
+		volatile struct timespec ts = clock_now();
+		(void) ts;
+	}
+	fast = tsc_now(&tsc) - start;
+
+	logger->info("Cycles per timestamp: system={}, tsc={}", sys / ITERATIONS, fast / ITERATIONS);
+}
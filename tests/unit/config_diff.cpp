@@ -0,0 +1,182 @@
+/** Unit tests for the comparison of configurations.
+ *
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+#include <criterion/criterion.h>
+
+#include <villas/config_diff.hpp>
+
+using namespace villas::node;
+
+using Change = ConfigDiff::Change;
+
+static const char *cfg_old = R"({
+	"stats": 1,
+	"nodes": {
+		"a": { "type": "loopback" },
+		"b": { "type": "loopback" },
+		"c": { "type": "loopback", "in": { "hooks": [ "print" ] } },
+		"d": { "type": "loopback" },
+		"f": { "type": "loopback" },
+		"g": { "type": "loopback" }
+	},
+	"paths": [
+		{ "in": "a", "out": "b" },
+		{ "in": "f", "out": "c" },
+		{ "in": "d", "out": "f" },
+		{ "in": [ "a.data[0-1]" ], "out": "g" },
+		{ "in": "g", "out": "a" }
+	]
+})";
+
+static const char *cfg_new = R"({
+	"stats": 1,
+	"nodes": {
+		"a": { "type": "loopback" },
+		"b": { "type": "socket" },
+		"c": { "type": "loopback", "in": { "hooks": [ "stats" ] } },
+		"f": { "type": "loopback" },
+		"g": { "type": "loopback" },
+		"h": { "type": "loopback" }
+	},
+	"paths": [
+		{ "in": "a", "out": "b" },
+		{ "in": "f", "out": "c" },
+		{ "in": "h", "out": "f" },
+		{ "in": [ "a.data[0-1]" ], "out": "g" },
+		{ "in": "g", "out": "a" }
+	]
+})";
+
+// cppcheck-suppress unknownMacro
+Test(config_diff, nodes_and_paths)
+{
+	json_t *json_old = json_loads(cfg_old, 0, nullptr);
+	json_t *json_new = json_loads(cfg_new, 0, nullptr);
+
+	cr_assert_not_null(json_old);
+	cr_assert_not_null(json_new);
+
+	ConfigDiff diff(json_old, json_new);
+
+	cr_assert_not(diff.global);
+	cr_assert_not(diff.isEmpty());
+
+	cr_assert_eq(diff.nodes["a"], Change::NONE);
+	cr_assert_eq(diff.nodes["b"], Change::CHANGED);
+	cr_assert_eq(diff.nodes["c"], Change::HOOKS);
+	cr_assert_eq(diff.nodes["d"], Change::REMOVED);
+	cr_assert_eq(diff.nodes["f"], Change::NONE);
+	cr_assert_eq(diff.nodes["g"], Change::NONE);
+	cr_assert_eq(diff.nodes["h"], Change::ADDED);
+
+	cr_assert(diff.isNodeStale("b"));
+	cr_assert(diff.isNodeStale("d"));
+	cr_assert_not(diff.isNodeStale("c"));
+	cr_assert(diff.isNodeFresh("h"));
+	cr_assert_not(diff.isNodeFresh("a"));
+
+	/* Path 1 keeps running while the hooks of node c are replaced.
+	 * Path 3 is unchanged but shares its source node with path 0 */
+	Change old_paths[] = { Change::RESTARTED, Change::NONE, Change::REMOVED, Change::RESTARTED, Change::NONE };
+	Change new_paths[] = { Change::RESTARTED, Change::NONE, Change::ADDED, Change::RESTARTED, Change::NONE };
+	int matches[] = { 0, 1, -1, 3, 4 };
+
+	cr_assert_eq(diff.oldPaths.size(), 5);
+	cr_assert_eq(diff.newPaths.size(), 5);
+
+	for (unsigned i = 0; i < 5; i++) {
+		cr_assert_eq(diff.oldPaths[i], old_paths[i], "Old path %u", i);
+		cr_assert_eq(diff.newPaths[i], new_paths[i], "New path %u", i);
+		cr_assert_eq(diff.pathMatches[i], matches[i], "Match of path %u", i);
+	}
+
+	json_t *json_diff = diff.toJson();
+	json_t *json_added = json_object_get(json_object_get(json_diff, "nodes"), "added");
+
+	cr_assert_eq(json_array_size(json_added), 1);
+	cr_assert_str_eq(json_string_value(json_array_get(json_added, 0)), "h");
+
+	json_decref(json_diff);
+	json_decref(json_old);
+	json_decref(json_new);
+}
+
+Test(config_diff, unchanged)
+{
+	json_t *json_old = json_loads(cfg_old, 0, nullptr);
+	json_t *json_new = json_deep_copy(json_old);
+
+	ConfigDiff diff(json_old, json_new);
+
+	cr_assert(diff.isEmpty());
+
+	/* Paths are matched regardless of their order */
+	json_t *json_paths = json_object_get(json_new, "paths");
+	json_t *json_first = json_incref(json_array_get(json_paths, 0));
+
+	json_array_remove(json_paths, 0);
+	json_array_append_new(json_paths, json_first);
+
+	ConfigDiff reordered(json_old, json_new);
+
+	cr_assert(reordered.isEmpty());
+	cr_assert_eq(reordered.pathMatches[0], 4);
+
+	/* Global settings require a full restart */
+	json_object_set_new(json_new, "stats", json_integer(2));
+
+	ConfigDiff global(json_old, json_new);
+
+	cr_assert(global.global);
+	cr_assert_not(global.isEmpty());
+
+	json_decref(json_old);
+	json_decref(json_new);
+}
+
+Test(config_diff, loopback_writers)
+{
+	json_t *json_old = json_loads(R"({
+		"nodes": {
+			"a": { "type": "loopback" },
+			"b": { "type": "loopback" },
+			"c": { "type": "loopback", "spsc": false }
+		},
+		"paths": [
+			{ "in": "a", "out": "b" },
+			{ "in": "a", "out": "c" }
+		]
+	})", 0, nullptr);
+	json_t *json_new = json_loads(R"({
+		"nodes": {
+			"a": { "type": "loopback" },
+			"b": { "type": "loopback" },
+			"c": { "type": "loopback", "spsc": false }
+		},
+		"paths": [
+			{ "in": "a", "out": "b" },
+			{ "in": "a", "out": "c" },
+			{ "in": "a", "out": [ "b", "c" ] }
+		]
+	})", 0, nullptr);
+
+	cr_assert_not_null(json_old);
+	cr_assert_not_null(json_new);
+
+	ConfigDiff diff(json_old, json_new);
+
+	/* The single-producer queue of b must be replaced */
+	cr_assert_eq(diff.nodes["a"], Change::NONE);
+	cr_assert_eq(diff.nodes["b"], Change::CHANGED);
+	cr_assert_eq(diff.nodes["c"], Change::NONE);
+
+	cr_assert_eq(diff.oldPaths[0], Change::RESTARTED);
+	cr_assert_eq(diff.newPaths[2], Change::ADDED);
+
+	json_decref(json_old);
+	json_decref(json_new);
+}
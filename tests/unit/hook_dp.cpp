@@ -0,0 +1,180 @@
+/** Unit tests for the dynamic phasor hook.
+ *
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+#include <cmath>
+#include <complex>
+#include <deque>
+#include <vector>
+
+#include <criterion/criterion.h>
+
+#include <villas/hook.hpp>
+#include <villas/plugin.hpp>
+#include <villas/sample.hpp>
+#include <villas/signal_list.hpp>
+#include <villas/utils.hpp>
+
+using namespace villas;
+using namespace villas::node;
+using namespace std::complex_literals;
+
+extern void init_memory();
+
+#define NUM_SAMPLES	1000
+#define NUM_SIGNALS	3
+
+static const int harmonics[] = { 0, 1, 3, 5, 7 };
+static const unsigned num_harmonics = ARRAY_LEN(harmonics);
+
+/** Reference implementation: full DFT over the window for every sample. */
+class DPReference {
+
+protected:
+	std::deque<double> window;
+	double steps;
+
+public:
+	DPReference(unsigned N) :
+		window(N, 0.0),
+		steps(0)
+	{ }
+
+	void step(double in, std::complex<float> *out)
+	{
+		int N = window.size();
+
+		window.push_back(in);
+		window.pop_front();
+
+		for (unsigned k = 0; k < num_harmonics; k++) {
+			std::complex<double> om_k = 2.0i * M_PI * (double) harmonics[k] / (double) N;
+			std::complex<double> corr = std::exp(-om_k * (steps - (N + 1)));
+			std::complex<double> X_k = 0;
+
+			for (int n = 0; n < N; n++)
+				X_k += window[n] * std::exp(om_k * (double) n);
+
+			out[k] = X_k / (corr * (double) N);
+		}
+
+		steps++;
+	}
+};
+
+static double signal_value(unsigned s, unsigned t, double dt)
+{
+	double phi = 2 * M_PI * s / NUM_SIGNALS;
+
+	return sin(2 * M_PI * 50 * t * dt + phi) + 0.2 * cos(2 * M_PI * 250 * t * dt + phi) + 0.1 * s;
+}
+
+static Hook::Ptr make_dp_hook(const char *cfg, SignalList::Ptr signals)
+{
+	auto hf = plugin::registry->lookup<HookFactory>("dp");
+	cr_assert_not_null(hf);
+
+	auto h = hf->make(nullptr, nullptr);
+
+	json_t *json = json_loads(cfg, 0, nullptr);
+	cr_assert_not_null(json);
+
+	h->parse(json);
+	h->check();
+	h->prepare(signals);
+	h->start();
+
+	return h;
+}
+
+// cppcheck-suppress unknownMacro
+Test(hook_dp, multi_signal, .init = init_memory) {
+	double dt = 1.0 / 2000;
+	unsigned N = (1.0 / 50) / dt;
+
+	auto signals = std::make_shared<SignalList>(NUM_SIGNALS + 1, SignalType::FLOAT);
+
+	auto h = make_dp_hook("{ \"type\": \"dp\", \"signals\": [ \"signal0\", \"signal2\", \"signal3\" ], \"f0\": 50, \"rate\": 2000, \"harmonics\": [ 0, 1, 3, 5, 7 ] }", signals);
+
+	auto out_signals = h->getSignals();
+	cr_assert_eq(out_signals->size(), 1 + NUM_SIGNALS * num_harmonics);
+	cr_assert_eq(out_signals->getByIndex(0)->type, SignalType::COMPLEX);
+	cr_assert_eq(out_signals->back()->name, "signal1");
+
+	std::vector<DPReference> refs(NUM_SIGNALS, DPReference(N));
+	unsigned inputs[] = { 0, 2, 3 };
+
+	struct Sample *smp = sample_alloc_mem(out_signals->size());
+	cr_assert_not_null(smp);
+
+	for (unsigned t = 0; t < NUM_SAMPLES; t++) {
+		smp->length = signals->size();
+		for (unsigned i = 0; i < signals->size(); i++)
+			smp->data[i].f = signal_value(i, t, dt);
+
+		auto ret = h->process(smp);
+		cr_assert_eq(ret, Hook::Reason::OK);
+		cr_assert_eq(smp->length, out_signals->size());
+
+		for (unsigned s = 0; s < NUM_SIGNALS; s++) {
+			std::complex<float> expected[num_harmonics];
+
+			refs[s].step(signal_value(inputs[s], t, dt), expected);
+
+			for (unsigned k = 0; k < num_harmonics; k++) {
+				auto actual = * (std::complex<float> *) &smp->data[s * num_harmonics + k].z;
+
+				cr_assert_float_eq(std::abs(actual - expected[k]), 0, 1e-5,
+					"Coefficient mismatch for signal %u, harmonic %d at step %u", s, harmonics[k], t);
+			}
+		}
+
+		/* The untouched signal is moved behind the coefficients */
+		cr_assert_float_eq(smp->data[NUM_SIGNALS * num_harmonics].f, signal_value(1, t, dt), 1e-9);
+	}
+
+	sample_free(smp);
+}
+
+Test(hook_dp, inverse, .init = init_memory) {
+	double dt = 1.0 / 2000;
+
+	auto signals = std::make_shared<SignalList>(num_harmonics, SignalType::COMPLEX);
+
+	auto h = make_dp_hook("{ \"type\": \"dp\", \"signal\": 0, \"f0\": 50, \"dt\": 0.0005, \"harmonics\": [ 0, 1, 3, 5, 7 ], \"inverse\": true }", signals);
+
+	auto out_signals = h->getSignals();
+	cr_assert_eq(out_signals->size(), 1);
+	cr_assert_eq(out_signals->getByIndex(0)->type, SignalType::FLOAT);
+
+	struct Sample *smp = sample_alloc_mem(num_harmonics);
+	cr_assert_not_null(smp);
+
+	double time = 0;
+	for (unsigned t = 0; t < NUM_SAMPLES; t++) {
+		std::complex<float> coeffs[num_harmonics];
+		std::complex<double> expected = 0;
+
+		for (unsigned k = 0; k < num_harmonics; k++) {
+			coeffs[k] = std::complex<float>(cos(0.1 * t + k), sin(0.01 * t * k));
+			expected += std::complex<double>(coeffs[k]) * std::exp(2.0i * M_PI * (double) harmonics[k] * time);
+		}
+
+		smp->length = num_harmonics;
+		memcpy(smp->data, coeffs, sizeof(coeffs));
+
+		auto ret = h->process(smp);
+		cr_assert_eq(ret, Hook::Reason::OK);
+		cr_assert_eq(smp->length, 1);
+
+		cr_assert_float_eq(smp->data[0].f, std::real(expected), 1e-9,
+			"Reconstructed signal mismatch at step %u: %f != %f", t, smp->data[0].f, std::real(expected));
+
+		time += dt;
+	}
+
+	sample_free(smp);
+}
@@ -0,0 +1,179 @@
+/** Unit tests for replacing hooks at runtime.
+ *
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include <criterion/criterion.h>
+
+#include <villas/hook.hpp>
+#include <villas/hook_list.hpp>
+#include <villas/sample.hpp>
+#include <villas/signal_list.hpp>
+#include <villas/exceptions.hpp>
+
+using namespace villas;
+using namespace villas::node;
+
+extern void init_memory();
+
+#define NUM_SIGNALS	2
+
+static double run(HookList &hooks, SignalList::Ptr signals, struct Sample *smp)
+{
+	smp->length = NUM_SIGNALS;
+	smp->signals = signals;
+	smp->data[0].f = 1.0;
+	smp->data[1].f = 1.0;
+
+	int ret = hooks.process(&smp, 1);
+	cr_assert_eq(ret, 1);
+
+	/* The second signal is never touched */
+	cr_assert_float_eq(smp->data[1].f, 1.0, 1e-9);
+
+	return smp->data[0].f;
+}
+
+// cppcheck-suppress unknownMacro
+Test(hook_list, replace, .init = init_memory)
+{
+	HookList hooks;
+	int mask = (int) Hook::Flags::PATH;
+
+	auto signals = std::make_shared<SignalList>(NUM_SIGNALS, SignalType::FLOAT);
+
+	json_t *json = json_loads("[ { \"type\": \"scale\", \"signals\": [ \"signal0\" ], \"scale\": 2 } ]", 0, nullptr);
+	cr_assert_not_null(json);
+
+	hooks.parse(json, mask, nullptr, nullptr);
+	hooks.check();
+	hooks.prepare(signals, 0, nullptr, nullptr);
+	hooks.start();
+
+	struct Sample *smp = sample_alloc_mem(NUM_SIGNALS);
+	cr_assert_not_null(smp);
+
+	cr_assert_float_eq(run(hooks, signals, smp), 2.0, 1e-9);
+
+	json_t *json_new = json_loads("[ { \"type\": \"scale\", \"signals\": [ \"signal0\" ], \"scale\": 3 } ]", 0, nullptr);
+	cr_assert_not_null(json_new);
+
+	hooks.replace(json_new, mask, signals, 0, nullptr, nullptr, true);
+
+	/* The new hooks keep their own copy of the configuration */
+	json_decref(json_new);
+
+	/* The configuration of the replacement is reported before it has been swapped in */
+	json_t *json_get = hooks.toJson();
+	cr_assert_eq(json_array_size(json_get), 1);
+	cr_assert_float_eq(json_number_value(json_object_get(json_array_get(json_get, 0), "scale")), 3.0, 1e-9);
+	json_decref(json_get);
+
+	/* The next batch is processed by the new hooks */
+	cr_assert_float_eq(run(hooks, signals, smp), 3.0, 1e-9);
+	cr_assert_eq(hooks.size(), 1);
+
+	hooks.collect();
+
+	/* Hooks which change the output signals are rejected */
+	json_t *json_cast = json_loads("[ { \"type\": \"cast\", \"signals\": [ \"signal0\" ], \"new_type\": \"integer\" } ]", 0, nullptr);
+	cr_assert_not_null(json_cast);
+
+	cr_assert_throw(hooks.replace(json_cast, mask, signals, 0, nullptr, nullptr, true), RuntimeError);
+
+	cr_assert_float_eq(run(hooks, signals, smp), 3.0, 1e-9);
+
+	/* Without hooks, samples pass unchanged */
+	json_t *json_empty = json_array();
+
+	hooks.replace(json_empty, mask, signals, 0, nullptr, nullptr, true);
+
+	cr_assert_float_eq(run(hooks, signals, smp), 1.0, 1e-9);
+	cr_assert_eq(hooks.size(), 0);
+
+	hooks.stop();
+
+	sample_free(smp);
+
+	json_decref(json_cast);
+	json_decref(json_empty);
+	json_decref(json);
+}
+
+Test(hook_list, concurrent, .init = init_memory)
+{
+	HookList hooks;
+	int mask = (int) Hook::Flags::PATH;
+
+	auto signals = std::make_shared<SignalList>(NUM_SIGNALS, SignalType::FLOAT);
+
+	const char *cfgs[] = {
+		"[ { \"type\": \"scale\", \"signals\": [ \"signal0\" ], \"scale\": 2 } ]",
+		"[ { \"type\": \"scale\", \"signals\": [ \"signal0\" ], \"scale\": 3 } ]"
+	};
+
+	json_t *json = json_loads(cfgs[0], 0, nullptr);
+	cr_assert_not_null(json);
+
+	hooks.parse(json, mask, nullptr, nullptr);
+	hooks.check();
+	hooks.prepare(signals, 0, nullptr, nullptr);
+	hooks.start();
+
+	std::atomic<bool> stop(false);
+	std::atomic<unsigned> errors(0);
+	std::vector<std::thread> threads;
+
+	/* Like the writer threads of several paths which send to the same node */
+	for (unsigned i = 0; i < 4; i++) {
+		threads.emplace_back([&]() {
+			struct Sample *smp = sample_alloc_mem(NUM_SIGNALS);
+
+			smp->length = NUM_SIGNALS;
+			smp->signals = signals;
+
+			while (!stop) {
+				smp->data[0].f = 1.0;
+
+				int ret = hooks.process(&smp, 1);
+				if (ret != 1 || (smp->data[0].f != 2.0 && smp->data[0].f != 3.0))
+					errors++;
+			}
+
+			sample_free(smp);
+		});
+	}
+
+	for (unsigned i = 0; i < 100; i++) {
+		json_t *json_new = json_loads(cfgs[i % 2], 0, nullptr);
+		cr_assert_not_null(json_new);
+
+		hooks.replace(json_new, mask, signals, 0, nullptr, nullptr, true);
+		json_decref(json_new);
+
+		usleep(1000);
+
+		/* Releases the replaced hooks while the threads keep processing */
+		hooks.collect();
+	}
+
+	stop = true;
+
+	for (auto &t : threads)
+		t.join();
+
+	cr_assert_eq(errors, 0, "%u samples have not been processed correctly", errors.load());
+
+	hooks.stop();
+	hooks.collect();
+
+	json_decref(json);
+}
@@ -0,0 +1,82 @@
+/** Unit tests and benchmark for hot-path logging.
+ *
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+#include <sstream>
+
+#include <criterion/criterion.h>
+
+#include <villas/log.hpp>
+#include <villas/tsc.hpp>
+#include <villas/node/log.hpp>
+
+using namespace villas;
+
+#define ITERATIONS	(1 << 16)
+
+static int evaluated;
+
+/** Mimics Path::toString() which is passed to many debug messages in the sample path */
+static std::string expensive()
+{
+	std::stringstream ss;
+
+	evaluated++;
+
+	ss << "path(";
+	for (int i = 0; i < 4; i++)
+		ss << "node" << i << " ";
+	ss << ")";
+
+	return ss.str();
+}
+
+// cppcheck-suppress unknownMacro
+Test(log, lazy_evaluation)
+{
+	Logger logger = logging.get("test:log");
+
+	logger->set_level(spdlog::level::info);
+
+	evaluated = 0;
+	VILLAS_LOG_DEBUG(logger, "Enqueued samples to {}", expensive());
+	cr_assert_eq(evaluated, 0, "Arguments of disabled log messages must not be evaluated");
+
+	VILLAS_LOG_WARN(logger, "Overrun in {}", expensive());
+	cr_assert_eq(evaluated, VILLAS_HOTPATH_LOG_LEVEL <= SPDLOG_LEVEL_WARN ? 1 : 0);
+}
+
+Test(log, hotpath_benchmark)
+{
+	struct Tsc tsc;
+	uint64_t start, eager, lazy;
+
+	Logger logger = logging.get("test:log");
+
+	logger->set_level(spdlog::level::info);
+
+	int ret = tsc_init(&tsc);
+	cr_assert(!ret);
+
+	evaluated = 0;
+	start = tsc_now(&tsc);
+	for (int i = 0; i < ITERATIONS; i++)
+		logger->debug("Enqueued {} samples to {}", i, expensive());
+	eager = tsc_now(&tsc) - start;
+
+	cr_assert_eq(evaluated, ITERATIONS);
+
+	evaluated = 0;
+	start = tsc_now(&tsc);
+	for (int i = 0; i < ITERATIONS; i++)
+		VILLAS_LOG_DEBUG(logger, "Enqueued {} samples to {}", i, expensive());
+	lazy = tsc_now(&tsc) - start;
+
+	/* Timings are only reported as they vary on loaded machines */
+	cr_assert_eq(evaluated, 0, "Arguments of disabled log messages must not be evaluated");
+
+	logger->info("Cycles per disabled debug message: eager={}, lazy={}", eager / ITERATIONS, lazy / ITERATIONS);
+}
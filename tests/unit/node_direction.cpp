@@ -0,0 +1,91 @@
+/** Unit tests for the adaptive vectorization of node directions.
+ *
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+#include <criterion/criterion.h>
+#include <uuid/uuid.h>
+
+#include <villas/node.hpp>
+#include <villas/node_direction.hpp>
+
+using namespace villas;
+using namespace villas::node;
+
+extern void init_memory();
+
+#define VECTORIZE	16
+
+static Node * make_node(double latency)
+{
+	uuid_t uuid;
+	uuid_clear(uuid);
+
+	json_t *json = json_pack("{ s: s, s: s, s: { s: { s: i, s: s } }, s: { s: i, s: { s: f } } }",
+		"type", "loopback",
+		"name", "node",
+		"in",
+			"signals",
+				"count", 1,
+				"type", "float",
+		"out",
+			"vectorize", VECTORIZE,
+			"adaptive",
+				"latency", latency
+	);
+	cr_assert_not_null(json);
+
+	Node *n = NodeFactory::make(json, uuid);
+	cr_assert_not_null(n);
+
+	int ret = n->check();
+	cr_assert_eq(ret, 0);
+
+	return n;
+}
+
+// cppcheck-suppress unknownMacro
+Test(node_direction, adaptive, .init = init_memory)
+{
+	/* Processing 10 samples takes as long as the latency bound */
+	Node *n = make_node(0.625);
+
+	auto &out = n->out;
+	cr_assert(out.adaptive.enabled);
+
+	out.adaptive.cost = 0;
+	out.adaptive.current = 1;
+
+	cr_assert_eq(out.getBatchSize(), 1);
+
+	/* Full batches double the batch size up to the configured vectorization */
+	unsigned grown[] = { 2, 4, 8, 16, 16 };
+	for (auto expected : grown) {
+		unsigned cnt = out.getBatchSize();
+
+		out.adapt(cnt, cnt, 0);
+		cr_assert_eq(out.getBatchSize(), expected, "Batch size is %u instead of %u", out.getBatchSize(), expected);
+	}
+
+	/* Without backlog, the batch shrinks to the number of available samples */
+	out.adapt(VECTORIZE, 5, 0);
+	cr_assert_eq(out.getBatchSize(), 5);
+
+	out.adapt(5, 0, 0);
+	cr_assert_eq(out.getBatchSize(), 1);
+
+	/* A full batch must not take longer than the latency bound */
+	out.adaptive.current = 8;
+
+	out.adapt(8, 8, 0.5);
+	cr_assert_float_eq(out.adaptive.cost, 0.0625, 1e-9);
+	cr_assert_eq(out.getBatchSize(), 10);
+
+	/* The batch size is fixed without adaptive vectorization */
+	out.adaptive.enabled = 0;
+	cr_assert_eq(out.getBatchSize(), VECTORIZE);
+
+	delete n;
+}
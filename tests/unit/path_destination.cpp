@@ -0,0 +1,684 @@
+/** Unit tests for the credits and overflow policies of path destinations.
+ *
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+#include <vector>
+
+#include <unistd.h>
+
+#include <criterion/criterion.h>
+#include <uuid/uuid.h>
+
+#include <villas/exceptions.hpp>
+#include <villas/node.hpp>
+#include <villas/path.hpp>
+#include <villas/path_destination.hpp>
+#include <villas/pool.hpp>
+#include <villas/sample.hpp>
+
+using namespace villas;
+using namespace villas::node;
+
+extern void init_memory();
+
+#define POOL_SIZE	32
+
+/** Exposes the internals of a destination which are otherwise only used by its path. */
+class TestDestination : public PathDestination {
+
+public:
+	using PathDestination::PathDestination;
+	using PathDestination::enqueue;
+	using PathDestination::flushPending;
+	using PathDestination::dropOldest;
+
+	/** Pull all queued samples like a writer would and return their sequence numbers. */
+	std::vector<uint64_t> drain(unsigned cnt = POOL_SIZE)
+	{
+		std::vector<uint64_t> seqs;
+		struct Sample *smps[cnt];
+
+		int pulled = queue_pull_many(&queue.queue, (void **) smps, cnt);
+		for (int i = 0; i < pulled; i++)
+			seqs.push_back(smps[i]->sequence);
+
+		sample_decref_many(smps, pulled);
+
+		used -= pulled;
+
+		return seqs;
+	}
+
+	struct Sample * getPending() const
+	{
+		return pending;
+	}
+};
+
+static Node * make_node(const char *name, int vectorize = 1)
+{
+	uuid_t uuid;
+	uuid_clear(uuid);
+
+	json_t *json = json_pack("{ s: s, s: s, s: { s: i, s: { s: i, s: s } } }",
+		"type", "loopback",
+		"name", name,
+		"in",
+			"vectorize", vectorize,
+			"signals",
+				"count", 1,
+				"type", "float"
+	);
+	cr_assert_not_null(json);
+
+	Node *n = NodeFactory::make(json, uuid);
+	cr_assert_not_null(n);
+
+	return n;
+}
+
+static void start_node(Node *n)
+{
+	int ret;
+
+	ret = n->check();
+	cr_assert_eq(ret, 0);
+
+	ret = n->prepare();
+	cr_assert_eq(ret, 0);
+
+	ret = n->start();
+	cr_assert_eq(ret, 0);
+}
+
+/** Allocate samples with consecutive sequence numbers starting at \p first. */
+static void alloc(struct Pool *p, struct Sample *smps[], unsigned cnt, uint64_t first)
+{
+	int ret = sample_alloc_many(p, smps, cnt);
+	cr_assert_eq(ret, (int) cnt);
+
+	for (unsigned i = 0; i < cnt; i++) {
+		smps[i]->sequence = first + i;
+		smps[i]->length = 1;
+		smps[i]->data[0].f = first + i;
+		smps[i]->flags = (int) SampleFlags::HAS_SEQUENCE | (int) SampleFlags::HAS_DATA;
+	}
+}
+
+/** Enqueue \p cnt new samples and release the references of the caller like PathDestination::enqueueAll(). */
+static void enqueue(TestDestination &pd, struct Pool *p, unsigned cnt, uint64_t first)
+{
+	struct Sample *smps[cnt];
+
+	alloc(p, smps, cnt, first);
+
+	pd.enqueue(smps, cnt);
+
+	sample_decref_many(smps, cnt);
+}
+
+static void parse(TestDestination &pd, const char *cfg, int queuelen)
+{
+	int ret;
+
+	json_t *json = json_loads(cfg, JSON_DECODE_ANY, nullptr);
+	cr_assert_not_null(json);
+
+	pd.parse(json);
+
+	json_decref(json);
+
+	ret = pd.prepare(queuelen, true);
+	cr_assert_eq(ret, 0);
+}
+
+/** Read \p cnt samples from a loopback node and return their sequence numbers. */
+static std::vector<uint64_t> read_seqs(Node *n, unsigned cnt)
+{
+	std::vector<uint64_t> seqs;
+	struct Sample *smps[cnt];
+
+	for (unsigned i = 0; i < cnt; i++)
+		smps[i] = sample_alloc_mem(1);
+
+	while (seqs.size() < cnt) {
+		int ret = n->read(smps, cnt - seqs.size());
+		cr_assert_geq(ret, 0);
+
+		for (int i = 0; i < ret; i++)
+			seqs.push_back(smps[i]->sequence);
+	}
+
+	sample_free_many(smps, cnt);
+
+	return seqs;
+}
+
+static void assert_seqs(const std::vector<uint64_t> &seqs, const std::vector<uint64_t> &expected)
+{
+	cr_assert_eq(seqs.size(), expected.size(), "Got %zu samples instead of %zu", seqs.size(), expected.size());
+
+	unsigned i = 0;
+	for (auto seq : expected) {
+		cr_assert_eq(seqs[i], seq, "Sample %u has sequence %lu instead of %lu", i, seqs[i], seq);
+		i++;
+	}
+}
+
+// cppcheck-suppress unknownMacro
+Test(path_destination, credits, .init = init_memory)
+{
+	Path path;
+	Node *n = make_node("dst");
+
+	/* Credits default to the queue length */
+	TestDestination pd1(&path, n);
+	parse(pd1, "\"drop_newest\"", 16);
+	cr_assert_eq(pd1.getCredits(), 16);
+
+	TestDestination pd2(&path, n);
+	parse(pd2, "{ \"credits\": 4 }", 16);
+	cr_assert_eq(pd2.getCredits(), 4);
+
+	/* Credits are limited by the queue length */
+	TestDestination pd3(&path, n);
+	parse(pd3, "{ \"credits\": 64 }", 16);
+	cr_assert_eq(pd3.getCredits(), 16);
+
+	TestDestination pd4(&path, n);
+	cr_assert_throw(pd4.parse(json_integer(0)), ConfigError);
+	cr_assert_throw(pd4.parse(json_loads("{ \"credits\": 0 }", 0, nullptr)), ConfigError);
+	cr_assert_throw(pd4.parse(json_loads("{ \"policy\": \"unknown\" }", 0, nullptr)), ConfigError);
+
+	delete n;
+}
+
+Test(path_destination, refill, .init = init_memory)
+{
+	int ret;
+	struct Pool pool;
+	Path path;
+	Node *n = make_node("dst");
+
+	ret = pool_init(&pool, POOL_SIZE, SAMPLE_LENGTH(1), &memory::heap);
+	cr_assert_eq(ret, 0);
+
+	TestDestination pd(&path, n);
+	parse(pd, "{ \"policy\": \"drop_newest\", \"credits\": 3 }", 8);
+
+	/* The credits are exhausted */
+	enqueue(pd, &pool, 4, 0);
+	cr_assert_eq(pd.getUsed(), 3);
+	cr_assert_eq(pool.used, 3);
+
+	/* No credits are left */
+	enqueue(pd, &pool, 1, 4);
+	cr_assert_eq(pd.getUsed(), 3);
+
+	/* Writing samples returns their credits */
+	assert_seqs(pd.drain(2), { 0, 1 });
+	cr_assert_eq(pd.getUsed(), 1);
+	cr_assert_eq(pool.used, 1);
+
+	enqueue(pd, &pool, 2, 5);
+	cr_assert_eq(pd.getUsed(), 3);
+
+	assert_seqs(pd.drain(), { 2, 5, 6 });
+	cr_assert_eq(pd.getUsed(), 0);
+
+	auto &c = pd.getCounters();
+	cr_assert_eq(c.enqueued, 5);
+	cr_assert_eq(c.dropped_newest, 2);
+	cr_assert_eq(c.dropped_oldest, 0);
+
+	pd.stop();
+
+	cr_assert_eq(pool.used, 0);
+
+	ret = pool_destroy(&pool);
+	cr_assert_eq(ret, 0);
+
+	delete n;
+}
+
+Test(path_destination, drop_oldest, .init = init_memory)
+{
+	int ret;
+	struct Pool pool;
+	Path path;
+	Node *n = make_node("dst");
+
+	ret = pool_init(&pool, POOL_SIZE, SAMPLE_LENGTH(1), &memory::heap);
+	cr_assert_eq(ret, 0);
+
+	TestDestination pd(&path, n);
+	parse(pd, "{ \"policy\": \"drop_oldest\", \"credits\": 4 }", 8);
+
+	enqueue(pd, &pool, 3, 0);
+	cr_assert_eq(pd.getUsed(), 3);
+
+	/* The oldest queued samples make room for the new ones */
+	enqueue(pd, &pool, 3, 3);
+	cr_assert_eq(pd.getUsed(), 4);
+	cr_assert_eq(pool.used, 4);
+	cr_assert_eq(pd.getCounters().dropped_oldest, 2);
+
+	/* Samples of a batch which exceeds the credits are dropped right away */
+	enqueue(pd, &pool, 6, 6);
+	cr_assert_eq(pd.getUsed(), 4);
+	cr_assert_eq(pool.used, 4);
+	cr_assert_eq(pd.getCounters().dropped_oldest, 8);
+
+	assert_seqs(pd.drain(), { 8, 9, 10, 11 });
+
+	/* Nothing to drop from an empty queue */
+	cr_assert_eq(pd.dropOldest(4), 0);
+
+	enqueue(pd, &pool, 2, 12);
+	cr_assert_eq(pd.dropOldest(1), 1);
+	cr_assert_eq(pd.getUsed(), 1);
+	cr_assert_eq(pool.used, 1);
+
+	assert_seqs(pd.drain(), { 13 });
+
+	auto &c = pd.getCounters();
+	cr_assert_eq(c.enqueued, 12);
+	cr_assert_eq(c.dropped_newest, 0);
+
+	pd.stop();
+
+	cr_assert_eq(pool.used, 0);
+
+	ret = pool_destroy(&pool);
+	cr_assert_eq(ret, 0);
+
+	delete n;
+}
+
+Test(path_destination, coalesce, .init = init_memory)
+{
+	int ret;
+	struct Pool pool;
+	Path path;
+	Node *n = make_node("dst");
+
+	ret = pool_init(&pool, POOL_SIZE, SAMPLE_LENGTH(1), &memory::heap);
+	cr_assert_eq(ret, 0);
+
+	TestDestination pd(&path, n);
+	parse(pd, "{ \"policy\": \"coalesce\", \"credits\": 2 }", 8);
+
+	enqueue(pd, &pool, 2, 0);
+
+	/* Only the newest sample which does not fit is kept */
+	enqueue(pd, &pool, 3, 2);
+	cr_assert_not_null(pd.getPending());
+	cr_assert_eq(pd.getPending()->sequence, 4);
+	cr_assert_eq(pool.used, 3);
+
+	enqueue(pd, &pool, 1, 5);
+	cr_assert_eq(pd.getPending()->sequence, 5);
+	cr_assert_eq(pool.used, 3);
+
+	/* The pending sample is flushed once a credit is available */
+	pd.flushPending();
+	cr_assert_not_null(pd.getPending());
+
+	assert_seqs(pd.drain(1), { 0 });
+
+	pd.flushPending();
+	cr_assert_null(pd.getPending());
+	cr_assert_eq(pd.getUsed(), 2);
+
+	/* Newer samples do not overtake the pending one */
+	enqueue(pd, &pool, 2, 6);
+	cr_assert_eq(pd.getPending()->sequence, 7);
+
+	assert_seqs(pd.drain(), { 1, 5 });
+
+	/* enqueue() flushes the pending sample before the new ones */
+	enqueue(pd, &pool, 1, 8);
+	cr_assert_null(pd.getPending());
+
+	assert_seqs(pd.drain(), { 7, 8 });
+
+	auto &c = pd.getCounters();
+	cr_assert_eq(c.enqueued, 5);
+	cr_assert_eq(c.coalesced, 4);
+	cr_assert_eq(c.dropped_newest, 0);
+
+	/* A pending sample is released on stop */
+	enqueue(pd, &pool, 3, 9);
+	cr_assert_not_null(pd.getPending());
+
+	pd.drain();
+	pd.stop();
+
+	cr_assert_null(pd.getPending());
+	cr_assert_eq(pool.used, 0);
+
+	ret = pool_destroy(&pool);
+	cr_assert_eq(ret, 0);
+
+	delete n;
+}
+
+Test(path_destination, block, .init = init_memory)
+{
+	int ret;
+	struct Pool pool;
+	Path path;
+	Node *n = make_node("dst");
+
+	ret = pool_init(&pool, POOL_SIZE, SAMPLE_LENGTH(1), &memory::heap);
+	cr_assert_eq(ret, 0);
+
+	start_node(n);
+
+	TestDestination pd(&path, n);
+	parse(pd, "{ \"policy\": \"block\", \"credits\": 2, \"timeout\": 1.0 }", 8);
+
+	enqueue(pd, &pool, 2, 0);
+
+	/* The destination writes its queued samples to the node to make room */
+	enqueue(pd, &pool, 2, 2);
+	cr_assert_eq(pd.getUsed(), 2);
+
+	auto &c = pd.getCounters();
+	cr_assert_eq(c.blocked, 1);
+	cr_assert_eq(c.timeouts, 0);
+	cr_assert_eq(c.enqueued, 4);
+
+	/* The loopback node holds the written samples */
+	struct Sample *smps[2];
+	for (unsigned i = 0; i < 2; i++)
+		smps[i] = sample_alloc_mem(1);
+
+	ret = n->read(smps, 2);
+	cr_assert_eq(ret, 2);
+	cr_assert_eq(smps[0]->sequence, 0);
+	cr_assert_eq(smps[1]->sequence, 1);
+
+	sample_free_many(smps, 2);
+
+	assert_seqs(pd.drain(), { 2, 3 });
+
+	pd.stop();
+
+	cr_assert_eq(pool.used, 0);
+
+	ret = pool_destroy(&pool);
+	cr_assert_eq(ret, 0);
+
+	ret = n->stop();
+	cr_assert_eq(ret, 0);
+
+	delete n;
+}
+
+Test(path_destination, block_timeout, .init = init_memory)
+{
+	int ret;
+	struct Pool pool;
+	Path path;
+	Node *n = make_node("dst");
+
+	ret = pool_init(&pool, POOL_SIZE, SAMPLE_LENGTH(1), &memory::heap);
+	cr_assert_eq(ret, 0);
+
+	TestDestination pd(&path, n);
+
+	json_t *json = json_loads("{ \"policy\": \"block\", \"credits\": 2, \"timeout\": 0.01 }", 0, nullptr);
+	pd.parse(json);
+	json_decref(json);
+
+	/* The writer thread of this pipelined destination is never started */
+	ret = pd.prepare(8, true, true);
+	cr_assert_eq(ret, 0);
+
+	enqueue(pd, &pool, 2, 0);
+
+	/* Blocking is given up after the timeout and the new samples are dropped */
+	enqueue(pd, &pool, 2, 2);
+	cr_assert_eq(pd.getUsed(), 2);
+
+	auto &c = pd.getCounters();
+	cr_assert_eq(c.blocked, 1);
+	cr_assert_eq(c.timeouts, 1);
+	cr_assert_eq(c.dropped_newest, 2);
+
+	assert_seqs(pd.drain(), { 0, 1 });
+
+	cr_assert_eq(pool.used, 0);
+
+	ret = pool_destroy(&pool);
+	cr_assert_eq(ret, 0);
+
+	delete n;
+}
+
+Test(path_destination, pipelined_writer, .init = init_memory, .timeout = 10)
+{
+	int ret;
+	struct Pool pool;
+	Path path;
+	Node *n = make_node("dst");
+
+	/* The loopback node holds the written samples until they are read */
+	ret = pool_init(&pool, 4 * POOL_SIZE, SAMPLE_LENGTH(1), &memory::heap);
+	cr_assert_eq(ret, 0);
+
+	start_node(n);
+
+	TestDestination pd(&path, n);
+
+	json_t *json = json_loads("{ \"policy\": \"block\", \"credits\": 4, \"timeout\": 1.0 }", 0, nullptr);
+	pd.parse(json);
+	json_decref(json);
+
+	ret = pd.prepare(8, true, true);
+	cr_assert_eq(ret, 0);
+
+	pd.start();
+
+	/* The path blocks until the writer thread returns the credits */
+	std::vector<uint64_t> expected;
+	for (unsigned i = 0; i < 2 * POOL_SIZE; i += 2) {
+		enqueue(pd, &pool, 2, i);
+
+		expected.push_back(i);
+		expected.push_back(i + 1);
+	}
+
+	/* The writer thread writes all remaining samples before it exits */
+	pd.stop();
+
+	cr_assert_eq(pd.getUsed(), 0);
+
+	auto &c = pd.getCounters();
+	cr_assert_eq(c.enqueued, 2 * POOL_SIZE);
+	cr_assert_eq(c.timeouts, 0);
+	cr_assert_eq(c.dropped_newest, 0);
+
+	assert_seqs(read_seqs(n, 2 * POOL_SIZE), expected);
+
+	cr_assert_eq(pool.used, 0);
+
+	ret = pool_destroy(&pool);
+	cr_assert_eq(ret, 0);
+
+	ret = n->stop();
+	cr_assert_eq(ret, 0);
+
+	delete n;
+}
+
+Test(path_destination, pipelined_path, .init = init_memory, .timeout = 10)
+{
+	int ret;
+	uuid_t uuid;
+	NodeList nodes;
+
+	uuid_clear(uuid);
+
+	Node *src = make_node("src");
+	Node *dst = make_node("dst");
+
+	nodes.push_back(src);
+	nodes.push_back(dst);
+
+	/* The hook runs on the hook thread and forwards every second sample */
+	json_t *json = json_pack("{ s: s, s: s, s: i, s: b, s: b, s: [ { s: s, s: i } ] }",
+		"in", "src",
+		"out", "dst",
+		"queuelen", 2 * POOL_SIZE,
+		"builtin", false,
+		"pipeline", true,
+		"hooks",
+			"type", "decimate",
+			"ratio", 2
+	);
+	cr_assert_not_null(json);
+
+	auto *path = new Path();
+
+	path->parse(json, nodes, uuid);
+
+	for (auto *n : nodes) {
+		ret = n->check();
+		cr_assert_eq(ret, 0);
+	}
+
+	path->check();
+
+	for (auto *n : nodes) {
+		ret = n->prepare();
+		cr_assert_eq(ret, 0);
+	}
+
+	path->prepare(nodes);
+
+	for (auto *n : nodes) {
+		ret = n->start();
+		cr_assert_eq(ret, 0);
+	}
+
+	path->start();
+
+	struct Sample *smps[POOL_SIZE];
+	for (unsigned i = 0; i < POOL_SIZE; i++) {
+		smps[i] = sample_alloc_mem(1);
+		smps[i]->sequence = i;
+		smps[i]->length = 1;
+		smps[i]->data[0].f = i;
+		smps[i]->flags = (int) SampleFlags::HAS_SEQUENCE | (int) SampleFlags::HAS_DATA;
+	}
+
+	ret = src->write(smps, POOL_SIZE);
+	cr_assert_eq(ret, POOL_SIZE);
+
+	/* The loopback node holds its own references until the path has read the samples */
+	sample_decref_many(smps, POOL_SIZE);
+
+	/* Wait until the path thread has passed all samples to the hook thread */
+	while (path->mux_stage.samples < POOL_SIZE)
+		usleep(1000);
+
+	/* The hook and writer threads process the samples in the pipeline before they exit */
+	path->stop();
+
+	cr_assert_eq(path->hooks_stage.samples, POOL_SIZE);
+
+	std::vector<uint64_t> expected;
+	for (unsigned i = 0; i < POOL_SIZE; i += 2)
+		expected.push_back(i);
+
+	assert_seqs(read_seqs(dst, POOL_SIZE / 2), expected);
+
+	for (auto *n : nodes) {
+		ret = n->stop();
+		cr_assert_eq(ret, 0);
+	}
+
+	delete path;
+
+	for (auto *n : nodes)
+		delete n;
+}
+
+struct pool_param {
+	int queuelen;
+	int vectorize;
+	int credits;
+	bool pipelined;
+	size_t expected;
+};
+
+static void prepare_path(struct pool_param *p)
+{
+	int ret;
+	uuid_t uuid;
+	NodeList nodes;
+
+	uuid_clear(uuid);
+
+	nodes.push_back(make_node("src", p->vectorize));
+	nodes.push_back(make_node("dst1"));
+	nodes.push_back(make_node("dst2"));
+
+	json_t *json = json_pack("{ s: s, s: [ s, s ], s: i, s: { s: i }, s: b }",
+		"in", "src",
+		"out", "dst1", "dst2",
+		"queuelen", p->queuelen,
+		"overflow",
+			"credits", p->credits,
+		"pipeline", p->pipelined
+	);
+	cr_assert_not_null(json);
+
+	auto *path = new Path();
+
+	path->parse(json, nodes, uuid);
+
+	for (auto *n : nodes) {
+		ret = n->check();
+		cr_assert_eq(ret, 0);
+	}
+
+	path->check();
+
+	for (auto *n : nodes) {
+		ret = n->prepare();
+		cr_assert_eq(ret, 0);
+	}
+
+	path->prepare(nodes);
+
+	/* Each destination holds its credits plus one coalesced sample,
+	 * the remainder is reserved for samples in flight */
+	cr_assert_eq(pool_capacity(&path->pool), p->expected);
+
+	delete path;
+
+	for (auto *n : nodes)
+		delete n;
+}
+
+Test(path_destination, pool_size, .init = init_memory)
+{
+	struct pool_param params[] = {
+		/* sum(credits + 1) + MAX(queuelen, 2 * vectorize + 1) */
+		{ 64, 4,  8, false, 2 * (8 + 1) + 64 },
+		{ 16, 64, 8, false, 2 * (8 + 1) + 2 * 64 + 1 },
+		/* Credits are limited by the queue length */
+		{ 16, 1,  32, false, 2 * (16 + 1) + 16 },
+		/* Samples on their way to the hook thread */
+		{ 64, 4,  8, true, 2 * (8 + 1) + 64 + 64 }
+	};
+
+	for (auto &p : params)
+		prepare_path(&p);
+}
@@ -78,3 +78,60 @@ ParameterizedTest(struct param *p, pool, basic, .init = init_memory)
 	ret = pool_destroy(&pool);
 	cr_assert_eq(ret, 0, "Failed to destroy pool");
 }
+
+Test(pool, elastic, .init = init_memory)
+{
+	int ret;
+	struct Pool pool;
+	void *ptrs[40];
+
+	ret = pool_init_elastic(&pool, 8, 32, 64, &memory::heap);
+	cr_assert_eq(ret, 0, "Failed to create pool");
+
+	cr_assert_eq(pool_capacity(&pool), 8);
+
+	/* Getting blocks never allocates memory */
+	ret = pool_get_many(&pool, ptrs, 12);
+	cr_assert_eq(ret, 8);
+	cr_assert_eq(pool_capacity(&pool), 8);
+	cr_assert_geq(pool.underruns, 1);
+
+	/* The pool grows by whole chunks beyond its initial size */
+	pool_maintain(&pool);
+	cr_assert_eq(pool_capacity(&pool), 16);
+	cr_assert_eq(pool.grows, 1);
+
+	ret = pool_get_many(&pool, ptrs + 8, 4);
+	cr_assert_eq(ret, 4);
+
+	/* ..but not beyond its maximum size */
+	int got = 12;
+	for (int i = 0; i < 8; i++) {
+		ret = pool_get_many(&pool, ptrs + got, 40 - got);
+		cr_assert_geq(ret, 0);
+
+		got += ret;
+
+		pool_maintain(&pool);
+	}
+
+	cr_assert_eq(got, 32);
+	cr_assert_eq(pool_capacity(&pool), 32);
+
+	/* Blocks of all chunks are distinct */
+	for (int i = 0; i < 32; i++) {
+		memset(ptrs[i], i, 64);
+
+		for (int j = 0; j < i; j++)
+			cr_assert_neq(ptrs[i], ptrs[j]);
+	}
+
+	ret = pool_put_many(&pool, ptrs, 32);
+	cr_assert_eq(ret, 32);
+
+	cr_assert_eq(pool.used, 0);
+	cr_assert_eq(pool.high_water, 32);
+
+	ret = pool_destroy(&pool);
+	cr_assert_eq(ret, 0, "Failed to destroy pool");
+}
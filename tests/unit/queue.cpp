@@ -11,6 +11,7 @@
 #include <cstdint>
 #include <ctime>
 #include <pthread.h>
+#include <atomic>
 
 #include <criterion/criterion.h>
 #include <criterion/parameterized.h>
@@ -336,3 +337,220 @@ Test(queue, init_destroy, .init = init_memory)
 	ret = queue_destroy(&q);
 	cr_assert_eq(ret, 0); /* Should succeed */
 }
+
+static void * spsc_producer(void *ctx)
+{
+	struct param *p = (struct param *) ctx;
+
+	void *ptrs[p->batch_size];
+
+	for (intptr_t count = 0; count < p->iter_count; ) {
+		int cnt = MIN(p->batch_size, p->iter_count - count);
+
+		for (int i = 0; i < cnt; i++)
+			ptrs[i] = (void *) (count + i);
+
+		int pushed = 0;
+		do {
+			pushed += queue_push_many(&p->queue, &ptrs[pushed], cnt - pushed);
+			if (pushed != cnt)
+				sched_yield(); /* queue full, let the consumer proceed */
+		} while (pushed < cnt);
+
+		count += cnt;
+	}
+
+	return nullptr;
+}
+
+Test(queue, spsc, .timeout = 20, .init = init_memory)
+{
+	int ret;
+	struct param p;
+	pthread_t thread;
+
+	p.iter_count = 1 << 20;
+	p.queue_size = 1 << 8;
+	p.batch_size = 7; /* Not a divisor of the queue size to test wrap-arounds */
+
+	ret = queue_init(&p.queue, p.queue_size, &memory::heap, (int) QueueFlags::SPSC);
+	cr_assert_eq(ret, 0, "Failed to create queue");
+
+	pthread_create(&thread, nullptr, spsc_producer, &p);
+
+	/* The single consumer must observe all pointers in order */
+	for (intptr_t count = 0; count < p.iter_count; ) {
+		void *ptrs[16];
+
+		int pulled = queue_pull_many(&p.queue, ptrs, ARRAY_LEN(ptrs));
+		cr_assert_geq(pulled, 0);
+
+		for (int i = 0; i < pulled; i++, count++)
+			cr_assert_eq((intptr_t) ptrs[i], count);
+
+		if (pulled == 0)
+			sched_yield(); /* queue empty, let the producer proceed */
+	}
+
+	pthread_join(thread, nullptr);
+
+	cr_assert_eq(queue_available(&p.queue), 0);
+
+	ret = queue_destroy(&p.queue);
+	cr_assert_eq(ret, 0, "Failed to destroy queue");
+}
+
+#if defined(_POSIX_BARRIERS) && _POSIX_BARRIERS > 0
+struct contention_param {
+	int thread_count;	/**< Number of producers and number of consumers */
+	int batch_size;
+	int iter_count;		/**< Number of pointers each producer enqueues */
+	struct CQueue queue;
+	std::atomic<int> pulled;
+	std::atomic<int> producers;	/**< Number of started producers. Used to assign distinct values. */
+	std::atomic<int> duplicates;	/**< Number of values which have been dequeued more than once. */
+};
+
+/** Number of times each value has been dequeued. */
+static std::atomic<uint8_t> *contention_seen;
+
+static void * contention_producer(void *ctx)
+{
+	struct contention_param *p = (struct contention_param *) ctx;
+
+	void *ptrs[p->batch_size];
+
+	/* Each producer enqueues its own range of values */
+	intptr_t base = (intptr_t) p->producers++ * p->iter_count;
+
+	pthread_barrier_wait(&barrier);
+
+	for (int count = 0; count < p->iter_count; ) {
+		int cnt = MIN(p->batch_size, p->iter_count - count);
+
+		for (int i = 0; i < cnt; i++)
+			ptrs[i] = (void *) (base + count + i);
+
+		int pushed = 0;
+		do {
+			pushed += queue_push_many(&p->queue, &ptrs[pushed], cnt - pushed);
+			if (pushed != cnt)
+				sched_yield(); /* queue full, let other threads proceed */
+		} while (pushed < cnt);
+
+		count += cnt;
+	}
+
+	return nullptr;
+}
+
+static void * contention_consumer(void *ctx)
+{
+	struct contention_param *p = (struct contention_param *) ctx;
+	int total = p->thread_count * p->iter_count;
+
+	void *ptrs[p->batch_size];
+
+	pthread_barrier_wait(&barrier);
+
+	while (p->pulled < total) {
+		int ret = queue_pull_many(&p->queue, ptrs, p->batch_size);
+		if (ret > 0) {
+			for (int i = 0; i < ret; i++) {
+				if (contention_seen[(intptr_t) ptrs[i]]++ != 0)
+					p->duplicates++;
+			}
+
+			p->pulled += ret;
+		}
+		else
+			sched_yield(); /* queue empty, let other threads proceed */
+	}
+
+	return nullptr;
+}
+
+ParameterizedTestParameters(queue, contention)
+{
+	static const int thread_counts[] = { 1, 2, 4, 8, 16, 32 };
+	static const int batch_sizes[] = { 1, 16, 64, 256 };
+
+	static struct contention_param params[ARRAY_LEN(thread_counts) * ARRAY_LEN(batch_sizes)];
+
+	for (unsigned i = 0; i < ARRAY_LEN(thread_counts); i++) {
+		for (unsigned j = 0; j < ARRAY_LEN(batch_sizes); j++) {
+			auto *p = &params[i * ARRAY_LEN(batch_sizes) + j];
+
+			p->thread_count = thread_counts[i];
+			p->batch_size = batch_sizes[j];
+			p->iter_count = (1 << 18) / thread_counts[i];
+		}
+	}
+
+	return cr_make_param_array(struct contention_param, params, ARRAY_LEN(params));
+}
+
+/** Benchmark the bulk operations of the MPMC queue with N producers and N consumers. */
+ParameterizedTest(struct contention_param *p, queue, contention, .timeout = 60, .init = init_memory)
+{
+	int ret;
+	struct Tsc tsc;
+	uint64_t start, end;
+
+	Logger logger = logging.get("test:queue:contention");
+
+	pthread_t producers[p->thread_count], consumers[p->thread_count];
+
+	ret = queue_init(&p->queue, 1 << 10, &memory::heap);
+	cr_assert_eq(ret, 0, "Failed to create queue");
+
+	p->pulled = 0;
+	p->producers = 0;
+	p->duplicates = 0;
+
+	int total = p->thread_count * p->iter_count;
+
+	contention_seen = new std::atomic<uint8_t>[total];
+	for (int i = 0; i < total; i++)
+		contention_seen[i] = 0;
+
+	ret = tsc_init(&tsc);
+	cr_assert(!ret);
+
+	pthread_barrier_init(&barrier, nullptr, 2 * p->thread_count + 1);
+
+	for (int i = 0; i < p->thread_count; i++) {
+		pthread_create(&producers[i], nullptr, contention_producer, p);
+		pthread_create(&consumers[i], nullptr, contention_consumer, p);
+	}
+
+	pthread_barrier_wait(&barrier);
+	start = tsc_now(&tsc);
+
+	for (int i = 0; i < p->thread_count; i++) {
+		pthread_join(producers[i], nullptr);
+		pthread_join(consumers[i], nullptr);
+	}
+
+	end = tsc_now(&tsc);
+
+	cr_assert_eq(p->pulled, total);
+	cr_assert_eq(queue_available(&p->queue), 0);
+
+	/* Every value has been dequeued exactly once */
+	cr_assert_eq(p->duplicates, 0, "%d values have been dequeued more than once", (int) p->duplicates);
+	for (int i = 0; i < total; i++)
+		cr_assert_eq(contention_seen[i], 1, "Value %d has been dequeued %d times", i, (int) contention_seen[i]);
+
+	delete[] contention_seen;
+
+	logger->info("producers=consumers={}, batch_size={}: {} cycles/op", p->thread_count, p->batch_size,
+		(end - start) / (p->thread_count * p->iter_count));
+
+	ret = queue_destroy(&p->queue);
+	cr_assert_eq(ret, 0, "Failed to destroy queue");
+
+	ret = pthread_barrier_destroy(&barrier);
+	cr_assert_eq(ret, 0, "Failed to destroy barrier");
+}
+#endif /* _POSIX_BARRIERS */
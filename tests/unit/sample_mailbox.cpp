@@ -0,0 +1,113 @@
+/** Unit tests for the latest-value mailbox.
+ *
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+#include <thread>
+
+#include <criterion/criterion.h>
+
+#include <villas/sample.hpp>
+#include <villas/sample_mailbox.hpp>
+
+using namespace villas::node;
+
+extern void init_memory();
+
+#define NUM_SIGNALS	16
+#define NUM_UPDATES	100000
+
+// cppcheck-suppress unknownMacro
+Test(sample_mailbox, changes, .init = init_memory)
+{
+	auto signals = std::make_shared<SignalList>(NUM_SIGNALS, SignalType::FLOAT);
+	SampleMailbox mb(signals);
+
+	struct Sample *smp = sample_alloc_mem(NUM_SIGNALS);
+	cr_assert_not_null(smp);
+
+	for (unsigned i = 0; i < NUM_SIGNALS; i++)
+		smp->data[i].f = i;
+
+	smp->length = NUM_SIGNALS;
+	smp->flags = (int) SampleFlags::HAS_DATA;
+
+	mb.put(smp);
+
+	uint64_t seq = mb.getSequence();
+	cr_assert_gt(seq, 0);
+
+	/* Only values which differ count as changed */
+	smp->data[3].f = 42;
+	mb.put(smp);
+
+	std::vector<SampleMailbox::Value> values;
+	uint64_t seq2 = mb.getChanged(seq, values, nullptr);
+
+	cr_assert_gt(seq2, seq);
+	cr_assert_eq(values.size(), 1);
+	cr_assert_eq(values[0].index, 3);
+	cr_assert_float_eq(values[0].data.f, 42, 1e-9);
+
+	/* Nothing changed since */
+	mb.getChanged(seq2, values, nullptr);
+	cr_assert_eq(values.size(), 0);
+
+	/* Several values are published at once */
+	SampleMailbox::Value v1, v2;
+	v1.index = 1;
+	v1.data.f = -1;
+	v2.index = 5;
+	v2.data.f = -5;
+
+	mb.put({ v1, v2 }, nullptr);
+
+	mb.getChanged(seq2, values, nullptr);
+	cr_assert_eq(values.size(), 2);
+
+	union SignalData d;
+	mb.get(5, &d, nullptr);
+	cr_assert_float_eq(d.f, -5, 1e-9);
+
+	mb.getAll(values, nullptr);
+	cr_assert_eq(values.size(), NUM_SIGNALS);
+
+	sample_free(smp);
+}
+
+/* Readers must never see a partial update */
+Test(sample_mailbox, consistency, .init = init_memory)
+{
+	auto signals = std::make_shared<SignalList>(NUM_SIGNALS, SignalType::INTEGER);
+	SampleMailbox mb(signals);
+
+	std::thread writer([&]() {
+		std::vector<SampleMailbox::Value> values(NUM_SIGNALS);
+
+		for (int64_t j = 1; j <= NUM_UPDATES; j++) {
+			for (unsigned i = 0; i < NUM_SIGNALS; i++) {
+				values[i].index = i;
+				values[i].data.i = j;
+			}
+
+			mb.put(values, nullptr);
+		}
+	});
+
+	std::vector<SampleMailbox::Value> values;
+	int64_t last = 0;
+
+	while (last < NUM_UPDATES) {
+		mb.getAll(values, nullptr);
+
+		for (auto &v : values)
+			cr_assert_eq(v.data.i, values[0].data.i);
+
+		cr_assert_geq(values[0].data.i, last);
+		last = values[0].data.i;
+	}
+
+	writer.join();
+}
@@ -0,0 +1,314 @@
+/** Unit tests for the shared memory broadcast ring.
+ *
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+#include <thread>
+
+#include <criterion/criterion.h>
+
+#include <villas/sample.hpp>
+#include <villas/shmem.hpp>
+
+using namespace villas::node;
+
+extern void init_memory();
+
+#define NAME		"/villas-test-bcast"
+#define SLOTS		16
+#define SAMPLELEN	4
+
+static struct Sample * make_sample(uint64_t seq)
+{
+	struct Sample *smp = sample_alloc_mem(SAMPLELEN);
+
+	smp->sequence = seq;
+	smp->length = SAMPLELEN;
+	smp->flags = (int) SampleFlags::HAS_SEQUENCE | (int) SampleFlags::HAS_DATA;
+
+	for (unsigned i = 0; i < SAMPLELEN; i++)
+		smp->data[i].f = seq * 10.0 + i;
+
+	return smp;
+}
+
+static int publish(struct ShmemBroadcast *w, uint64_t first, unsigned cnt)
+{
+	struct Sample *smps[cnt];
+
+	for (unsigned i = 0; i < cnt; i++)
+		smps[i] = make_sample(first + i);
+
+	int ret = shmem_bcast_write(w, smps, cnt);
+
+	sample_free_many(smps, cnt);
+
+	return ret;
+}
+
+// cppcheck-suppress unknownMacro
+Test(shmem, broadcast_readers, .init = init_memory)
+{
+	int ret;
+	struct ShmemBroadcast w, r1, r2;
+	struct ShmemBroadcast *readers[] = { &r1, &r2 };
+	struct Sample *smps[SLOTS];
+
+	ret = shmem_bcast_create(NAME, &w, SLOTS, SAMPLELEN);
+	cr_assert_eq(ret, 0);
+
+	ret = shmem_bcast_attach(NAME, &r1);
+	cr_assert_eq(ret, 0);
+
+	ret = shmem_bcast_attach(NAME, &r2);
+	cr_assert_eq(ret, 0);
+
+	for (unsigned i = 0; i < SLOTS; i++)
+		smps[i] = sample_alloc_mem(SAMPLELEN);
+
+	ret = shmem_bcast_read(&r1, smps, SLOTS);
+	cr_assert_eq(ret, 0);
+
+	ret = publish(&w, 0, 8);
+	cr_assert_eq(ret, 8);
+
+	/* Both readers see all samples independently */
+	for (auto *r : readers) {
+		ret = shmem_bcast_read(r, smps, 5);
+		cr_assert_eq(ret, 5);
+
+		ret = shmem_bcast_read(r, smps + 5, SLOTS);
+		cr_assert_eq(ret, 3);
+
+		for (unsigned i = 0; i < 8; i++) {
+			cr_assert_eq(smps[i]->sequence, i);
+			cr_assert_eq(smps[i]->length, SAMPLELEN);
+			cr_assert_float_eq(smps[i]->data[3].f, i * 10.0 + 3, 1e-9);
+		}
+
+		cr_assert_eq(r->overruns, 0);
+	}
+
+	ret = shmem_bcast_close(&w);
+	cr_assert_eq(ret, 0);
+
+	/* All samples have been consumed */
+	ret = shmem_bcast_read(&r1, smps, SLOTS);
+	cr_assert_eq(ret, -1);
+
+	sample_free_many(smps, SLOTS);
+
+	ret = shmem_bcast_close(&r1);
+	cr_assert_eq(ret, 0);
+
+	ret = shmem_bcast_close(&r2);
+	cr_assert_eq(ret, 0);
+}
+
+Test(shmem, broadcast_overrun, .init = init_memory)
+{
+	int ret;
+	struct ShmemBroadcast w, r;
+	struct Sample *smps[SLOTS];
+
+	ret = shmem_bcast_create(NAME, &w, SLOTS, SAMPLELEN);
+	cr_assert_eq(ret, 0);
+
+	ret = shmem_bcast_attach(NAME, &r);
+	cr_assert_eq(ret, 0);
+
+	/* The writer laps the reader */
+	ret = publish(&w, 0, 3 * SLOTS + 5);
+	cr_assert_eq(ret, 3 * SLOTS + 5);
+
+	for (unsigned i = 0; i < SLOTS; i++)
+		smps[i] = sample_alloc_mem(SAMPLELEN);
+
+	ret = shmem_bcast_read(&r, smps, SLOTS);
+	cr_assert_eq(ret, SLOTS);
+	cr_assert_eq(r.overruns, 2 * SLOTS + 5);
+
+	/* The reader continues with the oldest sample in the ring */
+	for (unsigned i = 0; i < SLOTS; i++)
+		cr_assert_eq(smps[i]->sequence, 2 * SLOTS + 5 + i);
+
+	sample_free_many(smps, SLOTS);
+
+	ret = shmem_bcast_close(&r);
+	cr_assert_eq(ret, 0);
+
+	ret = shmem_bcast_close(&w);
+	cr_assert_eq(ret, 0);
+}
+
+Test(shmem, broadcast_latest, .init = init_memory)
+{
+	int ret;
+	struct ShmemBroadcast w, r;
+	struct Sample *smp = sample_alloc_mem(SAMPLELEN);
+
+	ret = shmem_bcast_create(NAME, &w, SLOTS, SAMPLELEN);
+	cr_assert_eq(ret, 0);
+
+	ret = shmem_bcast_attach(NAME, &r);
+	cr_assert_eq(ret, 0);
+
+	ret = shmem_bcast_latest(&r, smp);
+	cr_assert_eq(ret, 0);
+
+	publish(&w, 0, 10);
+
+	ret = shmem_bcast_latest(&r, smp);
+	cr_assert_eq(ret, 1);
+	cr_assert_eq(smp->sequence, 9);
+
+	/* No new sample since the last call */
+	ret = shmem_bcast_latest(&r, smp);
+	cr_assert_eq(ret, 0);
+
+	publish(&w, 10, 1);
+
+	ret = shmem_bcast_latest(&r, smp);
+	cr_assert_eq(ret, 1);
+	cr_assert_eq(smp->sequence, 10);
+
+	sample_free(smp);
+
+	ret = shmem_bcast_close(&w);
+	cr_assert_eq(ret, 0);
+
+	ret = shmem_bcast_close(&r);
+	cr_assert_eq(ret, 0);
+}
+
+Test(shmem, broadcast_concurrent, .init = init_memory, .timeout = 20)
+{
+	int ret;
+	struct ShmemBroadcast w, r;
+	const uint64_t total = 1 << 18;
+
+	ret = shmem_bcast_create(NAME, &w, SLOTS, SAMPLELEN);
+	cr_assert_eq(ret, 0);
+
+	ret = shmem_bcast_attach(NAME, &r, true);
+	cr_assert_eq(ret, 0);
+
+	std::thread writer([&w, total]() {
+		for (uint64_t seq = 0; seq < total; seq += 4)
+			publish(&w, seq, 4);
+	});
+
+	struct Sample *smps[SLOTS];
+	for (unsigned i = 0; i < SLOTS; i++)
+		smps[i] = sample_alloc_mem(SAMPLELEN);
+
+	/* Every sample which is returned must be consistent and in order */
+	uint64_t received = 0, last = 0;
+	bool first = true;
+	while (received + r.overruns < total) {
+		ret = shmem_bcast_read(&r, smps, SLOTS);
+		cr_assert_geq(ret, 0);
+
+		for (int i = 0; i < ret; i++) {
+			if (!first)
+				cr_assert_gt(smps[i]->sequence, last);
+
+			for (unsigned j = 0; j < SAMPLELEN; j++)
+				cr_assert_float_eq(smps[i]->data[j].f, smps[i]->sequence * 10.0 + j, 1e-9);
+
+			last = smps[i]->sequence;
+			first = false;
+		}
+
+		received += ret;
+	}
+
+	writer.join();
+
+	cr_assert_eq(received + r.overruns, total);
+
+	sample_free_many(smps, SLOTS);
+
+	ret = shmem_bcast_close(&w);
+	cr_assert_eq(ret, 0);
+
+	ret = shmem_bcast_close(&r);
+	cr_assert_eq(ret, 0);
+}
+
+Test(shmem, broadcast_wait, .init = init_memory, .timeout = 10)
+{
+	int ret;
+	struct ShmemBroadcast w, r;
+	struct Sample *smps[SLOTS];
+
+	ret = shmem_bcast_create(NAME, &w, SLOTS, SAMPLELEN);
+	cr_assert_eq(ret, 0);
+
+	ret = shmem_bcast_attach(NAME, &r);
+	cr_assert_eq(ret, 0);
+
+	for (unsigned i = 0; i < SLOTS; i++)
+		smps[i] = sample_alloc_mem(SAMPLELEN);
+
+	/* The timeout expires if nothing is published */
+	const struct timespec timeout = { 0, 10000000 };
+
+	ret = shmem_bcast_read(&r, smps, SLOTS);
+	cr_assert_eq(ret, 0);
+
+	ret = shmem_bcast_wait(&r, &timeout);
+	cr_assert_eq(ret, 0);
+
+	/* Samples which have been published after the last read do not block */
+	publish(&w, 0, 1);
+
+	ret = shmem_bcast_wait(&r);
+	cr_assert_eq(ret, 0);
+
+	ret = shmem_bcast_read(&r, smps, SLOTS);
+	cr_assert_eq(ret, 1);
+
+	/* The reader is woken up by the writer */
+	std::thread writer([&w]() {
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+		publish(&w, 1, 2);
+	});
+
+	ret = shmem_bcast_read(&r, smps, SLOTS);
+	cr_assert_eq(ret, 0);
+
+	ret = shmem_bcast_wait(&r);
+	cr_assert_eq(ret, 0);
+
+	ret = shmem_bcast_read(&r, smps, SLOTS);
+	cr_assert_eq(ret, 2);
+
+	writer.join();
+
+	/* Closing the ring also wakes up the reader */
+	std::thread closer([&w]() {
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+		shmem_bcast_close(&w);
+	});
+
+	ret = shmem_bcast_read(&r, smps, SLOTS);
+	cr_assert_eq(ret, 0);
+
+	ret = shmem_bcast_wait(&r);
+	cr_assert_eq(ret, 0);
+
+	ret = shmem_bcast_read(&r, smps, SLOTS);
+	cr_assert_eq(ret, -1);
+
+	closer.join();
+
+	sample_free_many(smps, SLOTS);
+
+	ret = shmem_bcast_close(&r);
+	cr_assert_eq(ret, 0);
+}
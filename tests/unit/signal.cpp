@@ -8,6 +8,7 @@
 #include <criterion/criterion.h>
 
 #include <villas/signal.hpp>
+#include <villas/signal_list.hpp>
 
 using namespace villas::node;
 
@@ -72,3 +73,46 @@ Test(signal_data, parse, .init = init_memory) {
 	cr_assert_float_eq(std::real(sd.z), 0, 1e-6);
 	cr_assert_float_eq(std::imag(sd.z), -3, 1e-6);
 }
+
+Test(signal_list, lookup_by_name)
+{
+	auto signals = std::make_shared<SignalList>(4, SignalType::FLOAT);
+
+	cr_assert_eq(signals->getIndexByName("signal0"), 0);
+	cr_assert_eq(signals->getIndexByName("signal3"), 3);
+	cr_assert_eq(signals->getIndexByName("missing"), -1);
+	cr_assert_null(signals->getByName("missing"));
+
+	/* Clones share the index until they are modified */
+	auto clone = signals->clone();
+
+	clone->insert(clone->begin(), std::make_shared<Signal>("first", "", SignalType::FLOAT));
+
+	cr_assert_eq(clone->getIndexByName("first"), 0);
+	cr_assert_eq(clone->getIndexByName("signal0"), 1);
+	cr_assert_eq(signals->getIndexByName("signal0"), 0);
+
+	/* Stale entries of the index are detected */
+	(*clone)[1] = std::make_shared<Signal>("renamed", "", SignalType::FLOAT);
+	(*clone)[2] = std::make_shared<Signal>("signal0", "", SignalType::FLOAT);
+
+	cr_assert_eq(clone->getIndexByName("signal0"), 2);
+	cr_assert_eq(clone->getByName("signal0"), (*clone)[2]);
+
+	(*clone)[3] = std::make_shared<Signal>("replaced", "", SignalType::FLOAT);
+	clone->invalidateIndex();
+
+	cr_assert_eq(clone->getIndexByName("replaced"), 3);
+	cr_assert_eq(clone->getIndexByName("signal2"), -1);
+
+	/* Signals which have been renamed in place are found without invalidating the index */
+	(*clone)[3]->name = "renamed_in_place";
+
+	cr_assert_eq(clone->getIndexByName("renamed_in_place"), 3);
+	cr_assert_eq(clone->getIndexByName("replaced"), -1);
+
+	/* The first of several signals with the same name wins */
+	clone->push_back(std::make_shared<Signal>("first", "", SignalType::FLOAT));
+
+	cr_assert_eq(clone->getIndexByName("first"), 0);
+}
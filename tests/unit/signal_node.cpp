@@ -0,0 +1,130 @@
+/** Unit tests for the signal generator node-type.
+ *
+ * @author Steffen Vogel <post@steffenvogel.de>
+ * @copyright 2014-2022, Institute for Automation of Complex Power Systems, EONERC
+ * @license Apache 2.0
+ *********************************************************************************/
+
+#include <criterion/criterion.h>
+#include <uuid/uuid.h>
+
+#include <villas/node.hpp>
+#include <villas/sample.hpp>
+#include <villas/timing.hpp>
+
+using namespace villas;
+using namespace villas::node;
+
+extern void init_memory();
+
+#define NUM_SAMPLES	256
+#define NUM_SIGNALS	8
+#define VECTORIZE	8
+
+/* One signal of each type. The parameters are chosen so that no sample falls
+ * exactly onto a discontinuity where rounding errors would flip the result. */
+static const char *signals = R"([
+	{ "signal": "sine", "frequency": 3.7, "amplitude": 2.0, "offset": 1.0, "phase": 0.3 },
+	{ "signal": "square", "frequency": 3.7, "amplitude": 2.0, "offset": 1.0, "phase": 0.3 },
+	{ "signal": "triangle", "frequency": 3.7, "amplitude": 2.0, "offset": 1.0, "phase": 0.3 },
+	{ "signal": "ramp", "frequency": 0.0437, "amplitude": 2.0, "offset": 1.0 },
+	{ "signal": "counter", "amplitude": 2.0, "offset": 1.0 },
+	{ "signal": "constant", "amplitude": 2.0, "offset": 1.0 },
+	{ "signal": "pulse", "frequency": 3.7, "pulse_width": 123, "pulse_low": -1.0, "pulse_high": 3.0, "offset": 1.0 },
+	{ "signal": "random", "stddev": 0.0, "offset": 1.0 }
+])";
+
+static Node * make_node(const char *name, bool batch)
+{
+	int ret;
+	uuid_t uuid;
+	uuid_clear(uuid);
+
+	json_t *json_signals = json_loads(signals, 0, nullptr);
+	cr_assert_not_null(json_signals);
+
+	json_t *json = json_pack("{ s: s, s: s, s: b, s: b, s: f, s: i, s: { s: i, s: b, s: o } }",
+		"type", "signal.v2",
+		"name", name,
+		"realtime", 0,
+		"batch", batch,
+		"rate", 1000.0,
+		"limit", NUM_SAMPLES * 2,
+		"in",
+			"vectorize", VECTORIZE,
+			"builtin", 0,
+			"signals", json_signals
+	);
+	cr_assert_not_null(json);
+
+	Node *n = NodeFactory::make(json, uuid);
+	cr_assert_not_null(n);
+
+	ret = n->check();
+	cr_assert_eq(ret, 0);
+
+	ret = n->prepare();
+	cr_assert_eq(ret, 0);
+
+	ret = n->start();
+	cr_assert_eq(ret, 0);
+
+	return n;
+}
+
+// cppcheck-suppress unknownMacro
+Test(signal_node, batch, .init = init_memory)
+{
+	int ret;
+	struct Sample *single[NUM_SAMPLES], *batched[NUM_SAMPLES];
+
+	for (unsigned i = 0; i < NUM_SAMPLES; i++) {
+		single[i] = sample_alloc_mem(NUM_SIGNALS);
+		batched[i] = sample_alloc_mem(NUM_SIGNALS);
+	}
+
+	Node *n1 = make_node("single", false);
+	Node *n2 = make_node("batched", true);
+
+	/* Without batch mode, the node generates a single sample per call */
+	for (unsigned i = 0; i < NUM_SAMPLES; i++) {
+		ret = n1->read(&single[i], 1);
+		cr_assert_eq(ret, 1);
+	}
+
+	for (unsigned i = 0; i < NUM_SAMPLES; i += VECTORIZE) {
+		ret = n2->read(&batched[i], VECTORIZE);
+		cr_assert_eq(ret, VECTORIZE);
+	}
+
+	for (unsigned i = 0; i < NUM_SAMPLES; i++) {
+		auto *s = single[i];
+		auto *b = batched[i];
+
+		cr_assert_eq(b->sequence, s->sequence, "Sample %u has sequence %lu instead of %lu", i, b->sequence, s->sequence);
+		cr_assert_eq(b->length, s->length);
+		cr_assert_eq(b->flags, s->flags);
+
+		/* Both nodes have been started at slightly different times */
+		double ts_single = time_delta(&single[0]->ts.origin, &s->ts.origin);
+		double ts_batched = time_delta(&batched[0]->ts.origin, &b->ts.origin);
+
+		cr_assert_float_eq(ts_batched, ts_single, 5e-9, "Sample %u has origin timestamp %f instead of %f", i, ts_batched, ts_single);
+
+		/* The per-sample path derives the time from nanosecond timestamps */
+		for (unsigned j = 0; j < s->length; j++)
+			cr_assert_float_eq(b->data[j].f, s->data[j].f, 1e-6, "Signal %u of sample %u has value %f instead of %f", j, i, b->data[j].f, s->data[j].f);
+	}
+
+	ret = n1->stop();
+	cr_assert_eq(ret, 0);
+
+	ret = n2->stop();
+	cr_assert_eq(ret, 0);
+
+	sample_free_many(single, NUM_SAMPLES);
+	sample_free_many(batched, NUM_SAMPLES);
+
+	delete n1;
+	delete n2;
+}